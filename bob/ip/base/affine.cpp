@@ -19,6 +19,10 @@ bob::extension::FunctionDoc s_scale = bob::extension::FunctionDoc(
   "1. Given a source image and a scale factor, the scaled image is returned in the size :py:func:`bob.ip.base.scaled_output_shape`\n\n"
   "2. Given source and destination image, the source image is scaled such that it fits into the destination image.\n\n"
   "3. Same as 2., but additionally boolean masks will be read and filled with according values.\n\n"
+  "For 1. and 2., the keyword argument ``area=True`` selects area averaging instead of bi-linear interpolation: "
+  "each output pixel is the mean of the source image over the exact (fractional) region that it covers. "
+  "The region sums are computed in constant time from the integral image (see :py:func:`bob.ip.base.integral`), so that the costs do not depend on the scaling factor. "
+  "This is the preferred way of down-scaling images by large factors, since it does not alias and does not require smoothing the image beforehand.\n\n"
   ".. note::\n\n  For 2. and 3., scale factors are computed for both directions independently. "
   "Factually, this means that the image **might be** stretched in either direction, i.e., the aspect ratio is **not** identical for the horizontal and vertical direction. "
   "Even for 1. this might apply, e.g., when ``src.shape * scaling_factor`` does not result in integral values."
@@ -26,20 +30,35 @@ bob::extension::FunctionDoc s_scale = bob::extension::FunctionDoc(
 .add_prototype("src, scaling_factor", "dst")
 .add_prototype("src, dst")
 .add_prototype("src, src_mask, dst, dst_mask")
+.add_prototype("src, scaling_factor, [area]", "dst")
+.add_prototype("src, dst, [area]")
 .add_parameter("src", "array_like (2D or 3D)", "The input image (gray or colored) that should be scaled")
-.add_parameter("dst", "array_like (2D or 3D, float)", "The resulting scaled gray or color image")
+.add_parameter("dst", "array_like (2D or 3D, float or same type as ``src``)", "The resulting scaled gray or color image; can be of type numpy.float64, numpy.float32 or of the same type as ``src``, in which case the values are rounded")
 .add_parameter("src_mask", "array_like (bool, 2D or 3D)", "An input mask of valid pixels before geometric normalization, must be of same size as ``src``")
 .add_parameter("dst_mask", "array_like (bool, 2D or 3D)", "The output mask of valid pixels after geometric normalization, must be of same size as ``dst``")
 .add_parameter("scaling_factor", "float", "the scaling factor that should be applied to the image; can be negative, but cannot be ``0.``")
+.add_parameter("area", "bool", "Use area averaging instead of bi-linear interpolation, if ``True``; can only be given as keyword argument")
 .add_return("dst", "array_like (2D, float)", "The resulting scaled image")
 ;
 
-template <typename T, int D>
-static void scale_inner(PyBlitzArrayObject* input, PyBlitzArrayObject* input_mask, PyBlitzArrayObject* output, PyBlitzArrayObject* output_mask) {
-  if (input_mask && output_mask){
-    bob::ip::base::scale<T>(*PyBlitzArrayCxx_AsBlitz<T,D>(input), *PyBlitzArrayCxx_AsBlitz<bool,D>(input_mask), *PyBlitzArrayCxx_AsBlitz<double,D>(output), *PyBlitzArrayCxx_AsBlitz<bool,D>(output_mask));
+template <typename T, typename U, int D>
+static void scale_inner(PyBlitzArrayObject* input, PyBlitzArrayObject* input_mask, PyBlitzArrayObject* output, PyBlitzArrayObject* output_mask, bool area) {
+  if (area){
+    bob::ip::base::scaleArea<T,U>(*PyBlitzArrayCxx_AsBlitz<T,D>(input), *PyBlitzArrayCxx_AsBlitz<U,D>(output));
+  } else if (input_mask && output_mask){
+    bob::ip::base::scale<T,U>(*PyBlitzArrayCxx_AsBlitz<T,D>(input), *PyBlitzArrayCxx_AsBlitz<bool,D>(input_mask), *PyBlitzArrayCxx_AsBlitz<U,D>(output), *PyBlitzArrayCxx_AsBlitz<bool,D>(output_mask));
   } else {
-    bob::ip::base::scale<T>(*PyBlitzArrayCxx_AsBlitz<T,D>(input), *PyBlitzArrayCxx_AsBlitz<double,D>(output));
+    bob::ip::base::scale<T,U>(*PyBlitzArrayCxx_AsBlitz<T,D>(input), *PyBlitzArrayCxx_AsBlitz<U,D>(output));
+  }
+}
+
+template <typename T>
+static void scale_typed(PyBlitzArrayObject* input, PyBlitzArrayObject* input_mask, PyBlitzArrayObject* output, PyBlitzArrayObject* output_mask, bool area) {
+  switch (output->type_num){
+    case NPY_FLOAT64: if (input->ndim == 2) scale_inner<T,double,2>(input, input_mask, output, output_mask, area); else scale_inner<T,double,3>(input, input_mask, output, output_mask, area); break;
+    case NPY_FLOAT32: if (input->ndim == 2) scale_inner<T,float,2>(input, input_mask, output, output_mask, area);  else scale_inner<T,float,3>(input, input_mask, output, output_mask, area); break;
+    // otherwise, the output is of the same type as the input
+    default:          if (input->ndim == 2) scale_inner<T,T,2>(input, input_mask, output, output_mask, area);      else scale_inner<T,T,3>(input, input_mask, output, output_mask, area);
   }
 }
 
@@ -50,12 +69,29 @@ PyObject* PyBobIpBase_scale(PyObject*, PyObject* args, PyObject* kwargs) {
   char** kwlist2 = s_scale.kwlist(1);
   char** kwlist3 = s_scale.kwlist(2);
 
+  // the area averaging can only be selected by keyword; remove it from a copy of the keyword arguments
+  bool area = false;
+  boost::shared_ptr<PyObject> kwargs_;
+  PyObject* area_object = kwargs ? PyDict_GetItemString(kwargs, "area") : 0;
+  if (area_object){
+    int a = PyObject_IsTrue(area_object);
+    if (a < 0) return 0;
+    area = a;
+    kwargs = PyDict_Copy(kwargs);
+    kwargs_ = make_safe(kwargs);
+    if (PyDict_DelItemString(kwargs, "area") < 0) return 0;
+  }
+
   // get the number of command line arguments
   Py_ssize_t nargs = (args?PyTuple_Size(args):0) + (kwargs?PyDict_Size(kwargs):0);
 
   PyBlitzArrayObject* src,* src_mask = 0,* dst = 0,* dst_mask = 0;
   double scale_factor = 0;
   if (nargs == 4){
+    if (area){
+      PyErr_Format(PyExc_ValueError, "scale: area averaging is not supported in combination with masks");
+      return 0;
+    }
     // with masks
     if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&O&O&O&", kwlist3, &PyBlitzArray_Converter, &src, &PyBlitzArray_Converter, &src_mask, &PyBlitzArray_OutputConverter, &dst, &PyBlitzArray_OutputConverter, &dst_mask)) return 0;
   }
@@ -93,8 +129,8 @@ PyObject* PyBobIpBase_scale(PyObject*, PyObject* args, PyObject* kwargs) {
       PyErr_Format(PyExc_TypeError, "scale: the src and dst array must have the same number of dimensions");
       return 0;
     }
-    if (dst->type_num != NPY_FLOAT64){
-      PyErr_Format(PyExc_TypeError, "scale: the dst array must be of type float64");
+    if (dst->type_num != NPY_FLOAT64 && dst->type_num != NPY_FLOAT32 && dst->type_num != src->type_num){
+      PyErr_Format(PyExc_TypeError, "scale: the dst array must be of type float64, float32 or of the same type as the src array");
       return 0;
     }
   } else {
@@ -127,9 +163,9 @@ PyObject* PyBobIpBase_scale(PyObject*, PyObject* args, PyObject* kwargs) {
   }
 
   switch (src->type_num){
-    case NPY_UINT8:   if (src->ndim == 2) scale_inner<uint8_t,2>(src, src_mask, dst, dst_mask);  else scale_inner<uint8_t,3>(src, src_mask, dst, dst_mask); break;
-    case NPY_UINT16:  if (src->ndim == 2) scale_inner<uint16_t,2>(src, src_mask, dst, dst_mask); else scale_inner<uint16_t,3>(src, src_mask, dst, dst_mask); break;
-    case NPY_FLOAT64: if (src->ndim == 2) scale_inner<double,2>(src, src_mask, dst, dst_mask);   else scale_inner<double,3>(src, src_mask, dst, dst_mask); break;
+    case NPY_UINT8:   scale_typed<uint8_t>(src, src_mask, dst, dst_mask, area); break;
+    case NPY_UINT16:  scale_typed<uint16_t>(src, src_mask, dst, dst_mask, area); break;
+    case NPY_FLOAT64: scale_typed<double>(src, src_mask, dst, dst_mask, area); break;
     default:
       PyErr_Format(PyExc_TypeError, "scale: src arrays of type %s are currently not supported", PyBlitzArray_TypenumAsString(src->type_num));
       return 0;
@@ -200,25 +236,37 @@ bob::extension::FunctionDoc s_rotate = bob::extension::FunctionDoc(
   "1. Given a source image and a rotation angle, the rotated image is returned in the size :py:func:`bob.ip.base.rotated_output_shape`\n\n"
   "2. Given source and destination image and the rotation angle, the source image is rotated and filled into the destination image.\n\n"
   "3. Same as 2., but additionally boolean masks will be read and filled with according values.\n\n"
+  "Rotations by multiples of 90 degrees are exact permutations of the pixels, which are computed without interpolation. "
+  "In this case, the mask is rotated in the same way, and the returned image in version 1. has the same data type as ``src``.\n\n"
   ".. note::\n\n  Since the implementation uses a different interpolation style than before, results might *slightly* differ."
 )
 .add_prototype("src, rotation_angle", "dst")
 .add_prototype("src, dst, rotation_angle")
 .add_prototype("src, src_mask, dst, dst_mask, rotation_angle")
 .add_parameter("src", "array_like (2D or 3D)", "The input image (gray or colored) that should be rotated")
-.add_parameter("dst", "array_like (2D or 3D, float)", "The resulting scaled gray or color image, should be in size :py:func:`bob.ip.base.rotated_output_shape`")
+.add_parameter("dst", "array_like (2D or 3D, float or same type as ``src``)", "The resulting scaled gray or color image, should be in size :py:func:`bob.ip.base.rotated_output_shape`; can be of type numpy.float64, numpy.float32 or of the same type as ``src``, in which case the values are rounded")
 .add_parameter("src_mask", "array_like (bool, 2D or 3D)", "An input mask of valid pixels before geometric normalization, must be of same size as ``src``")
 .add_parameter("dst_mask", "array_like (bool, 2D or 3D)", "The output mask of valid pixels after geometric normalization, must be of same size as ``dst``")
 .add_parameter("rotation_angle", "float", "the rotation angle that should be applied to the image")
-.add_return("dst", "array_like (2D, float)", "The resulting rotated image")
+.add_return("dst", "array_like (2D or 3D)", "The resulting rotated image, of type numpy.float64, or of the same type as ``src`` for multiples of 90 degrees")
 ;
 
-template <typename T, int D>
+template <typename T, typename U, int D>
 static void rotate_inner(PyBlitzArrayObject* input, PyBlitzArrayObject* input_mask, PyBlitzArrayObject* output, PyBlitzArrayObject* output_mask, double angle) {
   if (input_mask && output_mask){
-    bob::ip::base::rotate<T>(*PyBlitzArrayCxx_AsBlitz<T,D>(input), *PyBlitzArrayCxx_AsBlitz<bool,D>(input_mask), *PyBlitzArrayCxx_AsBlitz<double,D>(output), *PyBlitzArrayCxx_AsBlitz<bool,D>(output_mask), angle);
+    bob::ip::base::rotate<T,U>(*PyBlitzArrayCxx_AsBlitz<T,D>(input), *PyBlitzArrayCxx_AsBlitz<bool,D>(input_mask), *PyBlitzArrayCxx_AsBlitz<U,D>(output), *PyBlitzArrayCxx_AsBlitz<bool,D>(output_mask), angle);
   } else {
-    bob::ip::base::rotate<T>(*PyBlitzArrayCxx_AsBlitz<T,D>(input), *PyBlitzArrayCxx_AsBlitz<double,D>(output), angle);
+    bob::ip::base::rotate<T,U>(*PyBlitzArrayCxx_AsBlitz<T,D>(input), *PyBlitzArrayCxx_AsBlitz<U,D>(output), angle);
+  }
+}
+
+template <typename T>
+static void rotate_typed(PyBlitzArrayObject* input, PyBlitzArrayObject* input_mask, PyBlitzArrayObject* output, PyBlitzArrayObject* output_mask, double angle) {
+  switch (output->type_num){
+    case NPY_FLOAT64: if (input->ndim == 2) rotate_inner<T,double,2>(input, input_mask, output, output_mask, angle); else rotate_inner<T,double,3>(input, input_mask, output, output_mask, angle); break;
+    case NPY_FLOAT32: if (input->ndim == 2) rotate_inner<T,float,2>(input, input_mask, output, output_mask, angle);  else rotate_inner<T,float,3>(input, input_mask, output, output_mask, angle); break;
+    // otherwise, the output is of the same type as the input
+    default:          if (input->ndim == 2) rotate_inner<T,T,2>(input, input_mask, output, output_mask, angle);      else rotate_inner<T,T,3>(input, input_mask, output, output_mask, angle);
   }
 }
 
@@ -262,25 +310,27 @@ PyObject* PyBobIpBase_rotate(PyObject*, PyObject* args, PyObject* kwargs) {
       PyErr_Format(PyExc_TypeError, "rotate: the src and dst array must have the same number of dimensions");
       return 0;
     }
-    if (dst->type_num != NPY_FLOAT64){
-      PyErr_Format(PyExc_TypeError, "rotate: the dst array must be of type float64");
+    if (dst->type_num != NPY_FLOAT64 && dst->type_num != NPY_FLOAT32 && dst->type_num != src->type_num){
+      PyErr_Format(PyExc_TypeError, "rotate: the dst array must be of type float64, float32 or of the same type as the src array");
       return 0;
     }
   } else {
+    // rotations by multiples of 90 degrees are exact and keep the data type of the input
+    const int type_num = bob::ip::base::_quarterTurns(angle) >= 0 ? src->type_num : NPY_FLOAT64;
     // create output in the same dimensions as input
     switch (src->ndim){
       case 2:{
         blitz::TinyVector<int,2> orig_shape(src->shape[0], src->shape[1]);
         auto new_shape = bob::ip::base::getRotatedShape(orig_shape, angle);
         Py_ssize_t n[] = {new_shape[0], new_shape[1]};
-        dst = reinterpret_cast<PyBlitzArrayObject*>(PyBlitzArray_SimpleNew(NPY_FLOAT64, 2, n));
+        dst = reinterpret_cast<PyBlitzArrayObject*>(PyBlitzArray_SimpleNew(type_num, 2, n));
         break;
       }
       case 3:{
         blitz::TinyVector<int,3> orig_shape(src->shape[0], src->shape[1], src->shape[2]);
         auto new_shape = bob::ip::base::getRotatedShape(orig_shape, angle);
         Py_ssize_t n[] = {new_shape[0], new_shape[1], new_shape[2]};
-        dst = reinterpret_cast<PyBlitzArrayObject*>(PyBlitzArray_SimpleNew(NPY_FLOAT64, 3, n));
+        dst = reinterpret_cast<PyBlitzArrayObject*>(PyBlitzArray_SimpleNew(type_num, 3, n));
         break;
       }
       default:
@@ -296,9 +346,9 @@ PyObject* PyBobIpBase_rotate(PyObject*, PyObject* args, PyObject* kwargs) {
   }
 
   switch (src->type_num){
-    case NPY_UINT8:   if (src->ndim == 2) rotate_inner<uint8_t,2>(src, src_mask, dst, dst_mask, angle);  else rotate_inner<uint8_t,3>(src, src_mask, dst, dst_mask, angle); break;
-    case NPY_UINT16:  if (src->ndim == 2) rotate_inner<uint16_t,2>(src, src_mask, dst, dst_mask, angle); else rotate_inner<uint16_t,3>(src, src_mask, dst, dst_mask, angle); break;
-    case NPY_FLOAT64: if (src->ndim == 2) rotate_inner<double,2>(src, src_mask, dst, dst_mask, angle);   else rotate_inner<double,3>(src, src_mask, dst, dst_mask, angle); break;
+    case NPY_UINT8:   rotate_typed<uint8_t>(src, src_mask, dst, dst_mask, angle); break;
+    case NPY_UINT16:  rotate_typed<uint16_t>(src, src_mask, dst, dst_mask, angle); break;
+    case NPY_FLOAT64: rotate_typed<double>(src, src_mask, dst, dst_mask, angle); break;
     default:
       PyErr_Format(PyExc_TypeError, "rotate: src arrays of type %s are currently not supported", PyBlitzArray_TypenumAsString(src->type_num));
       return 0;
@@ -366,11 +416,15 @@ bob::extension::FunctionDoc s_maxRectInMask = bob::extension::FunctionDoc(
   "0. The y-coordinate of the top left corner\n\n"
   "1. The x-coordinate of the top left corner\n\n"
   "2. The height of the rectangle\n\n"
-  "3. The width of the rectangle"
+  "3. The width of the rectangle\n\n"
+  "When several rectangles have the maximal area, the one with the smallest top, left and height (in this order) is returned. "
+  "The runtime is linear in the number of pixels in the mask.\n\n"
+  "When a 3D stack of masks is given, the rectangles of all masks are computed using ``n_threads`` threads, and returned as an array of shape ``(N, 4)``."
 )
-.add_prototype("mask", "rect")
-.add_parameter("mask", "array_like (2D, bool)", "The mask of boolean values, e.g., as a result of :py:func:`bob.ip.base.GeomNorm.process`")
-.add_return("rect", "(int, int, int, int)", "The resulting rectangle: (top, left, height, width)")
+.add_prototype("mask, [n_threads]", "rect")
+.add_parameter("mask", "array_like (2D or 3D, bool)", "The mask of boolean values, e.g., as a result of :py:func:`bob.ip.base.GeomNorm.process`, or a stack of such masks")
+.add_parameter("n_threads", "int", "[default: 1] The number of threads to use for 3D mask stacks; if 0 or negative, all hardware threads are used")
+.add_return("rect", "(int, int, int, int) or array_like (2D, int32)", "The resulting rectangle: (top, left, height, width), or one such rectangle per mask")
 ;
 
 PyObject* PyBobIpBase_maxRectInMask(PyObject*, PyObject* args, PyObject* kwargs) {
@@ -379,15 +433,27 @@ PyObject* PyBobIpBase_maxRectInMask(PyObject*, PyObject* args, PyObject* kwargs)
   char** kwlist = s_maxRectInMask.kwlist();
 
   PyBlitzArrayObject* mask = 0;
-  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&", kwlist, &PyBlitzArray_Converter, &mask)) return 0;
+  int n_threads = 1;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&|i", kwlist, &PyBlitzArray_Converter, &mask, &n_threads)) return 0;
 
   auto mask_ = make_safe(mask);
 
-  if (mask->ndim != 2 || mask->type_num != NPY_BOOL) {
-    PyErr_Format(PyExc_TypeError, "max_rect_in_mask: the mask must be 2D and of boolean type");
+  if ((mask->ndim != 2 && mask->ndim != 3) || mask->type_num != NPY_BOOL) {
+    PyErr_Format(PyExc_TypeError, "max_rect_in_mask: the mask must be 2D or 3D and of boolean type");
     return 0;
   }
 
+  if (mask->ndim == 3){
+    Py_ssize_t n[] = {mask->shape[0], 4};
+    PyBlitzArrayObject* rects = reinterpret_cast<PyBlitzArrayObject*>(PyBlitzArray_SimpleNew(NPY_INT32, 2, n));
+    auto rects_ = make_safe(rects);
+    {
+      ReleaseGIL gil;
+      bob::ip::base::maxRectInMask(*PyBlitzArrayCxx_AsBlitz<bool, 3>(mask), *PyBlitzArrayCxx_AsBlitz<int32_t, 2>(rects), n_threads);
+    }
+    return PyBlitzArray_AsNumpyArray(rects, 0);
+  }
+
   auto rect = bob::ip::base::maxRectInMask(*PyBlitzArrayCxx_AsBlitz<bool, 2>(mask));
 
   return Py_BuildValue("(iiii)", rect[0], rect[1], rect[2], rect[3]);
@@ -415,17 +481,32 @@ bob::extension::FunctionDoc s_extrapolateMask = bob::extension::FunctionDoc(
   "3. A normal distributed random value with mean 1 and standard deviation ``random_sigma`` is added to the pixel value\n"
   "4. The pixel value is set to the image at the current position\n\n"
   "Any action considering a random number will use the given ``rng`` to create random numbers.\n\n"
+  "When a ``seed`` is given instead of the ``rng``, the unmasked pixels are filled in layers of increasing distance to the masked area (a wavefront), "
+  "and the masked area does not need to be convex. "
+  "Each pixel is filled with one of the ``2*neighbors+1`` pixels of the previous layers around one of its neighbors, perpendicular to the direction of that neighbor, multiplied with a random value as above. "
+  "The random numbers of each pixel are computed from the ``seed`` and the position of the pixel only, "
+  "so that the pixels of one layer can be processed using ``n_threads`` threads, and the result is identical for any number of threads.\n\n"
   ".. note::\n\n  For the second variant, images of type ``float`` are preferred."
 )
 .add_prototype("mask, img")
-.add_prototype("mask, img, random_sigma, [neighbors], [rng]")
+.add_prototype("mask, img, random_sigma, [neighbors], [rng], [seed], [n_threads]")
 .add_parameter("mask", "array_like (2D, bool)", "The mask which has the valid pixel set to ``True`` and the invalid pixel set to ``False``")
 .add_parameter("img", "array_like (2D, bool)", "The image that will be filled; must have the same shape as ``mask``")
 .add_parameter("random_sigma", "float", "The standard deviation of the random factor to multiply thevalid pixel value from the border with; must be greater than or equal to 0")
 .add_parameter("neighbors", "int", "[Default: 5] The number of neighbors of valid border pixels to choose one from; set ``neighbors=0`` to disable random selection")
 .add_parameter("rng", ":py:class:`bob.core.random.mt19937`", "[Default: rng initialized with the system time] The random number generator to consider")
+.add_parameter("seed", "int", "[Default: None] If given, the wavefront extrapolation with the given random seed is used; cannot be combined with ``rng``")
+.add_parameter("n_threads", "int", "[Default: 1] The number of threads to use for the wavefront extrapolation; if 0 or negative, all hardware threads are used")
 ;
 
+template <typename T>
+static void extrapolate_wavefront(PyBlitzArrayObject* mask, PyBlitzArrayObject* img, const uint64_t seed, const double sigma, const int neighbors, const int n_threads){
+  const blitz::Array<bool,2>& m = *PyBlitzArrayCxx_AsBlitz<bool,2>(mask);
+  blitz::Array<T,2>& image = *PyBlitzArrayCxx_AsBlitz<T,2>(img);
+  ReleaseGIL gil;
+  bob::ip::base::extrapolateMaskRandom(m, image, seed, sigma, neighbors, n_threads);
+}
+
 PyObject* PyBobIpBase_extrapolateMask(PyObject*, PyObject* args, PyObject* kwargs) {
   BOB_TRY
   /* Parses input arguments in a single shot */
@@ -435,13 +516,29 @@ PyObject* PyBobIpBase_extrapolateMask(PyObject*, PyObject* args, PyObject* kwarg
   double sigma = -1.;
   int neighbors = 5;
   PyBoostMt19937Object* rng = 0;
+  PyObject* seed_object = 0;
+  int n_threads = 1;
 
-  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&O&|diO&", kwlist, &PyBlitzArray_Converter, &mask, &PyBlitzArray_OutputConverter, &img, &sigma, &neighbors, &PyBoostMt19937_Converter, &rng)) return 0;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&O&|diO&Oi", kwlist, &PyBlitzArray_Converter, &mask, &PyBlitzArray_OutputConverter, &img, &sigma, &neighbors, &PyBoostMt19937_Converter, &rng, &seed_object, &n_threads)) return 0;
 
   auto mask_ = make_safe(mask), img_ = make_safe(img);
   auto rng_ = make_xsafe(rng);
 
-  if (!rng){
+  unsigned long long seed = 0;
+  bool wavefront = seed_object && seed_object != Py_None;
+  if (wavefront){
+    if (rng){
+      PyErr_Format(PyExc_ValueError, "extrapolate_mask: the rng and the seed cannot be specified at the same time");
+      return 0;
+    }
+    if (sigma < 0.){
+      PyErr_Format(PyExc_ValueError, "extrapolate_mask: the seed can only be used together with a non-negative random_sigma");
+      return 0;
+    }
+    if (!PyArg_Parse(seed_object, "K", &seed)) return 0;
+  }
+
+  if (!rng && !wavefront){
     rng = reinterpret_cast<PyBoostMt19937Object*>(PyBoostMt19937_SimpleNew());
     rng_ = make_safe(rng);
   }
@@ -465,6 +562,16 @@ PyObject* PyBobIpBase_extrapolateMask(PyObject*, PyObject* args, PyObject* kwarg
         PyErr_Format(PyExc_TypeError, "extrapolate_mask: img arrays of type %s are currently not supported", PyBlitzArray_TypenumAsString(img->type_num));
         return 0;
     }
+  } else if (wavefront){
+    // second variant, using the wavefront
+    switch (img->type_num){
+      case NPY_UINT8:   extrapolate_wavefront<uint8_t>(mask, img, seed, sigma, neighbors, n_threads); break;
+      case NPY_UINT16:  extrapolate_wavefront<uint16_t>(mask, img, seed, sigma, neighbors, n_threads); break;
+      case NPY_FLOAT64: extrapolate_wavefront<double>(mask, img, seed, sigma, neighbors, n_threads); break;
+      default:
+        PyErr_Format(PyExc_TypeError, "extrapolate_mask: img arrays of type %s are currently not supported", PyBlitzArray_TypenumAsString(img->type_num));
+        return 0;
+    }
   } else {
     // second variant
     switch (img->type_num){
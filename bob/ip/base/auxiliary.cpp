@@ -641,12 +641,13 @@ bob::extension::FunctionDoc s_lbphs = bob::extension::FunctionDoc(
   "Afterwards, the resulting image is split into several blocks with the given block size and overlap, and local LBH histograms are extracted from each region.\n\n"
   ".. note::\n\n  To get the required output shape, you can use :py:func:`lbphs_output_shape` function."
 )
-.add_prototype("input, lbp, block_size, [block_overlap], [output]", "output")
+.add_prototype("input, lbp, block_size, [block_overlap], [output], [sliding_window]", "output")
 .add_parameter("input", "array_like (2D)", "The source image to compute the LBPHS for")
 .add_parameter("lbp", ":py:class:`bob.ip.base.LBP`", "The LBP class to be used for feature extraction")
 .add_parameter("block_size", "(int, int)", "The size of the blocks in which the LBP histograms are split")
 .add_parameter("block_overlap", "(int, int)", "[default: ``(0, 0)``] The overlap of the blocks in which the LBP histograms are split")
 .add_parameter("output", "array_like(2D, uint64)", "If given, the resulting LBPHS features will be written to this array; must have the size #output-blocks, #LBP-labels (see :py:func:`lbphs_output_shape`)")
+.add_parameter("sliding_window", "bool", "[default: ``False``] If enabled, the histogram of each block is derived from the one of its left neighbor by removing and adding the LBP codes of the columns that leave and enter the block; this is faster for heavily overlapping blocks, and the result is identical")
 .add_return("output", "array_like(2D, uint64)", "The resulting LBPHS features of the size #output-blocks, #LBP-labels; the same array as the ``output`` parameter, when given.")
 ;
 
@@ -657,8 +658,8 @@ static inline blitz::TinyVector<int,2> lbphs_shape(PyBlitzArrayObject* input, Py
 }
 
 template <typename T>
-static inline PyObject* lbphs_inner(PyBlitzArrayObject* input, PyBobIpBaseLBPObject* lbp, blitz::TinyVector<int,2> block_size, blitz::TinyVector<int,2> block_overlap, PyBlitzArrayObject* output){
-  bob::ip::base::lbphs(*PyBlitzArrayCxx_AsBlitz<T,2>(input), *lbp->cxx, block_size, block_overlap, *PyBlitzArrayCxx_AsBlitz<uint64_t,2>(output));
+static inline PyObject* lbphs_inner(PyBlitzArrayObject* input, PyBobIpBaseLBPObject* lbp, blitz::TinyVector<int,2> block_size, blitz::TinyVector<int,2> block_overlap, PyBlitzArrayObject* output, bool sliding_window){
+  bob::ip::base::lbphs(*PyBlitzArrayCxx_AsBlitz<T,2>(input), *lbp->cxx, block_size, block_overlap, *PyBlitzArrayCxx_AsBlitz<uint64_t,2>(output), sliding_window);
   return PyBlitzArray_AsNumpyArray(output, 0);
 }
 
@@ -670,8 +671,9 @@ PyObject* PyBobIpBase_lbphs(PyObject*, PyObject* args, PyObject* kwds) {
   PyBlitzArrayObject* input = 0,* output = 0;
   PyBobIpBaseLBPObject* lbp;
   blitz::TinyVector<int,2> size, overlap(0,0);
+  PyObject* sliding_window_ = 0;
 
-  if (!PyArg_ParseTupleAndKeywords(args, kwds, "O&O!(ii)|(ii)O&", kwlist, &PyBlitzArray_Converter, &input, &PyBobIpBaseLBP_Type, &lbp, &size[0], &size[1], &overlap[0], &overlap[1], &PyBlitzArray_OutputConverter, &output)) return 0;
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "O&O!(ii)|(ii)O&O!", kwlist, &PyBlitzArray_Converter, &input, &PyBobIpBaseLBP_Type, &lbp, &size[0], &size[1], &overlap[0], &overlap[1], &PyBlitzArray_OutputConverter, &output, &PyBool_Type, &sliding_window_)) return 0;
 
   auto input_ = make_safe(input), output_ = make_xsafe(output);
 
@@ -690,10 +692,11 @@ PyObject* PyBobIpBase_lbphs(PyObject*, PyObject* args, PyObject* kwds) {
     output_ = make_safe(output);
   }
 
+  bool sliding_window = f(sliding_window_);
   switch (input->type_num){
-    case NPY_UINT8: return lbphs_inner<uint8_t>(input, lbp, size, overlap, output);
-    case NPY_UINT16: return lbphs_inner<uint16_t>(input, lbp, size, overlap, output);
-    case NPY_FLOAT64: return lbphs_inner<double>(input, lbp, size, overlap, output);
+    case NPY_UINT8: return lbphs_inner<uint8_t>(input, lbp, size, overlap, output, sliding_window);
+    case NPY_UINT16: return lbphs_inner<uint16_t>(input, lbp, size, overlap, output, sliding_window);
+    case NPY_FLOAT64: return lbphs_inner<double>(input, lbp, size, overlap, output, sliding_window);
     default:
       PyErr_Format(PyExc_TypeError, "lbphs does not work on 'input' images of type %s", PyBlitzArray_TypenumAsString(input->type_num));
   }
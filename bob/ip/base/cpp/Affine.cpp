@@ -10,77 +10,229 @@
 
 #include <bob.ip.base/Affine.h>
 
-static bool isTrue(const blitz::Array<bool,2>& mask, int y0, int x0, int y1, int x1)
+#include <list>
+#include <boost/make_shared.hpp>
+#include <boost/thread/mutex.hpp>
+
+/** Computes the interpolation table for one axis, replicating the source positions that bob::ip::base::transform would compute */
+static void computeAxisTable(const int src_size, const int dst_size, std::vector<int>& index0, std::vector<int>& index1, std::vector<double>& weight)
+{
+  index0.resize(dst_size);
+  index1.resize(dst_size);
+  weight.resize(dst_size);
+  // the step in the source image when going one pixel in the target image
+  // (for degenerate images with a single pixel, we always use the first source pixel)
+  const double step = src_size > 1 && dst_size > 1 ? 1. / ((dst_size-1.) / (src_size-1.)) : 0.;
+  double pos = 0.;
+  for (int i = 0; i < dst_size; ++i){
+    int i0 = std::floor(pos);
+    double w = pos - i0;
+    // clamp positions to the image, so that both indices are always valid
+    if (i0 < 0){
+      i0 = 0;
+      w = 0.;
+    } else if (i0 >= src_size-1){
+      i0 = std::max(src_size-2, 0);
+      w = src_size > 1 ? 1. : 0.;
+    }
+    index0[i] = i0;
+    index1[i] = std::min(i0+1, std::max(src_size-1, 0));
+    weight[i] = w;
+    pos += step;
+  }
+}
+
+bob::ip::base::ScaleTables::ScaleTables(const blitz::TinyVector<int,2>& src_shape, const blitz::TinyVector<int,2>& dst_shape)
+: m_src_shape(src_shape),
+  m_dst_shape(dst_shape)
 {
-  for(int j=y0; j<=y1; ++j)
-    for(int i=x0; i<=x1; ++i)
-      if(!mask(j,i))
-        return false;
-  return true;
+  computeAxisTable(src_shape[0], dst_shape[0], m_row_index0, m_row_index1, m_row_weight);
+  computeAxisTable(src_shape[1], dst_shape[1], m_col_index0, m_col_index1, m_col_weight);
+  // mark the source rows that are required
+  m_used_rows.resize(std::max(src_shape[0], 0), 0);
+  for (int y = 0; y < dst_shape[0] && src_shape[0] > 0; ++y){
+    m_used_rows[m_row_index0[y]] = 1;
+    m_used_rows[m_row_index1[y]] = 1;
+  }
+}
+
+void bob::ip::base::_scale(const blitz::Array<uint8_t,2>& src, blitz::Array<uint8_t,2>& dst, const bob::ip::base::ScaleTables& tables){
+  const int src_height = src.extent(0), dst_height = dst.extent(0), dst_width = dst.extent(1);
+  if (!src.size()){
+    dst = 0;
+    return;
+  }
+  if (!dst.size()) return;
+
+  const std::vector<int>& row_index0 = tables.getRowIndex0(), & row_index1 = tables.getRowIndex1();
+  const std::vector<int>& col_index0 = tables.getColumnIndex0(), & col_index1 = tables.getColumnIndex1();
+  const std::vector<char>& used_rows = tables.getUsedRows();
+
+  // quantize the weights to 8 bit
+  std::vector<int> row_weight(dst_height), col_weight(dst_width);
+  for (int y = 0; y < dst_height; ++y) row_weight[y] = static_cast<int>(tables.getRowWeight()[y] * 256. + .5);
+  for (int x = 0; x < dst_width; ++x) col_weight[x] = static_cast<int>(tables.getColumnWeight()[x] * 256. + .5);
+
+  // first pass: interpolate the required source rows horizontally; 16 bits are sufficient to store 255 * 256
+  std::vector<uint16_t> buffer(src_height * dst_width);
+  const int src_stride = src.stride(1);
+  for (int y = 0; y < src_height; ++y){
+    if (!used_rows[y]) continue;
+    const uint8_t* s = &src(y,0);
+    uint16_t* b = &buffer[y * dst_width];
+    for (int x = 0; x < dst_width; ++x){
+      const int w = col_weight[x];
+      b[x] = static_cast<uint16_t>(s[col_index0[x] * src_stride] * (256 - w) + s[col_index1[x] * src_stride] * w);
+    }
+  }
+
+  // second pass: interpolate the buffered rows vertically, with rounding
+  const int dst_stride = dst.stride(1);
+  for (int y = 0; y < dst_height; ++y){
+    const uint16_t* b0 = &buffer[row_index0[y] * dst_width];
+    const uint16_t* b1 = &buffer[row_index1[y] * dst_width];
+    const int w = row_weight[y];
+    uint8_t* d = &dst(y,0);
+    for (int x = 0; x < dst_width; ++x){
+      d[x * dst_stride] = static_cast<uint8_t>((b0[x] * (256 - w) + b1[x] * w + (1 << 15)) >> 16);
+    }
+  }
 }
 
+// the cache of recently used interpolation tables, most recently used first
+static const size_t s_scale_tables_cache_size = 16;
+static std::list<boost::shared_ptr<const bob::ip::base::ScaleTables> > s_scale_tables_cache;
+static boost::mutex s_scale_tables_mutex;
+
+boost::shared_ptr<const bob::ip::base::ScaleTables> bob::ip::base::getScaleTables(const blitz::TinyVector<int,2>& src_shape, const blitz::TinyVector<int,2>& dst_shape){
+  boost::mutex::scoped_lock lock(s_scale_tables_mutex);
+  for (auto it = s_scale_tables_cache.begin(); it != s_scale_tables_cache.end(); ++it){
+    const blitz::TinyVector<int,2>& s = (*it)->getSourceShape(), & d = (*it)->getTargetShape();
+    if (s[0] == src_shape[0] && s[1] == src_shape[1] && d[0] == dst_shape[0] && d[1] == dst_shape[1]){
+      boost::shared_ptr<const bob::ip::base::ScaleTables> tables = *it;
+      // move to front
+      s_scale_tables_cache.erase(it);
+      s_scale_tables_cache.push_front(tables);
+      return tables;
+    }
+  }
+  // not found; compute new tables
+  boost::shared_ptr<const bob::ip::base::ScaleTables> tables = boost::make_shared<bob::ip::base::ScaleTables>(src_shape, dst_shape);
+  s_scale_tables_cache.push_front(tables);
+  if (s_scale_tables_cache.size() > s_scale_tables_cache_size)
+    s_scale_tables_cache.pop_back();
+  return tables;
+}
 
 const blitz::TinyVector<int,4> bob::ip::base::maxRectInMask(const blitz::Array<bool,2>& mask){
+  bob::core::array::assertZeroBase(mask);
   const int height = mask.extent(0);
   const int width = mask.extent(1);
   blitz::TinyVector<int,4> cur_sol = 0;
   int cur_max_area = 0;
 
-  for( int y0=0; y0<height; ++y0)
+  // The rectangles are searched by their top row y0, which is visited from
+  // the bottom to the top. For each column, depth contains the number of
+  // consecutive true values starting at row y0 downwards, so that the
+  // rectangles with top row y0 are the rectangles under this histogram.
+  std::vector<int> depth(width, 0), stack;
+  stack.reserve(width);
+  for (int y0 = height; y0--;)
   {
-    // Find first true value
+    for (int x = 0; x < width; ++x)
+      depth[x] = mask(y0,x) ? depth[x] + 1 : 0;
+
+    // Only the first sequence of true values in row y0 is considered
     int i_min = 0;
-    bool found_true = false;
-    for(int x0=0; x0<width; ++x0)
-      if(mask(y0,x0))
-      {
-        i_min=x0;
-        found_true = true;
-        break;
-      }
-    if(!found_true)
+    while (i_min < width && !depth[i_min])
+      ++i_min;
+    if (i_min == width)
       continue;
+    int i_max = i_min + 1;
+    while (i_max < width && depth[i_max])
+      ++i_max;
 
-    // Find last true value
-    int i_max = width;
-    for(int x0=i_min+1; x0<width; ++x0)
-      if(!mask(y0,x0))
-      {
-        i_max = x0;
-        break;
-      }
-
-    // Find largest rectangle visiting all the possible combinations
-    for(int x0=i_min; x0<i_max; ++x0)
+    // Largest rectangle under the histogram using a stack of increasing depths;
+    // each popped column defines the widest rectangle with its depth as height
+    stack.clear();
+    for (int x1 = i_min; x1 <= i_max; ++x1)
     {
-      int cur_i_max = i_max;
-      for(int y1=y0; y1<height; ++y1)
-        for(int x1=x0; x1<cur_i_max; ++x1)
+      const int cur_depth = x1 < i_max ? depth[x1] : 0;
+      while (!stack.empty() && depth[stack.back()] >= cur_depth)
+      {
+        const int h = depth[stack.back()];
+        stack.pop_back();
+        const int x0 = stack.empty() ? i_min : stack.back() + 1;
+        const int area = h * (x1 - x0);
+        // ties are resolved by the smallest y0, x0 and height, in this order
+        if (area > cur_max_area || (area == cur_max_area &&
+            (y0 < cur_sol(0) || (y0 == cur_sol(0) && (x0 < cur_sol(1) || (x0 == cur_sol(1) && h < cur_sol(2)))))))
         {
-          if(isTrue(mask,y1,x0,y1,x1))
-          {
-            int area = (y1-y0+1)*(x1-x0+1);
-            if( area > cur_max_area )
-            {
-              cur_max_area = area;
-              cur_sol(0) = y0;
-              cur_sol(1) = x0;
-              cur_sol(2) = y1-y0+1;
-              cur_sol(3) = x1-x0+1;
-            }
-          }
-          else
-          {
-            if(x1 < cur_i_max)
-              cur_i_max = x1;
-            break;
-          }
+          cur_max_area = area;
+          cur_sol(0) = y0;
+          cur_sol(1) = x0;
+          cur_sol(2) = h;
+          cur_sol(3) = x1 - x0;
         }
+      }
+      stack.push_back(x1);
     }
   }
 
   return cur_sol;
 }
 
+void bob::ip::base::maxRectInMask(const blitz::Array<bool,3>& masks, blitz::Array<int32_t,2>& rects, const int n_threads){
+  bob::core::array::assertZeroBase(rects);
+  bob::core::array::assertSameDimensionLength(rects.extent(0), masks.extent(0));
+  bob::core::array::assertSameDimensionLength(rects.extent(1), 4);
 
+  // Slice the masks beforehand, since blitz reference counting is not thread-safe
+  std::vector<blitz::Array<bool,2> > slices(masks.extent(0));
+  for (int k = 0; k < masks.extent(0); ++k){
+    slices[k].reference(masks(k, blitz::Range::all(), blitz::Range::all()));
+  }
 
+  parallelFor(masks.extent(0), n_threads, [&](int begin, int end){
+    for (int k = begin; k < end; ++k){
+      const blitz::TinyVector<int,4> rect = maxRectInMask(slices[k]);
+      for (int i = 0; i < 4; ++i) rects(k,i) = rect(i);
+    }
+  });
+}
+
+
+
+
+void bob::ip::base::_wavefrontLayers(const blitz::Array<bool,2>& mask, std::vector<int>& distance, std::vector<int>& order, std::vector<int>& layers){
+  const int height = mask.extent(0), width = mask.extent(1);
+  distance.assign(height * width, -1);
+  order.clear();
+  layers.assign(1, 0);
+
+  // the masked pixels are the sources of the wavefront
+  std::vector<int> sources;
+  for (int y = 0; y < height; ++y)
+    for (int x = 0; x < width; ++x)
+      if (mask(y,x)){
+        distance[y * width + x] = 0;
+        sources.push_back(y * width + x);
+      }
+  if (sources.empty()) throw std::runtime_error("The mask does not contain any valid pixel");
+  order.reserve(height * width - sources.size());
+
+  // breadth-first search with 4-connectivity, one layer at a time
+  for (int d = 0; ; ++d){
+    const std::vector<int>& previous = d ? order : sources;
+    const int begin = d ? layers[d-1] : 0, end = d ? layers[d] : sources.size();
+    for (int i = begin; i < end; ++i){
+      const int y = previous[i] / width, x = previous[i] % width;
+      if (y > 0 && distance[(y-1) * width + x] < 0) {distance[(y-1) * width + x] = d+1; order.push_back((y-1) * width + x);}
+      if (x > 0 && distance[y * width + x-1] < 0) {distance[y * width + x-1] = d+1; order.push_back(y * width + x-1);}
+      if (y < height-1 && distance[(y+1) * width + x] < 0) {distance[(y+1) * width + x] = d+1; order.push_back((y+1) * width + x);}
+      if (x < width-1 && distance[y * width + x+1] < 0) {distance[y * width + x+1] = d+1; order.push_back(y * width + x+1);}
+    }
+    if (static_cast<int>(order.size()) == layers.back()) break;
+    layers.push_back(order.size());
+  }
+}
@@ -66,3 +66,25 @@ bool bob::ip::base::FaceEyesNorm::operator!=(const bob::ip::base::FaceEyesNorm&
 
 
 
+
+void bob::ip::base::FaceEyesNorm::computeParameters(
+    const blitz::TinyVector<double,2>& rightEye,
+    const blitz::TinyVector<double,2>& leftEye,
+    double& angle,
+    double& scale,
+    blitz::TinyVector<double,2>& center
+) const
+{
+  // Get angle to horizontal
+  double dy = leftEye[0] - rightEye[0], dx = leftEye[1] - rightEye[1];
+  angle = std::atan2(dy, dx) * 180. / M_PI - m_eyesAngle;
+
+  // Get scaling factor
+  scale = m_eyesDistance / sqrt(_sqr(dy) + _sqr(dx));
+
+  // Get the center (of the eye centers segment)
+  center = blitz::TinyVector<double,2>(
+    (rightEye[0] + leftEye[0]) / 2.,
+    (rightEye[1] + leftEye[1]) / 2.
+  );
+}
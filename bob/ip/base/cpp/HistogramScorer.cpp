@@ -0,0 +1,80 @@
+/**
+ * @date Sat Oct 17 18:42:17 CEST 2026
+ *
+ * This file defines a class that compares histogram sequences, e.g., LBPHS features, to many enrolled templates
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <cmath>
+#include <bob.core/array_copy.h>
+#include <bob.ip.base/HistogramScorer.h>
+
+bob::ip::base::HistogramScorer::HistogramScorer(const blitz::TinyVector<int,2>& histogram_shape, const HistogramMeasure measure, const bool compact)
+: m_shape(histogram_shape),
+  m_measure(measure),
+  m_compact(compact),
+  m_n_templates(0)
+{
+  if (m_shape[0] <= 0 || m_shape[1] <= 0)
+    throw std::runtime_error((boost::format("The histogram shape (%d, %d) needs to be positive") % m_shape[0] % m_shape[1]).str());
+}
+
+bob::ip::base::HistogramScorer::HistogramScorer(const HistogramScorer& other)
+: m_shape(other.m_shape),
+  m_compact(other.m_compact)
+{
+  boost::shared_lock<boost::shared_mutex> lock(other.m_mutex);
+  m_measure = other.m_measure;
+  m_weights.reference(bob::core::array::ccopy(other.m_weights));
+  m_n_templates = other.m_n_templates;
+  m_counts = other.m_counts;
+  m_values = other.m_values;
+}
+
+bob::ip::base::HistogramScorer::~HistogramScorer() { }
+
+bob::ip::base::HistogramScorer& bob::ip::base::HistogramScorer::operator=(const HistogramScorer& other) {
+  if (this == &other) return *this;
+  // copy the other scorer first, so that both mutexes are never locked at the same time
+  const HistogramScorer copy(other);
+  boost::unique_lock<boost::shared_mutex> lock(m_mutex);
+  m_shape = copy.m_shape;
+  m_measure = copy.m_measure;
+  m_compact = copy.m_compact;
+  m_weights.reference(copy.m_weights);
+  m_n_templates = copy.m_n_templates;
+  m_counts = copy.m_counts;
+  m_values = copy.m_values;
+  return *this;
+}
+
+void bob::ip::base::HistogramScorer::setWeights(const blitz::Array<double,1>& weights) {
+  if (weights.size() && weights.extent(0) != m_shape[0])
+    throw std::runtime_error((boost::format("The number of weights (%d) differs from the number of blocks (%d)") % weights.extent(0) % m_shape[0]).str());
+  for (int b = weights.lbound(0); b <= weights.ubound(0); ++b)
+    if (!std::isfinite(weights(b)))
+      throw std::runtime_error((boost::format("The weight %g of block %d is not finite") % weights(b) % (b - weights.lbound(0))).str());
+  // the weights are stored contiguously, so that they can be accessed by pointer
+  boost::unique_lock<boost::shared_mutex> lock(m_mutex);
+  m_weights.reference(bob::core::array::ccopy(weights));
+}
+
+void bob::ip::base::HistogramScorer::clear() {
+  boost::unique_lock<boost::shared_mutex> lock(m_mutex);
+  m_n_templates = 0;
+  m_counts.clear();
+  m_values.clear();
+}
+
+void bob::ip::base::HistogramScorer::checkShape(const blitz::TinyVector<int,2>& shape) const {
+  if (shape[0] != m_shape[0] || shape[1] != m_shape[1])
+    throw std::runtime_error((boost::format("The histogram sequence needs to be of shape (%d, %d), but has shape (%d, %d)") % m_shape[0] % m_shape[1] % shape[0] % shape[1]).str());
+}
+
+void bob::ip::base::HistogramScorer::score_(const std::vector<float>& probe, double* scores, const int n_threads) const {
+  if (m_compact)
+    score_(probe, m_counts, scores, n_threads);
+  else
+    score_(probe, m_values, scores, n_threads);
+}
@@ -43,7 +43,8 @@ bob::ip::base::LBP::LBP(
   m_border_handling(border_handling),
   m_lut(0),
   m_positions(0,0),
-  m_int_positions(0,0)
+  m_int_positions(0,0),
+  m_weights(0,0)
 {
   // sanity check
   if (m_eLBP_type == ELBP_DIRECTION_CODED && m_P%2) {
@@ -79,7 +80,8 @@ bob::ip::base::LBP::LBP(
   m_border_handling(border_handling),
   m_lut(0),
   m_positions(0,0),
-  m_int_positions(0,0)
+  m_int_positions(0,0),
+  m_weights(0,0)
 {
   // sanity check
   if (m_eLBP_type == ELBP_DIRECTION_CODED && m_P%2) {
@@ -114,7 +116,8 @@ bob::ip::base::LBP::LBP(
   m_border_handling(border_handling),
   m_lut(0),
   m_positions(0,0),
-  m_int_positions(0,0)
+  m_int_positions(0,0),
+  m_weights(0,0)
 {
   // sanity check
   if (m_eLBP_type == ELBP_DIRECTION_CODED && m_P%2) {
@@ -140,7 +143,8 @@ bob::ip::base::LBP::LBP(bob::io::base::HDF5File file):
   m_border_handling(bob::ip::base::LBP_BORDER_SHRINK),
   m_lut(0),
   m_positions(0,0),
-  m_int_positions(0,0)
+  m_int_positions(0,0),
+  m_weights(0,0)
 {
   // sanity check
   load(file);
@@ -164,7 +168,8 @@ bob::ip::base::LBP::LBP(const bob::ip::base::LBP& other):
   m_border_handling(other.m_border_handling),
   m_lut(0),
   m_positions(0,0),
-  m_int_positions(0,0)
+  m_int_positions(0,0),
+  m_weights(0,0)
 {
   // sanity check
   if (m_eLBP_type == ELBP_DIRECTION_CODED && m_P%2) {
@@ -217,6 +222,22 @@ uint16_t bob::ip::base::LBP::right_shift_circular(uint16_t pattern, int spaces)
   return (pattern >> spaces | pattern << (m_P-spaces)) & ((1 << m_P) - 1);
 }
 
+/** Computes the two taps and the weight of the second tap for the linear interpolation at the given position */
+static void _bilinearTaps(const double position, const int radius, int& low, int& high, double& weight){
+  low = (int)floor(position);
+  weight = position - low;
+  high = low + 1;
+  // due to rounding errors, a tap might lie just outside the radius, but it has a weight close to 0
+  if (low < -radius){
+    low = high;
+    weight = 0.;
+  }
+  if (high > radius){
+    high = low;
+    weight = 0.;
+  }
+}
+
 void bob::ip::base::LBP::init()
 {
   if (m_P < 4)
@@ -246,9 +267,6 @@ void bob::ip::base::LBP::init()
     throw std::runtime_error("Overlap of Multi-block LBP's must be positive and smaller than the multi-block size");
   }
 
-  // initialize temporal memory
-  _pixels.resize(m_P);
-
   // initialize the positions
   if (m_mb_y > 0 && m_mb_x > 0){
     // multi-block LBP requested; store the top-left and bottom-right entry for all our positions
@@ -303,6 +321,19 @@ void bob::ip::base::LBP::init()
         m_positions(p,0) = m_R_y * sin(angle);
         m_positions(p,1) = m_R_x * cos(angle);
       }
+      // pre-compute the four bi-linear interpolation taps and their weights for each point;
+      // the taps are kept inside of [-ceil(R), ceil(R)], so that they can be used with shrinking borders
+      m_int_positions.resize(m_P,4);
+      m_weights.resize(m_P,4);
+      for (int p = 0; p < m_P; ++p){
+        double w_y, w_x;
+        _bilinearTaps(m_positions(p,0), (int)ceil(m_R_y), m_int_positions(p,0), m_int_positions(p,1), w_y);
+        _bilinearTaps(m_positions(p,1), (int)ceil(m_R_x), m_int_positions(p,2), m_int_positions(p,3), w_x);
+        m_weights(p,0) = (1. - w_y) * (1. - w_x);
+        m_weights(p,1) = (1. - w_y) * w_x;
+        m_weights(p,2) = w_y * (1. - w_x);
+        m_weights(p,3) = w_y * w_x;
+      }
     }else{ // circular
       blitz::TinyVector<int, 8> d_y, d_x;
       int r_y = (int)round(m_R_y), r_x = (int)round(m_R_x);
@@ -0,0 +1,80 @@
+/**
+ * @date Sat Oct 17 16:21:03 CEST 2026
+ *
+ * This file defines a class that evaluates a fixed list of LBP features in many windows of an image
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <limits>
+#include <algorithm>
+#include <bob.ip.base/LBPFeatureSet.h>
+
+bob::ip::base::LBPFeatureSet::LBPFeatureSet(const std::vector<boost::shared_ptr<LBP> >& lbps, const std::vector<blitz::TinyVector<int,2> >& positions)
+: m_lbps(lbps),
+  m_positions(positions)
+{
+  if (m_lbps.size() != m_positions.size())
+    throw std::runtime_error((boost::format("The number of LBP extractors (%d) and positions (%d) differ") % m_lbps.size() % m_positions.size()).str());
+}
+
+bob::ip::base::LBPFeatureSet::LBPFeatureSet(const LBPFeatureSet& other)
+: m_lbps(other.m_lbps),
+  m_positions(other.m_positions)
+{
+}
+
+bob::ip::base::LBPFeatureSet::~LBPFeatureSet() { }
+
+bob::ip::base::LBPFeatureSet& bob::ip::base::LBPFeatureSet::operator=(const LBPFeatureSet& other) {
+  m_lbps = other.m_lbps;
+  m_positions = other.m_positions;
+  return *this;
+}
+
+bool bob::ip::base::LBPFeatureSet::hasMultiBlockLBP() const {
+  for (size_t f = 0; f < m_lbps.size(); ++f)
+    if (m_lbps[f]->isMultiBlockLBP()) return true;
+  return false;
+}
+
+void bob::ip::base::LBPFeatureSet::check(const blitz::TinyVector<int,2>& shape, const blitz::Array<int,2>& windows, const blitz::Array<uint16_t,2>& dst) const {
+  bob::core::array::assertZeroBase(windows);
+  bob::core::array::assertZeroBase(dst);
+  if (windows.extent(1) != 2)
+    throw std::runtime_error((boost::format("The window origins need to be of shape (n_windows, 2), but the second dimension is %d") % windows.extent(1)).str());
+  bob::core::array::assertSameShape(dst, blitz::TinyVector<int,2>(windows.extent(0), getNumberOfFeatures()));
+  if (!windows.extent(0)) return;
+
+  // the range of all window origins
+  blitz::TinyVector<int,2> min_origin(std::numeric_limits<int>::max(), std::numeric_limits<int>::max()), max_origin(std::numeric_limits<int>::min(), std::numeric_limits<int>::min());
+  for (int w = 0; w < windows.extent(0); ++w){
+    for (int i = 0; i < 2; ++i){
+      min_origin[i] = std::min(min_origin[i], windows(w,i));
+      max_origin[i] = std::max(max_origin[i], windows(w,i));
+    }
+  }
+
+  // check that each feature can be extracted at the extreme window origins; the sums are computed in 64 bit, so that they cannot overflow
+  for (size_t f = 0; f < m_lbps.size(); ++f){
+    const blitz::TinyVector<int,2> min = m_lbps[f]->getOffset(), max = m_lbps[f]->getLBPShape(shape) + min;
+    for (int i = 0; i < 2; ++i){
+      const int64_t position = m_positions[f][i];
+      if (min_origin[i] + position < min[i] || max_origin[i] + position >= max[i]){
+        boost::format m("feature %d at position (%d, %d) cannot be extracted for window origins in range [%d, %d] x [%d, %d] of an image of shape (%d, %d)");
+        m % f % m_positions[f][0] % m_positions[f][1] % min_origin[0] % max_origin[0] % min_origin[1] % max_origin[1] % shape[0] % shape[1];
+        throw std::runtime_error(m.str());
+      }
+    }
+  }
+}
+
+void bob::ip::base::LBPFeatureSet::extract(const PreparedImage& src, const blitz::Array<int,2>& windows, blitz::Array<uint16_t,2>& dst, const int n_threads) const {
+  check(src.getShape(), windows, dst);
+  if (!hasMultiBlockLBP())
+    extract_(src.getSource(), blitz::Array<double,2>(), windows, dst, n_threads);
+  else if (src.isIntegerImage())
+    extract_(src.getSource(), src.getIntegerIntegral(), windows, dst, n_threads);
+  else
+    extract_(src.getSource(), src.getIntegral(), windows, dst, n_threads);
+}
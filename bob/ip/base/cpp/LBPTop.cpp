@@ -58,3 +58,29 @@ bob::ip::base::LBPTop& bob::ip::base::LBPTop::operator= (const LBPTop& other) {
   m_lbp_yt = other.m_lbp_yt;
   return *this;
 }
+
+int bob::ip::base::LBPTop::getBorder() const {
+  int radius_x = m_lbp_xy->getRadii()[1];
+  int radius_y = m_lbp_xy->getRadii()[0];
+  int radius_t = m_lbp_yt->getRadii()[0];
+  return std::max(std::max(radius_x, radius_y), radius_t);
+}
+
+blitz::TinyVector<int,2> bob::ip::base::LBPTop::getHistogramShape(
+    const blitz::TinyVector<int,3>& shape,
+    const blitz::TinyVector<int,3>& block_size,
+    const blitz::TinyVector<int,3>& block_overlap
+) const {
+  static const char* axes[] = {"time", "height", "width"};
+  const int border = getBorder();
+  int n_blocks = 1;
+  for (int a = 0; a < 3; ++a){
+    const int length = shape[a] - 2 * border;
+    if (block_size[a] < 1 || block_size[a] > length)
+      throw std::runtime_error((boost::format("the block size in %s direction (%d) is outside the expected range [1, %d]") % axes[a] % block_size[a] % length).str());
+    if (block_overlap[a] < 0 || block_overlap[a] >= block_size[a])
+      throw std::runtime_error((boost::format("the block overlap in %s direction (%d) is outside the expected range [0, %d]") % axes[a] % block_overlap[a] % (block_size[a]-1)).str());
+    n_blocks *= (length - block_overlap[a]) / (block_size[a] - block_overlap[a]);
+  }
+  return blitz::TinyVector<int,2>(n_blocks, m_lbp_xy->getMaxLabel() + m_lbp_xt->getMaxLabel() + m_lbp_yt->getMaxLabel());
+}
@@ -0,0 +1,113 @@
+/**
+ * @date Sun Oct 18 10:07:44 CEST 2026
+ *
+ * This class extracts LBP-TOP codes from a stream of frames, keeping only
+ * the frames that are required for the temporal radius. This is the
+ * implementation file.
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <vector>
+#include <bob.ip.base/LBPTopStream.h>
+
+bob::ip::base::LBPTopStream::LBPTopStream(boost::shared_ptr<LBPTop> lbp_top, const blitz::TinyVector<int,2>& frame_shape)
+: m_lbp_top(lbp_top),
+  m_radius_t(lbp_top->getYT()->getRadii()[0]),
+  m_border(lbp_top->getBorder()),
+  m_n_frames(0)
+{
+  if (frame_shape[0] <= 2 * m_border || frame_shape[1] <= 2 * m_border){
+    throw std::runtime_error((boost::format("The frame shape (%d, %d) is too small for the LBP-TOP radius %d") % frame_shape[0] % frame_shape[1] % m_border).str());
+  }
+  m_frames.resize(2 * (2 * m_radius_t + 1), frame_shape[0], frame_shape[1]);
+  m_xy.resize(getOutputShape());
+  m_xt.resize(getOutputShape());
+  m_yt.resize(getOutputShape());
+}
+
+bob::ip::base::LBPTopStream::LBPTopStream(const LBPTopStream& other)
+: m_lbp_top(other.m_lbp_top),
+  m_radius_t(other.m_radius_t),
+  m_border(other.m_border),
+  m_xy(other.m_xy.shape()),
+  m_xt(other.m_xt.shape()),
+  m_yt(other.m_yt.shape())
+{
+  boost::mutex::scoped_lock lock(other.m_mutex);
+  m_frames.reference(other.m_frames.copy());
+  m_n_frames = other.m_n_frames;
+}
+
+bob::ip::base::LBPTopStream::~LBPTopStream() { }
+
+bob::ip::base::LBPTopStream& bob::ip::base::LBPTopStream::operator=(const LBPTopStream& other) {
+  if (this == &other) return *this;
+  // lock both streams in a fixed order, so that concurrent assignments cannot deadlock
+  boost::mutex::scoped_lock first(this < &other ? m_mutex : other.m_mutex), second(this < &other ? other.m_mutex : m_mutex);
+  m_lbp_top = other.m_lbp_top;
+  m_radius_t = other.m_radius_t;
+  m_border = other.m_border;
+  m_frames.reference(other.m_frames.copy());
+  m_n_frames = other.m_n_frames;
+  m_xy.resize(other.m_xy.shape());
+  m_xt.resize(other.m_xt.shape());
+  m_yt.resize(other.m_yt.shape());
+  return *this;
+}
+
+blitz::TinyVector<int,2> bob::ip::base::LBPTopStream::getOutputShape() const {
+  return blitz::TinyVector<int,2>(m_frames.extent(1) - 2 * m_border, m_frames.extent(2) - 2 * m_border);
+}
+
+blitz::TinyVector<int,2> bob::ip::base::LBPTopStream::getHistogramShape(const blitz::TinyVector<int,2>& block_size, const blitz::TinyVector<int,2>& block_overlap) const {
+  const blitz::TinyVector<int,2> shape = getOutputShape();
+  _blockCheckInput(shape[0], shape[1], block_size[0], block_size[1], block_overlap[0], block_overlap[1]);
+  const int n_blocks = getBlock3DOutputShape(shape[0], shape[1], block_size[0], block_size[1], block_overlap[0], block_overlap[1])[0];
+  return blitz::TinyVector<int,2>(n_blocks, m_lbp_top->getXY()->getMaxLabel() + m_lbp_top->getXT()->getMaxLabel() + m_lbp_top->getYT()->getMaxLabel());
+}
+
+void bob::ip::base::LBPTopStream::reset() {
+  boost::mutex::scoped_lock lock(m_mutex);
+  m_n_frames = 0;
+}
+
+void bob::ip::base::LBPTopStream::extract(blitz::Array<uint16_t,2>& xy, blitz::Array<uint16_t,2>& xt, blitz::Array<uint16_t,2>& yt, const int n_threads) const {
+  // the last 2*R_t+1 frames in temporal order
+  const int length = 2 * m_radius_t + 1;
+  const int slot = (m_n_frames - 1) % length;
+  const blitz::Array<double,3> frames = m_frames(blitz::Range(slot + 1, slot + length), blitz::Range::all(), blitz::Range::all());
+  const int height = frames.extent(1), width = frames.extent(2);
+  const LBP& lbp_xy = *m_lbp_top->getXY(),& lbp_xt = *m_lbp_top->getXT(),& lbp_yt = *m_lbp_top->getYT();
+
+  // collect the XY frame and the XT and YT slices through the central frame, together with their output rows;
+  // all blitz::Array views are created here, since they must not be created in the threads
+  const blitz::TinyVector<int,2> frame_border(m_border, m_border), slice_border(m_radius_t, m_border);
+  std::vector<const LBP*> lbps;
+  std::vector<blitz::Array<double,2> > views;
+  std::vector<blitz::Array<uint16_t,2> > planes;
+  std::vector<blitz::TinyVector<int,2> > borders;
+
+  lbps.push_back(&lbp_xy);
+  planes.push_back(xy);
+  views.push_back(_lbpTopView(lbp_xy, blitz::Array<double,2>(frames(m_radius_t, blitz::Range::all(), blitz::Range::all())), frame_border, xy.shape()));
+  borders.push_back(frame_border);
+  for (int y = m_border; y < height - m_border; ++y){
+    lbps.push_back(&lbp_xt);
+    planes.push_back(xt(blitz::Range(y - m_border, y - m_border), blitz::Range::all()));
+    views.push_back(_lbpTopView(lbp_xt, blitz::Array<double,2>(frames(blitz::Range::all(), y, blitz::Range::all())), slice_border, planes.back().shape()));
+    borders.push_back(slice_border);
+  }
+  for (int x = m_border; x < width - m_border; ++x){
+    lbps.push_back(&lbp_yt);
+    planes.push_back(yt(blitz::Range::all(), blitz::Range(x - m_border, x - m_border)).transpose(1,0));
+    views.push_back(_lbpTopView(lbp_yt, blitz::Array<double,2>(frames(blitz::Range::all(), blitz::Range::all(), x)), slice_border, planes.back().shape()));
+    borders.push_back(slice_border);
+  }
+
+  // extract the planes in parallel
+  parallelFor((int)planes.size(), n_threads, [&](int begin, int end){
+    for (int p = begin; p < end; ++p)
+      _lbpTopExtract(*lbps[p], views[p], borders[p], planes[p]);
+  });
+}
@@ -0,0 +1,63 @@
+/**
+ * @date Sat Oct 17 14:05:48 CEST 2026
+ *
+ * This file defines a class that extracts multi-block LBP codes of several block sizes from the same integral image
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <boost/format.hpp>
+#include <bob.ip.base/MultiScaleLBP.h>
+
+bob::ip::base::MultiScaleLBP::MultiScaleLBP(const std::vector<boost::shared_ptr<LBP> >& lbps)
+{
+  if (lbps.empty())
+    throw std::runtime_error("The multi-scale LBP extractor requires at least one LBP");
+  // copy the given LBP's, so that they cannot be modified after they have been checked
+  for (size_t s = 0; s < lbps.size(); ++s){
+    if (!lbps[s]->isMultiBlockLBP())
+      throw std::runtime_error((boost::format("The LBP of scale %d is not a multi-block LBP") % s).str());
+    m_lbps.push_back(boost::shared_ptr<LBP>(new LBP(*lbps[s])));
+  }
+}
+
+bob::ip::base::MultiScaleLBP::MultiScaleLBP(const MultiScaleLBP& other)
+: m_lbps(other.m_lbps)
+{
+}
+
+bob::ip::base::MultiScaleLBP::~MultiScaleLBP() { }
+
+bob::ip::base::MultiScaleLBP& bob::ip::base::MultiScaleLBP::operator=(const MultiScaleLBP& other) {
+  m_lbps = other.m_lbps;
+  return *this;
+}
+
+blitz::TinyVector<int,2> bob::ip::base::MultiScaleLBP::getOffset() const {
+  blitz::TinyVector<int,2> offset(0,0);
+  for (size_t s = 0; s < m_lbps.size(); ++s){
+    const blitz::TinyVector<int,2> o = m_lbps[s]->getOffset();
+    offset[0] = std::max(offset[0], o[0]);
+    offset[1] = std::max(offset[1], o[1]);
+  }
+  return offset;
+}
+
+blitz::TinyVector<int,3> bob::ip::base::MultiScaleLBP::getLBPShape(const blitz::TinyVector<int,2>& resolution, bool is_integral_image) const {
+  // the LBP image of each scale covers the central pixels [offset, offset + shape) of the image
+  const blitz::TinyVector<int,2> offset = getOffset();
+  blitz::TinyVector<int,2> end(std::numeric_limits<int>::max(), std::numeric_limits<int>::max());
+  for (size_t s = 0; s < m_lbps.size(); ++s){
+    const blitz::TinyVector<int,2> o = m_lbps[s]->getOffset(), shape = m_lbps[s]->getLBPShape(resolution, is_integral_image);
+    end[0] = std::min(end[0], o[0] + shape[0]);
+    end[1] = std::min(end[1], o[1] + shape[1]);
+  }
+  return blitz::TinyVector<int,3>(m_lbps.size(), std::max(0, end[0] - offset[0]), std::max(0, end[1] - offset[1]));
+}
+
+void bob::ip::base::MultiScaleLBP::extract(const PreparedImage& src, blitz::Array<uint16_t,3>& dst, const int n_threads) const {
+  if (src.isIntegerImage())
+    extractFromIntegral(src.getIntegerIntegral(), dst, n_threads);
+  else
+    extractFromIntegral(src.getIntegral(), dst, n_threads);
+}
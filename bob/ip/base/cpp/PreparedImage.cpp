@@ -0,0 +1,80 @@
+/**
+ * @date Sat Oct 17 09:41:27 CEST 2026
+ *
+ * This file defines a class that holds an image together with its lazily computed integral images
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <algorithm>
+#include <bob.ip.base/PreparedImage.h>
+
+/** Computes the integral image with zero border, which also works for empty images */
+template <typename U>
+static void _integral(const blitz::Array<double,2>& src, blitz::Array<U,2>& dst){
+  dst.resize(src.extent(0)+1, src.extent(1)+1);
+  if (src.size()){
+    bob::ip::base::integral(src, dst, true);
+  } else {
+    dst = U(0);
+  }
+}
+
+const blitz::Array<double,2>& bob::ip::base::PreparedImage::getIntegral() const
+{
+  boost::mutex::scoped_lock lock(m_mutex);
+  if (!m_integral.size()) _integral(m_source, m_integral);
+  return m_integral;
+}
+
+const blitz::Array<double,2>& bob::ip::base::PreparedImage::getSquaredIntegral() const
+{
+  boost::mutex::scoped_lock lock(m_mutex);
+  if (!m_squaredIntegral.size()){
+    blitz::Array<double,2> squared(m_source.shape());
+    squared = blitz::sqr(m_source);
+    _integral(squared, m_squaredIntegral);
+  }
+  return m_squaredIntegral;
+}
+
+const blitz::Array<int64_t,2>& bob::ip::base::PreparedImage::getIntegerIntegral() const
+{
+  if (!m_isInteger)
+    throw std::runtime_error("The integer integral image can only be computed for images of integral type");
+  boost::mutex::scoped_lock lock(m_mutex);
+  // the source values are integral, so that the conversion to int64 is exact
+  if (!m_integerIntegral.size()) _integral(m_source, m_integerIntegral);
+  return m_integerIntegral;
+}
+
+void bob::ip::base::PreparedImage::checkBox(const int y, const int x, const int h, const int w) const
+{
+  if (y < 0 || x < 0 || h <= 0 || w <= 0 || y + h > m_source.extent(0) || x + w > m_source.extent(1))
+    throw std::runtime_error((boost::format("The box (%d, %d) of size (%d, %d) does not lie inside the image of shape (%d, %d)") % y % x % h % w % m_source.extent(0) % m_source.extent(1)).str());
+}
+
+double bob::ip::base::PreparedImage::boxSum(const int y, const int x, const int h, const int w) const
+{
+  checkBox(y, x, h, w);
+  if (m_isInteger){
+    const blitz::Array<int64_t,2>& ii = getIntegerIntegral();
+    return static_cast<double>(ii(y+h,x+w) + ii(y,x) - ii(y,x+w) - ii(y+h,x));
+  }
+  const blitz::Array<double,2>& ii = getIntegral();
+  return ii(y+h,x+w) + ii(y,x) - ii(y,x+w) - ii(y+h,x);
+}
+
+double bob::ip::base::PreparedImage::boxMean(const int y, const int x, const int h, const int w) const
+{
+  return boxSum(y, x, h, w) / (h * w);
+}
+
+double bob::ip::base::PreparedImage::boxVariance(const int y, const int x, const int h, const int w) const
+{
+  const double mean = boxMean(y, x, h, w);
+  const blitz::Array<double,2>& sq = getSquaredIntegral();
+  const double squared_mean = (sq(y+h,x+w) + sq(y,x) - sq(y,x+w) - sq(y+h,x)) / (h * w);
+  // avoid negative variances caused by rounding errors
+  return std::max(squared_mean - mean * mean, 0.);
+}
@@ -0,0 +1,106 @@
+/**
+ * @date Fri Oct 16 15:04:12 CEST 2026
+ *
+ * This file defines a class to apply the same affine transformation to many images using a pre-computed coordinate map
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <bob.ip.base/Remap.h>
+
+bob::ip::base::Remap::Remap(
+    const blitz::Array<double,2>& matrix,
+    const blitz::TinyVector<int,2>& src_shape,
+    const blitz::TinyVector<int,2>& dst_shape
+):
+  m_matrix(2,3),
+  m_srcShape(src_shape),
+  m_dstShape(dst_shape)
+{
+  if (matrix.extent(0) != 2 || matrix.extent(1) != 3)
+    throw std::runtime_error((boost::format("The transformation matrix must be of shape (2, 3), but it is (%d, %d)") % matrix.extent(0) % matrix.extent(1)).str());
+  for (int i = 0; i < 2; ++i)
+    for (int j = 0; j < 3; ++j)
+      m_matrix(i,j) = matrix(matrix.lbound(0) + i, matrix.lbound(1) + j);
+  init();
+}
+
+bob::ip::base::Remap::Remap(
+    const GeomNorm& geomNorm,
+    const blitz::TinyVector<double,2>& center,
+    const blitz::TinyVector<int,2>& src_shape
+):
+  m_matrix(2,3),
+  m_srcShape(src_shape),
+  m_dstShape(geomNorm.getCropSize())
+{
+  // the same mapping from the target to the source image as computed by bob::ip::base::transform
+  const double sin_angle = -sin(geomNorm.getRotationAngle() * M_PI / 180.),
+               cos_angle = cos(geomNorm.getRotationAngle() * M_PI / 180.);
+  const double scale = geomNorm.getScalingFactor();
+  const blitz::TinyVector<double,2>& offset = geomNorm.getCropOffset();
+
+  m_matrix = cos_angle / scale, -sin_angle / scale, center[0] - (offset[0] * cos_angle - offset[1] * sin_angle) / scale,
+             sin_angle / scale, cos_angle / scale, center[1] - (offset[1] * cos_angle + offset[0] * sin_angle) / scale;
+  init();
+}
+
+void bob::ip::base::Remap::init()
+{
+  const int height = m_srcShape[0], width = m_srcShape[1];
+  const double quantization = 1 << s_bits;
+
+  m_rowBegin.resize(m_dstShape[0]);
+  m_rowEnd.resize(m_dstShape[0]);
+  m_interior.clear();
+  m_border.clear();
+
+  std::vector<int> oy(m_dstShape[1]), ox(m_dstShape[1]), qy(m_dstShape[1]), qx(m_dstShape[1]);
+  for (int y = 0; y < m_dstShape[0]; ++y){
+    // compute and quantize the source positions of the row
+    for (int x = 0; x < m_dstShape[1]; ++x){
+      const double source_y = m_matrix(0,0) * y + m_matrix(0,1) * x + m_matrix(0,2);
+      const double source_x = m_matrix(1,0) * y + m_matrix(1,1) * x + m_matrix(1,2);
+      oy[x] = static_cast<int>(std::floor(source_y));
+      ox[x] = static_cast<int>(std::floor(source_x));
+      qy[x] = static_cast<int>((source_y - oy[x]) * quantization + .5);
+      qx[x] = static_cast<int>((source_x - ox[x]) * quantization + .5);
+      // a weight that is rounded up to 1 belongs to the next pixel
+      if (qy[x] == quantization){ ++oy[x]; qy[x] = 0; }
+      if (qx[x] == quantization){ ++ox[x]; qx[x] = 0; }
+    }
+
+    // the interior is the first sequence of pixels, for which all four source pixels lie inside the source image
+    int begin = 0;
+    while (begin < m_dstShape[1] && !(oy[begin] >= 0 && ox[begin] >= 0 && oy[begin] < height-1 && ox[begin] < width-1))
+      ++begin;
+    int end = begin;
+    while (end < m_dstShape[1] && oy[end] >= 0 && ox[end] >= 0 && oy[end] < height-1 && ox[end] < width-1)
+      ++end;
+    m_rowBegin[y] = begin;
+    m_rowEnd[y] = end;
+
+    for (int x = 0; x < m_dstShape[1]; ++x){
+      if (x >= begin && x < end){
+        Entry entry;
+        entry.offset = oy[x] * width + ox[x];
+        entry.wy = static_cast<uint16_t>(qy[x]);
+        entry.wx = static_cast<uint16_t>(qx[x]);
+        m_interior.push_back(entry);
+      } else {
+        // check each of the four source pixels
+        const double my = qy[x] / quantization, mx = qx[x] / quantization;
+        const int pos_y[] = {oy[x], oy[x], oy[x]+1, oy[x]+1};
+        const int pos_x[] = {ox[x], ox[x]+1, ox[x], ox[x]+1};
+        const double weight[] = {(1.-my) * (1.-mx), (1.-my) * mx, my * (1.-mx), my * mx};
+        BorderEntry entry;
+        for (int i = 0; i < 4; ++i){
+          const bool inside = pos_y[i] >= 0 && pos_y[i] < height && pos_x[i] >= 0 && pos_x[i] < width;
+          entry.offset[i] = inside ? pos_y[i] * width + pos_x[i] : 0;
+          entry.weight[i] = inside ? weight[i] : 0.;
+        }
+        m_border.push_back(entry);
+      }
+    }
+  }
+}
@@ -344,7 +344,7 @@ static auto extract = bob::extension::FunctionDoc(
 .add_prototype("input, output, right_eye, left_eye")
 .add_prototype("input, input_mask, output, output_mask, right_eye, left_eye")
 .add_parameter("input", "array_like (2D or 3D)", "The input image to which FaceEyesNorm should be applied")
-.add_parameter("output", "array_like (2D or 3D, float)", "The output image, which must be of size :py:attr:`crop_size`")
+.add_parameter("output", "array_like (2D or 3D, float or same type as ``input``)", "The output image, which must be of size :py:attr:`crop_size`; can be of type numpy.float64, numpy.float32 or of the same type as ``input``, in which case the values are rounded")
 .add_parameter("right_eye", "(float, float)", "The position of the right eye (or another landmark) in ``input`` image coordinates.")
 .add_parameter("left_eye", "(float, float)", "The position of the left eye (or another landmark) in ``input`` image coordinates.")
 .add_parameter("input_mask", "array_like (2D, bool)", "An input mask of valid pixels before geometric normalization, must be of same size as ``input``")
@@ -352,13 +352,13 @@ static auto extract = bob::extension::FunctionDoc(
 .add_return("output", "array_like(2D or 3D, float)", "The resulting normalized face image, which is of size :py:attr:`crop_size`")
 ;
 
-template <typename T>
+template <typename T, typename U>
 static void extract_inner(PyBobIpBaseFaceEyesNormObject* self, PyBlitzArrayObject* input, PyBlitzArrayObject* input_mask, PyBlitzArrayObject* output, PyBlitzArrayObject* output_mask, const blitz::TinyVector<double,2>& right, const blitz::TinyVector<double,2>& left){
   if (input->ndim == 3){
     auto a = blitz::Range::all();
     for (int i = 0; i < input->shape[0]; ++i){
       const blitz::Array<T,2> in = (*PyBlitzArrayCxx_AsBlitz<T,3>(input))(i,a,a);
-      blitz::Array<double,2> out = (*PyBlitzArrayCxx_AsBlitz<double,3>(output))(i,a,a);
+      blitz::Array<U,2> out = (*PyBlitzArrayCxx_AsBlitz<U,3>(output))(i,a,a);
       if (input_mask && output_mask){
         self->cxx->extract(in, *PyBlitzArrayCxx_AsBlitz<bool,2>(input_mask), out, *PyBlitzArrayCxx_AsBlitz<bool,2>(output_mask), right, left);
       } else {
@@ -367,13 +367,23 @@ static void extract_inner(PyBobIpBaseFaceEyesNormObject* self, PyBlitzArrayObjec
     }
   } else {
     if (input_mask && output_mask){
-      self->cxx->extract(*PyBlitzArrayCxx_AsBlitz<T,2>(input), *PyBlitzArrayCxx_AsBlitz<bool,2>(input_mask), *PyBlitzArrayCxx_AsBlitz<double,2>(output), *PyBlitzArrayCxx_AsBlitz<bool,2>(output_mask), right, left);
+      self->cxx->extract(*PyBlitzArrayCxx_AsBlitz<T,2>(input), *PyBlitzArrayCxx_AsBlitz<bool,2>(input_mask), *PyBlitzArrayCxx_AsBlitz<U,2>(output), *PyBlitzArrayCxx_AsBlitz<bool,2>(output_mask), right, left);
     } else {
-      self->cxx->extract(*PyBlitzArrayCxx_AsBlitz<T,2>(input), *PyBlitzArrayCxx_AsBlitz<double,2>(output), right, left);
+      self->cxx->extract(*PyBlitzArrayCxx_AsBlitz<T,2>(input), *PyBlitzArrayCxx_AsBlitz<U,2>(output), right, left);
     }
   }
 }
 
+template <typename T>
+static void extract_typed(PyBobIpBaseFaceEyesNormObject* self, PyBlitzArrayObject* input, PyBlitzArrayObject* input_mask, PyBlitzArrayObject* output, PyBlitzArrayObject* output_mask, const blitz::TinyVector<double,2>& right, const blitz::TinyVector<double,2>& left){
+  switch (output->type_num){
+    case NPY_FLOAT64: extract_inner<T,double>(self, input, input_mask, output, output_mask, right, left); break;
+    case NPY_FLOAT32: extract_inner<T,float>(self, input, input_mask, output, output_mask, right, left); break;
+    // otherwise, the output is of the same type as the input
+    default:          extract_inner<T,T>(self, input, input_mask, output, output_mask, right, left);
+  }
+}
+
 static PyObject* PyBobIpBaseFaceEyesNorm_extract(PyBobIpBaseFaceEyesNormObject* self, PyObject* args, PyObject* kwargs) {
   BOB_TRY
   char** kwlist1 = extract.kwlist(0);
@@ -434,9 +444,9 @@ static PyObject* PyBobIpBaseFaceEyesNorm_extract(PyBobIpBaseFaceEyesNormObject*
       PyErr_Format(PyExc_TypeError, "'%s' the 'output' array must have the same number of dimensions as 'input' (2D or 3D)", Py_TYPE(self)->tp_name);
       return 0;
     }
-    if (output->type_num != NPY_FLOAT64){
+    if (output->type_num != NPY_FLOAT64 && output->type_num != NPY_FLOAT32 && output->type_num != input->type_num){
       extract.print_usage();
-      PyErr_Format(PyExc_TypeError, "'%s': the 'output' array must be of type float64", Py_TYPE(self)->tp_name);
+      PyErr_Format(PyExc_TypeError, "'%s': the 'output' array must be of type float64, float32 or of the same type as the 'input' array", Py_TYPE(self)->tp_name);
       return 0;
     }
   } else {
@@ -467,9 +477,9 @@ static PyObject* PyBobIpBaseFaceEyesNorm_extract(PyBobIpBaseFaceEyesNormObject*
 
   // finally, process the data
   switch (input->type_num){
-    case NPY_UINT8:   extract_inner<uint8_t>(self, input, input_mask, output, output_mask, right, left); break;
-    case NPY_UINT16:  extract_inner<uint16_t>(self, input, input_mask, output, output_mask, right, left); break;
-    case NPY_FLOAT64: extract_inner<double>(self, input, input_mask, output, output_mask, right, left); break;
+    case NPY_UINT8:   extract_typed<uint8_t>(self, input, input_mask, output, output_mask, right, left); break;
+    case NPY_UINT16:  extract_typed<uint16_t>(self, input, input_mask, output, output_mask, right, left); break;
+    case NPY_FLOAT64: extract_typed<double>(self, input, input_mask, output, output_mask, right, left); break;
     default:
       PyErr_Format(PyExc_TypeError, "`%s' input array of type %s are currently not supported", Py_TYPE(self)->tp_name, PyBlitzArray_TypenumAsString(input->type_num));
       extract.print_usage();
@@ -485,6 +495,139 @@ static PyObject* PyBobIpBaseFaceEyesNorm_extract(PyBobIpBaseFaceEyesNormObject*
   BOB_CATCH_MEMBER("cannot extract face from image", 0)
 }
 
+static auto extractBatch = bob::extension::FunctionDoc(
+  "extract_batch",
+  "This function extracts and normalizes several faces of the same image at once",
+  "The eye positions of the ``k``'th face are given in ``eyes[k]`` as ``(right_y, right_x, left_y, left_x)``, and the normalized face is written to ``output[k]``. "
+  "Each face is identical to the result of :py:func:`extract` with the corresponding eye positions.\n\n"
+  "The faces are distributed over ``n_threads`` threads, and the global interpreter lock is released while processing. "
+  "Contrary to :py:func:`extract`, this function does not modify :py:attr:`last_angle`, :py:attr:`last_scale` and :py:attr:`last_offset`; "
+  "instead, the parameters that were used for each face are returned.",
+  true
+)
+.add_prototype("input, eyes, [output], [input_mask], [output_mask], [n_threads]", "output, parameters")
+.add_parameter("input", "array_like (2D)", "The input image from which the faces should be extracted")
+.add_parameter("eyes", "array_like (2D, float)", "The eye positions in ``input`` image coordinates, an array of shape ``(N, 4)``")
+.add_parameter("output", "array_like (3D, float or same type as ``input``)", "[default: ``None``] If given, the output stack of shape ``(N, crop_size[0], crop_size[1])``; can be of type numpy.float64, numpy.float32 or of the same type as ``input``, in which case the values are rounded")
+.add_parameter("input_mask", "array_like (2D, bool)", "[default: ``None``] An input mask of valid pixels before geometric normalization, must be of same size as ``input``")
+.add_parameter("output_mask", "array_like (3D, bool)", "[default: ``None``] The output masks of valid pixels after geometric normalization, must be of same size as ``output``; required when ``input_mask`` is given")
+.add_parameter("n_threads", "int", "[default: 1] The number of threads to use; if 0 or negative, all hardware threads are used")
+.add_return("output", "array_like (3D)", "The normalized faces, of type numpy.float64 if not given as parameter")
+.add_return("parameters", "array_like (2D, float)", "The ``(angle, scale, offset_y, offset_x)`` of the geometric normalization of each face, an array of shape ``(N, 4)``")
+;
+
+template <typename T, typename U>
+static void extract_batch_inner(PyBobIpBaseFaceEyesNormObject* self, PyBlitzArrayObject* input, PyBlitzArrayObject* input_mask, PyBlitzArrayObject* output, PyBlitzArrayObject* output_mask, PyBlitzArrayObject* eyes, PyBlitzArrayObject* parameters, const int n_threads){
+  const blitz::Array<T,2>& src = *PyBlitzArrayCxx_AsBlitz<T,2>(input);
+  blitz::Array<U,3>& dst = *PyBlitzArrayCxx_AsBlitz<U,3>(output);
+  const blitz::Array<double,2>& e = *PyBlitzArrayCxx_AsBlitz<double,2>(eyes);
+  blitz::Array<double,2>& p = *PyBlitzArrayCxx_AsBlitz<double,2>(parameters);
+  if (input_mask && output_mask){
+    const blitz::Array<bool,2>& src_mask = *PyBlitzArrayCxx_AsBlitz<bool,2>(input_mask);
+    blitz::Array<bool,3>& dst_mask = *PyBlitzArrayCxx_AsBlitz<bool,3>(output_mask);
+    ReleaseGIL gil;
+    self->cxx->extract(src, src_mask, dst, dst_mask, e, p, n_threads);
+  } else {
+    ReleaseGIL gil;
+    self->cxx->extract(src, dst, e, p, n_threads);
+  }
+}
+
+template <typename T>
+static void extract_batch_typed(PyBobIpBaseFaceEyesNormObject* self, PyBlitzArrayObject* input, PyBlitzArrayObject* input_mask, PyBlitzArrayObject* output, PyBlitzArrayObject* output_mask, PyBlitzArrayObject* eyes, PyBlitzArrayObject* parameters, const int n_threads){
+  switch (output->type_num){
+    case NPY_FLOAT64: extract_batch_inner<T,double>(self, input, input_mask, output, output_mask, eyes, parameters, n_threads); break;
+    case NPY_FLOAT32: extract_batch_inner<T,float>(self, input, input_mask, output, output_mask, eyes, parameters, n_threads); break;
+    // otherwise, the output is of the same type as the input
+    default:          extract_batch_inner<T,T>(self, input, input_mask, output, output_mask, eyes, parameters, n_threads);
+  }
+}
+
+static PyObject* PyBobIpBaseFaceEyesNorm_extractBatch(PyBobIpBaseFaceEyesNormObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+  char** kwlist = extractBatch.kwlist(0);
+
+  PyBlitzArrayObject* input = 0,* eyes = 0,* output = 0,* input_mask = 0,* output_mask = 0;
+  int n_threads = 1;
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&O&|O&O&O&i", kwlist, &PyBlitzArray_Converter, &input, &PyBlitzArray_Converter, &eyes, &PyBlitzArray_OutputConverter, &output, &PyBlitzArray_Converter, &input_mask, &PyBlitzArray_OutputConverter, &output_mask, &n_threads)){
+    extractBatch.print_usage();
+    return 0;
+  }
+
+  auto input_ = make_safe(input), eyes_ = make_safe(eyes), output_ = make_xsafe(output);
+  auto input_mask_ = make_xsafe(input_mask), output_mask_ = make_xsafe(output_mask);
+
+  if (input->ndim != 2){
+    extractBatch.print_usage();
+    PyErr_Format(PyExc_TypeError, "'%s' extract_batch can only normalize faces in 2D images", Py_TYPE(self)->tp_name);
+    return 0;
+  }
+  if (eyes->ndim != 2 || eyes->type_num != NPY_FLOAT64 || eyes->shape[1] != 4){
+    extractBatch.print_usage();
+    PyErr_Format(PyExc_TypeError, "'%s' the 'eyes' must be a 2D array of type float64 and shape (N, 4)", Py_TYPE(self)->tp_name);
+    return 0;
+  }
+
+  auto shape = self->cxx->getCropSize();
+  if (output){
+    // check that data type is correct and dimensions fit
+    if (output->ndim != 3){
+      extractBatch.print_usage();
+      PyErr_Format(PyExc_TypeError, "'%s' the 'output' array must be 3D", Py_TYPE(self)->tp_name);
+      return 0;
+    }
+    if (output->type_num != NPY_FLOAT64 && output->type_num != NPY_FLOAT32 && output->type_num != input->type_num){
+      extractBatch.print_usage();
+      PyErr_Format(PyExc_TypeError, "'%s': the 'output' array must be of type float64, float32 or of the same type as the 'input' array", Py_TYPE(self)->tp_name);
+      return 0;
+    }
+  } else {
+    // create output in the desired dimensions
+    Py_ssize_t n[] = {eyes->shape[0], shape[0], shape[1]};
+    output = reinterpret_cast<PyBlitzArrayObject*>(PyBlitzArray_SimpleNew(NPY_FLOAT64, 3, n));
+    output_ = make_safe(output);
+  }
+
+  if (input_mask || output_mask){
+    if (!input_mask || !output_mask){
+      PyErr_Format(PyExc_TypeError, "`%s' requires both or none of the input and output masks", Py_TYPE(self)->tp_name);
+      extractBatch.print_usage();
+      return 0;
+    }
+    if (input_mask->ndim != 2 || output_mask->ndim != 3){
+      PyErr_Format(PyExc_TypeError, "`%s' the input mask must be 2D and the output mask must be 3D, with the same shape as the input or output matrix", Py_TYPE(self)->tp_name);
+      extractBatch.print_usage();
+      return 0;
+    }
+    if (input_mask->type_num != NPY_BOOL || output_mask->type_num != NPY_BOOL){
+      PyErr_Format(PyExc_TypeError, "`%s' masks must be of boolean type", Py_TYPE(self)->tp_name);
+      extractBatch.print_usage();
+      return 0;
+    }
+  }
+
+  // create the parameters
+  Py_ssize_t n[] = {eyes->shape[0], 4};
+  PyBlitzArrayObject* parameters = reinterpret_cast<PyBlitzArrayObject*>(PyBlitzArray_SimpleNew(NPY_FLOAT64, 2, n));
+  auto parameters_ = make_safe(parameters);
+
+  // finally, process the data
+  switch (input->type_num){
+    case NPY_UINT8:   extract_batch_typed<uint8_t>(self, input, input_mask, output, output_mask, eyes, parameters, n_threads); break;
+    case NPY_UINT16:  extract_batch_typed<uint16_t>(self, input, input_mask, output, output_mask, eyes, parameters, n_threads); break;
+    case NPY_FLOAT64: extract_batch_typed<double>(self, input, input_mask, output, output_mask, eyes, parameters, n_threads); break;
+    default:
+      PyErr_Format(PyExc_TypeError, "`%s' input array of type %s are currently not supported", Py_TYPE(self)->tp_name, PyBlitzArray_TypenumAsString(input->type_num));
+      extractBatch.print_usage();
+      return 0;
+  }
+
+  return Py_BuildValue("(NN)", PyBlitzArray_AsNumpyArray(output,0), PyBlitzArray_AsNumpyArray(parameters,0));
+
+  BOB_CATCH_MEMBER("cannot extract faces from image", 0)
+}
+
 static PyMethodDef PyBobIpBaseFaceEyesNorm_methods[] = {
   {
     extract.name(),
@@ -492,6 +635,12 @@ static PyMethodDef PyBobIpBaseFaceEyesNorm_methods[] = {
     METH_VARARGS|METH_KEYWORDS,
     extract.doc()
   },
+  {
+    extractBatch.name(),
+    (PyCFunction)PyBobIpBaseFaceEyesNorm_extractBatch,
+    METH_VARARGS|METH_KEYWORDS,
+    extractBatch.doc()
+  },
   {0} /* Sentinel */
 };
 
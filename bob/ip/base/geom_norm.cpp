@@ -244,7 +244,7 @@ static auto process = bob::extension::FunctionDoc(
 .add_prototype("input, input_mask, output, output_mask, center")
 .add_prototype("position, center", "transformed")
 .add_parameter("input", "array_like (2D or 3D)", "The input image to which GeomNorm should be applied")
-.add_parameter("output", "array_like (2D or 3D, float)", "The output image, which must be of size :py:attr:`crop_size`")
+.add_parameter("output", "array_like (2D or 3D, float or same type as ``input``)", "The output image, which must be of size :py:attr:`crop_size`; can be of type numpy.float64, numpy.float32 or of the same type as ``input``, in which case the values are rounded")
 .add_parameter("center", "(float, float)", "The transformation center in the given image; this will be placed to :py:attr:`crop_offset` in the output image")
 .add_parameter("input_mask", "array_like (bool, 2D or 3D)", "An input mask of valid pixels before geometric normalization, must be of same size as ``input``")
 .add_parameter("output_mask", "array_like (bool, 2D or 3D)", "The output mask of valid pixels after geometric normalization, must be of same size as ``output``")
@@ -252,12 +252,22 @@ static auto process = bob::extension::FunctionDoc(
 .add_return("transformed", "uint16", "The resulting GeomNorm code at the given position in the image")
 ;
 
-template <typename T>
-static PyObject* process_inner(PyBobIpBaseGeomNormObject* self, PyBlitzArrayObject* input, PyBlitzArrayObject* input_mask, PyBlitzArrayObject* output, PyBlitzArrayObject* output_mask, const blitz::TinyVector<double,2>& offset){
+template <typename T, typename U, int D>
+static void process_inner(PyBobIpBaseGeomNormObject* self, PyBlitzArrayObject* input, PyBlitzArrayObject* input_mask, PyBlitzArrayObject* output, PyBlitzArrayObject* output_mask, const blitz::TinyVector<double,2>& offset){
   if (input_mask && output_mask){
-    self->cxx->process(*PyBlitzArrayCxx_AsBlitz<T,2>(input), *PyBlitzArrayCxx_AsBlitz<bool,2>(input_mask), *PyBlitzArrayCxx_AsBlitz<double,2>(output), *PyBlitzArrayCxx_AsBlitz<bool,2>(output_mask), offset);
+    self->cxx->process(*PyBlitzArrayCxx_AsBlitz<T,D>(input), *PyBlitzArrayCxx_AsBlitz<bool,D>(input_mask), *PyBlitzArrayCxx_AsBlitz<U,D>(output), *PyBlitzArrayCxx_AsBlitz<bool,D>(output_mask), offset);
   } else {
-    self->cxx->process(*PyBlitzArrayCxx_AsBlitz<T,2>(input), *PyBlitzArrayCxx_AsBlitz<double,2>(output), offset);
+    self->cxx->process(*PyBlitzArrayCxx_AsBlitz<T,D>(input), *PyBlitzArrayCxx_AsBlitz<U,D>(output), offset);
+  }
+}
+
+template <typename T>
+static PyObject* process_typed(PyBobIpBaseGeomNormObject* self, PyBlitzArrayObject* input, PyBlitzArrayObject* input_mask, PyBlitzArrayObject* output, PyBlitzArrayObject* output_mask, const blitz::TinyVector<double,2>& offset){
+  switch (output->type_num){
+    case NPY_FLOAT64: if (input->ndim == 2) process_inner<T,double,2>(self, input, input_mask, output, output_mask, offset); else process_inner<T,double,3>(self, input, input_mask, output, output_mask, offset); break;
+    case NPY_FLOAT32: if (input->ndim == 2) process_inner<T,float,2>(self, input, input_mask, output, output_mask, offset);  else process_inner<T,float,3>(self, input, input_mask, output, output_mask, offset); break;
+    // otherwise, the output is of the same type as the input
+    default:          if (input->ndim == 2) process_inner<T,T,2>(self, input, input_mask, output, output_mask, offset);      else process_inner<T,T,3>(self, input, input_mask, output, output_mask, offset);
   }
   Py_RETURN_NONE;
 }
@@ -322,8 +332,8 @@ static PyObject* PyBobIpBaseGeomNorm_process(PyBobIpBaseGeomNormObject* self, Py
     process.print_usage();
     return 0;
   }
-  if (output->type_num != NPY_FLOAT64){
-    PyErr_Format(PyExc_TypeError, "`%s' processes only output arrays of type float", Py_TYPE(self)->tp_name);
+  if (output->type_num != NPY_FLOAT64 && output->type_num != NPY_FLOAT32 && output->type_num != input->type_num){
+    PyErr_Format(PyExc_TypeError, "`%s' processes only output arrays of type float64, float32 or of the same type as the input array", Py_TYPE(self)->tp_name);
     process.print_usage();
     return 0;
   }
@@ -343,9 +353,9 @@ static PyObject* PyBobIpBaseGeomNorm_process(PyBobIpBaseGeomNormObject* self, Py
 
   // finally, process the data
   switch (input->type_num){
-    case NPY_UINT8:   return process_inner<uint8_t>(self, input, input_mask, output, output_mask, center);
-    case NPY_UINT16:  return process_inner<uint16_t>(self, input, input_mask, output, output_mask, center);
-    case NPY_FLOAT64: return process_inner<double>(self, input, input_mask, output, output_mask, center);
+    case NPY_UINT8:   return process_typed<uint8_t>(self, input, input_mask, output, output_mask, center);
+    case NPY_UINT16:  return process_typed<uint16_t>(self, input, input_mask, output, output_mask, center);
+    case NPY_FLOAT64: return process_typed<double>(self, input, input_mask, output, output_mask, center);
     default:
       PyErr_Format(PyExc_TypeError, "`%s' input array of type %s are currently not supported", Py_TYPE(self)->tp_name, PyBlitzArray_TypenumAsString(input->type_num));
       process.print_usage();
@@ -355,6 +365,114 @@ static PyObject* PyBobIpBaseGeomNorm_process(PyBobIpBaseGeomNormObject* self, Py
   BOB_CATCH_MEMBER("cannot process image", 0)
 }
 
+static auto processBatch = bob::extension::FunctionDoc(
+  "process_batch",
+  "This function geometrically normalizes several crops of the same image at once",
+  "The ``k``'th crop is centered at ``centers[k]`` in the ``input`` image and is written to ``output[k]``. "
+  "By default, all crops are rotated and scaled with :py:attr:`rotation_angle` and :py:attr:`scaling_factor`; "
+  "when ``angles`` or ``scales`` are given, they define the rotation angle (in degrees) and the scaling factor of each crop instead. "
+  "The result of each crop is identical to calling :py:func:`process` with the corresponding center, angle and scaling factor.\n\n"
+  "The crops are distributed over ``n_threads`` threads, and the global interpreter lock is released while processing.",
+  true
+)
+.add_prototype("input, centers, [angles], [scales], [output], [n_threads]", "output")
+.add_parameter("input", "array_like (2D)", "The input image from which the crops should be extracted")
+.add_parameter("centers", "array_like (2D, float)", "The transformation centers in the input image, an array of shape ``(N, 2)``; each center will be placed to :py:attr:`crop_offset` in its crop")
+.add_parameter("angles", "array_like (1D, float)", "[default: :py:attr:`rotation_angle` for all crops] The rotation angles in degrees, an array of shape ``(N,)``")
+.add_parameter("scales", "array_like (1D, float)", "[default: :py:attr:`scaling_factor` for all crops] The scaling factors, an array of shape ``(N,)``")
+.add_parameter("output", "array_like (3D, float or same type as ``input``)", "[default: ``None``] If given, the output stack of shape ``(N, crop_size[0], crop_size[1])``; can be of type numpy.float64, numpy.float32 or of the same type as ``input``, in which case the values are rounded")
+.add_parameter("n_threads", "int", "[default: 1] The number of threads to use; if 0 or negative, all hardware threads are used")
+.add_return("output", "array_like (3D)", "The output stack, of type numpy.float64 if not given as parameter")
+;
+
+template <typename T, typename U>
+static void process_batch_inner(PyBobIpBaseGeomNormObject* self, PyBlitzArrayObject* input, PyBlitzArrayObject* output, PyBlitzArrayObject* centers, PyBlitzArrayObject* angles, PyBlitzArrayObject* scales, const int n_threads){
+  const blitz::Array<double,1> empty;
+  const blitz::Array<T,2>& src = *PyBlitzArrayCxx_AsBlitz<T,2>(input);
+  blitz::Array<U,3>& dst = *PyBlitzArrayCxx_AsBlitz<U,3>(output);
+  const blitz::Array<double,2>& c = *PyBlitzArrayCxx_AsBlitz<double,2>(centers);
+  const blitz::Array<double,1>& a = angles ? *PyBlitzArrayCxx_AsBlitz<double,1>(angles) : empty;
+  const blitz::Array<double,1>& s = scales ? *PyBlitzArrayCxx_AsBlitz<double,1>(scales) : empty;
+  ReleaseGIL gil;
+  self->cxx->process(src, dst, c, a, s, n_threads);
+}
+
+template <typename T>
+static void process_batch_typed(PyBobIpBaseGeomNormObject* self, PyBlitzArrayObject* input, PyBlitzArrayObject* output, PyBlitzArrayObject* centers, PyBlitzArrayObject* angles, PyBlitzArrayObject* scales, const int n_threads){
+  switch (output->type_num){
+    case NPY_FLOAT64: process_batch_inner<T,double>(self, input, output, centers, angles, scales, n_threads); break;
+    case NPY_FLOAT32: process_batch_inner<T,float>(self, input, output, centers, angles, scales, n_threads); break;
+    // otherwise, the output is of the same type as the input
+    default:          process_batch_inner<T,T>(self, input, output, centers, angles, scales, n_threads);
+  }
+}
+
+static PyObject* PyBobIpBaseGeomNorm_processBatch(PyBobIpBaseGeomNormObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+  char** kwlist = processBatch.kwlist(0);
+
+  PyBlitzArrayObject* input = 0,* centers = 0,* angles = 0,* scales = 0,* output = 0;
+  int n_threads = 1;
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&O&|O&O&O&i", kwlist, &PyBlitzArray_Converter, &input, &PyBlitzArray_Converter, &centers, &PyBlitzArray_Converter, &angles, &PyBlitzArray_Converter, &scales, &PyBlitzArray_OutputConverter, &output, &n_threads)){
+    processBatch.print_usage();
+    return 0;
+  }
+
+  auto input_ = make_safe(input), centers_ = make_safe(centers);
+  auto angles_ = make_xsafe(angles), scales_ = make_xsafe(scales), output_ = make_xsafe(output);
+
+  // perform checks on input and output image
+  if (input->ndim != 2){
+    PyErr_Format(PyExc_TypeError, "`%s' process_batch only processes 2D arrays", Py_TYPE(self)->tp_name);
+    processBatch.print_usage();
+    return 0;
+  }
+  if (centers->ndim != 2 || centers->type_num != NPY_FLOAT64 || centers->shape[1] != 2){
+    PyErr_Format(PyExc_TypeError, "`%s' process_batch requires the centers to be a 2D array of type float64 and shape (N, 2)", Py_TYPE(self)->tp_name);
+    processBatch.print_usage();
+    return 0;
+  }
+  if ((angles && (angles->ndim != 1 || angles->type_num != NPY_FLOAT64 || angles->shape[0] != centers->shape[0])) ||
+      (scales && (scales->ndim != 1 || scales->type_num != NPY_FLOAT64 || scales->shape[0] != centers->shape[0]))){
+    PyErr_Format(PyExc_TypeError, "`%s' process_batch requires the angles and scales to be 1D arrays of type float64 with one entry per center", Py_TYPE(self)->tp_name);
+    processBatch.print_usage();
+    return 0;
+  }
+
+  if (output){
+    if (output->ndim != 3){
+      PyErr_Format(PyExc_TypeError, "`%s' process_batch requires the output to be a 3D array", Py_TYPE(self)->tp_name);
+      processBatch.print_usage();
+      return 0;
+    }
+    if (output->type_num != NPY_FLOAT64 && output->type_num != NPY_FLOAT32 && output->type_num != input->type_num){
+      PyErr_Format(PyExc_TypeError, "`%s' processes only output arrays of type float64, float32 or of the same type as the input array", Py_TYPE(self)->tp_name);
+      processBatch.print_usage();
+      return 0;
+    }
+  } else {
+    Py_ssize_t n[] = {centers->shape[0], self->cxx->getCropSize()[0], self->cxx->getCropSize()[1]};
+    output = reinterpret_cast<PyBlitzArrayObject*>(PyBlitzArray_SimpleNew(NPY_FLOAT64, 3, n));
+    output_ = make_safe(output);
+  }
+
+  // finally, process the data
+  switch (input->type_num){
+    case NPY_UINT8:   process_batch_typed<uint8_t>(self, input, output, centers, angles, scales, n_threads); break;
+    case NPY_UINT16:  process_batch_typed<uint16_t>(self, input, output, centers, angles, scales, n_threads); break;
+    case NPY_FLOAT64: process_batch_typed<double>(self, input, output, centers, angles, scales, n_threads); break;
+    default:
+      PyErr_Format(PyExc_TypeError, "`%s' input array of type %s are currently not supported", Py_TYPE(self)->tp_name, PyBlitzArray_TypenumAsString(input->type_num));
+      processBatch.print_usage();
+      return 0;
+  }
+
+  return PyBlitzArray_AsNumpyArray(output, 0);
+
+  BOB_CATCH_MEMBER("cannot process batch of images", 0)
+}
+
 static PyMethodDef PyBobIpBaseGeomNorm_methods[] = {
   {
     process.name(),
@@ -362,6 +480,12 @@ static PyMethodDef PyBobIpBaseGeomNorm_methods[] = {
     METH_VARARGS|METH_KEYWORDS,
     process.doc()
   },
+  {
+    processBatch.name(),
+    (PyCFunction)PyBobIpBaseGeomNorm_processBatch,
+    METH_VARARGS|METH_KEYWORDS,
+    processBatch.doc()
+  },
   {0} /* Sentinel */
 };
 
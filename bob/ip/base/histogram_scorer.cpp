@@ -0,0 +1,486 @@
+/**
+ * @date Sat Oct 17 18:42:17 CEST 2026
+ *
+ * @brief Binds the HistogramScorer class to python
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include "main.h"
+
+static inline bool f(PyObject* o){return o != 0 && PyObject_IsTrue(o) > 0;}  /* converts PyObject to bool and returns false if object is NULL */
+
+// Histogram measure
+static const std::map<std::string, bob::ip::base::HistogramMeasure> M = {{"chi_square",  bob::ip::base::HISTOGRAM_CHI_SQUARE}, {"intersection", bob::ip::base::HISTOGRAM_INTERSECTION}};
+static inline bob::ip::base::HistogramMeasure m(const std::string& o){  /* converts string to histogram measure */
+  auto it = M.find(o);
+  if (it == M.end()) throw std::runtime_error("The given histogram measure '" + o + "' is not known; choose one of ('chi_square', 'intersection')");
+  else return it->second;
+}
+static inline const std::string& m(bob::ip::base::HistogramMeasure o){            /* converts histogram measure to string */
+  for (auto it = M.begin(); it != M.end(); ++it) if (it->second == o) return it->first;
+  throw std::runtime_error("The given histogram measure is not known");
+}
+
+/******************************************************************/
+/************ Constructor Section *********************************/
+/******************************************************************/
+
+static auto HistogramScorer_doc = bob::extension::ClassDoc(
+  BOB_EXT_MODULE_PREFIX ".HistogramScorer",
+  "Compares histogram sequences, e.g., LBPHS features, to many enrolled templates",
+  "Histogram sequences of shape ``(#blocks, #bins)``, e.g., as computed by :py:func:`bob.ip.base.lbphs`, are enrolled as templates. "
+  "Afterward, a probe histogram sequence is compared to all templates in one call, e.g., for 1:N identification. "
+  "The score of a template is the weighted sum of the scores of the blocks, where the block weights are given in :py:attr:`weights`. "
+  "Two measures are implemented:\n\n"
+  "* ``'chi_square'``: the chi-square distance :math:`\\sum_i \\frac{(p_i - t_i)^2}{p_i + t_i}`, where lower scores are better\n"
+  "* ``'intersection'``: the histogram intersection :math:`\\sum_i \\min(p_i, t_i)`, where higher scores are better\n\n"
+  "In ``compact`` mode, templates are stored as 16 bit counts, which is suitable for LBPHS features that are not normalized; otherwise, they are stored as 32 bit floats. "
+  "Block scores are computed in single precision, and accumulated over the blocks in double precision."
+).add_constructor(
+  bob::extension::FunctionDoc(
+    "__init__",
+    "Creates an empty scorer for histogram sequences of the given shape",
+    0,
+    true
+  )
+  .add_prototype("histogram_shape, [measure], [compact]", "")
+  .add_parameter("histogram_shape", "(int, int)", "The shape ``(#blocks, #bins)`` of the histogram sequences, see :py:func:`bob.ip.base.lbphs_output_shape`")
+  .add_parameter("measure", "str", "[default: ``'chi_square'``] The measure to compare histograms, see :py:attr:`measure`")
+  .add_parameter("compact", "bool", "[default: ``True``] Store the templates as 16 bit counts? Otherwise they are stored as 32 bit floats")
+);
+
+
+static int PyBobIpBaseHistogramScorer_init(PyBobIpBaseHistogramScorerObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  char** kwlist = HistogramScorer_doc.kwlist(0);
+
+  blitz::TinyVector<int,2> shape;
+  const char* measure = "chi_square";
+  PyObject* compact = Py_True;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "(ii)|sO!", kwlist, &shape[0], &shape[1], &measure, &PyBool_Type, &compact)){
+    HistogramScorer_doc.print_usage();
+    return -1;
+  }
+
+  self->cxx.reset(new bob::ip::base::HistogramScorer(shape, m(measure), f(compact)));
+  return 0;
+
+  BOB_CATCH_MEMBER("cannot create HistogramScorer", -1)
+}
+
+static void PyBobIpBaseHistogramScorer_delete(PyBobIpBaseHistogramScorerObject* self) {
+  self->cxx.reset();
+  Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+int PyBobIpBaseHistogramScorer_Check(PyObject* o) {
+  return PyObject_IsInstance(o, reinterpret_cast<PyObject*>(&PyBobIpBaseHistogramScorer_Type));
+}
+
+static Py_ssize_t PyBobIpBaseHistogramScorer_len(PyBobIpBaseHistogramScorerObject* self) {
+  return self->cxx->getNumberOfTemplates();
+}
+
+
+/******************************************************************/
+/************ Variables Section ***********************************/
+/******************************************************************/
+
+static auto histogramShape = bob::extension::VariableDoc(
+  "histogram_shape",
+  "(int, int)",
+  "The shape ``(#blocks, #bins)`` of the histogram sequences, read access only"
+);
+PyObject* PyBobIpBaseHistogramScorer_getHistogramShape(PyBobIpBaseHistogramScorerObject* self, void*){
+  BOB_TRY
+  auto shape = self->cxx->getHistogramShape();
+  return Py_BuildValue("(ii)", shape[0], shape[1]);
+  BOB_CATCH_MEMBER("histogram_shape could not be read", 0)
+}
+
+static auto measure = bob::extension::VariableDoc(
+  "measure",
+  "str",
+  "The measure that is used to compare histograms (read and write access)",
+  "Possible values are: ('chi_square', 'intersection')"
+);
+PyObject* PyBobIpBaseHistogramScorer_getMeasure(PyBobIpBaseHistogramScorerObject* self, void*){
+  BOB_TRY
+  return Py_BuildValue("s", m(self->cxx->getMeasure()).c_str());
+  BOB_CATCH_MEMBER("measure could not be read", 0)
+}
+int PyBobIpBaseHistogramScorer_setMeasure(PyBobIpBaseHistogramScorerObject* self, PyObject* value, void*){
+  BOB_TRY
+  if (!PyString_Check(value)){
+    PyErr_Format(PyExc_RuntimeError, "%s %s expects an str", Py_TYPE(self)->tp_name, measure.name());
+    return -1;
+  }
+  self->cxx->setMeasure(m(PyString_AS_STRING(value)));
+  return 0;
+  BOB_CATCH_MEMBER("measure could not be set", -1)
+}
+
+static auto compact = bob::extension::VariableDoc(
+  "compact",
+  "bool",
+  "Are the templates stored as 16 bit counts (``True``) or as 32 bit floats (``False``)? Read access only"
+);
+PyObject* PyBobIpBaseHistogramScorer_getCompact(PyBobIpBaseHistogramScorerObject* self, void*){
+  BOB_TRY
+  if (self->cxx->isCompact()) Py_RETURN_TRUE;
+  else Py_RETURN_FALSE;
+  BOB_CATCH_MEMBER("compact could not be read", 0)
+}
+
+static auto weights = bob::extension::VariableDoc(
+  "weights",
+  "array_like (1D, float) or ``None``",
+  "The weights of the block scores (read and write access)",
+  "When ``None``, all blocks are weighted with 1; otherwise, one weight per block is required."
+);
+PyObject* PyBobIpBaseHistogramScorer_getWeights(PyBobIpBaseHistogramScorerObject* self, void*){
+  BOB_TRY
+  if (!self->cxx->getWeights().size()) Py_RETURN_NONE;
+  return PyBlitzArrayCxx_AsConstNumpy(self->cxx->getWeights());
+  BOB_CATCH_MEMBER("weights could not be read", 0)
+}
+int PyBobIpBaseHistogramScorer_setWeights(PyBobIpBaseHistogramScorerObject* self, PyObject* value, void*){
+  BOB_TRY
+  if (!value || value == Py_None){
+    self->cxx->setWeights(blitz::Array<double,1>());
+    return 0;
+  }
+  PyBlitzArrayObject* o;
+  if (!PyBlitzArray_Converter(value, &o)){
+    PyErr_Format(PyExc_RuntimeError, "%s %s expects a 1D array of floats", Py_TYPE(self)->tp_name, weights.name());
+    return -1;
+  }
+  auto o_ = make_safe(o);
+  auto b = PyBlitzArrayCxx_AsBlitz<double,1>(o, "weights");
+  if (!b) return -1;
+  self->cxx->setWeights(*b);
+  return 0;
+  BOB_CATCH_MEMBER("weights could not be set", -1)
+}
+
+static PyGetSetDef PyBobIpBaseHistogramScorer_getseters[] = {
+    {
+      histogramShape.name(),
+      (getter)PyBobIpBaseHistogramScorer_getHistogramShape,
+      0,
+      histogramShape.doc(),
+      0
+    },
+    {
+      measure.name(),
+      (getter)PyBobIpBaseHistogramScorer_getMeasure,
+      (setter)PyBobIpBaseHistogramScorer_setMeasure,
+      measure.doc(),
+      0
+    },
+    {
+      compact.name(),
+      (getter)PyBobIpBaseHistogramScorer_getCompact,
+      0,
+      compact.doc(),
+      0
+    },
+    {
+      weights.name(),
+      (getter)PyBobIpBaseHistogramScorer_getWeights,
+      (setter)PyBobIpBaseHistogramScorer_setWeights,
+      weights.doc(),
+      0
+    },
+    {0}  /* Sentinel */
+};
+
+
+/******************************************************************/
+/************ Functions Section ***********************************/
+/******************************************************************/
+
+// checks that the given array contains histogram sequences of a supported type
+static bool check_histograms(PyBobIpBaseHistogramScorerObject* self, PyBlitzArrayObject* histograms, const char* name, bool allow_3d){
+  if (histograms->ndim != 2 && (!allow_3d || histograms->ndim != 3)){
+    PyErr_Format(PyExc_TypeError, "`%s' requires %s to be a %s array, but it has %" PY_FORMAT_SIZE_T "d dimensions", Py_TYPE(self)->tp_name, name, allow_3d ? "2D or 3D" : "2D", histograms->ndim);
+    return false;
+  }
+  if (histograms->type_num != NPY_UINT16 && histograms->type_num != NPY_UINT64 && histograms->type_num != NPY_FLOAT64){
+    PyErr_Format(PyExc_TypeError, "`%s' requires %s to be of type uint16, uint64 or float, and not %s", Py_TYPE(self)->tp_name, name, PyBlitzArray_TypenumAsString(histograms->type_num));
+    return false;
+  }
+  return true;
+}
+
+static auto enroll = bob::extension::FunctionDoc(
+  "enroll",
+  "Enrolls one or several templates",
+  "The histogram sequences are appended to the stored templates, i.e., their indices are ``len(self)``, ``len(self) + 1``, ... "
+  "All histogram values need to be finite; in :py:attr:`compact` mode, they need to be integral values in range ``[0, 65535]``, so normalized histograms require ``compact=False``. "
+  "Otherwise, a ``RuntimeError`` is raised, and no template is enrolled.\n\n"
+  "The global interpreter lock is released during the enrollment; scorings from other threads wait until the enrollment is finished.",
+  true
+)
+.add_prototype("histograms")
+.add_parameter("histograms", "array_like (2D or 3D, uint16, uint64 or float)", "The histogram sequence of one template with shape :py:attr:`histogram_shape`, or the histogram sequences of several templates, stacked along the first dimension")
+;
+
+template <typename T>
+static void enroll_inner(PyBobIpBaseHistogramScorerObject* self, PyBlitzArrayObject* histograms){
+  if (histograms->ndim == 2){
+    const blitz::Array<T,2>& h = *PyBlitzArrayCxx_AsBlitz<T,2>(histograms);
+    ReleaseGIL gil;
+    self->cxx->enroll(h);
+  } else {
+    const blitz::Array<T,3>& h = *PyBlitzArrayCxx_AsBlitz<T,3>(histograms);
+    ReleaseGIL gil;
+    self->cxx->enroll(h);
+  }
+}
+
+static PyObject* PyBobIpBaseHistogramScorer_enroll(PyBobIpBaseHistogramScorerObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+  char** kwlist = enroll.kwlist();
+
+  PyBlitzArrayObject* histograms;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&", kwlist, &PyBlitzArray_Converter, &histograms)){
+    enroll.print_usage();
+    return 0;
+  }
+  auto histograms_ = make_safe(histograms);
+  if (!check_histograms(self, histograms, "histograms", true)){
+    enroll.print_usage();
+    return 0;
+  }
+
+  switch (histograms->type_num){
+    case NPY_UINT16:  enroll_inner<uint16_t>(self, histograms); break;
+    case NPY_UINT64:  enroll_inner<uint64_t>(self, histograms); break;
+    default:          enroll_inner<double>(self, histograms); break;
+  }
+  Py_RETURN_NONE;
+
+  BOB_CATCH_MEMBER("cannot enroll templates", 0)
+}
+
+static auto clear = bob::extension::FunctionDoc(
+  "clear",
+  "Removes all enrolled templates",
+  0,
+  true
+)
+.add_prototype("")
+;
+
+static PyObject* PyBobIpBaseHistogramScorer_clear(PyBobIpBaseHistogramScorerObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+  char** kwlist = clear.kwlist();
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "", kwlist)) return 0;
+
+  self->cxx->clear();
+  Py_RETURN_NONE;
+
+  BOB_CATCH_MEMBER("cannot clear templates", 0)
+}
+
+static auto score = bob::extension::FunctionDoc(
+  "score",
+  "Compares the given probe to all enrolled templates",
+  "The templates are processed by ``n_threads`` threads, and the global interpreter lock is released during the comparison.\n\n"
+  ".. note::\n\n  The :py:func:`__call__` function is an alias for this method.",
+  true
+)
+.add_prototype("probe, [output], [n_threads]", "output")
+.add_parameter("probe", "array_like (2D, uint16, uint64 or float)", "The histogram sequence of the probe with shape :py:attr:`histogram_shape`")
+.add_parameter("output", "array_like (1D, float)", "[default: ``None``] If given, the scores will be written to this array, which needs to be of shape ``(len(self),)``")
+.add_parameter("n_threads", "int", "[default: 1] The number of threads to use; if 0 or negative, all hardware threads are used")
+.add_return("output", "array_like (1D, float)", "The scores of all templates, in the order of enrollment")
+;
+
+template <typename T>
+static void score_inner(PyBobIpBaseHistogramScorerObject* self, PyBlitzArrayObject* probe, PyBlitzArrayObject* output, int n_threads){
+  const blitz::Array<T,2>& p = *PyBlitzArrayCxx_AsBlitz<T,2>(probe);
+  blitz::Array<double,1>& scores = *PyBlitzArrayCxx_AsBlitz<double,1>(output);
+  ReleaseGIL gil;
+  self->cxx->score(p, scores, n_threads);
+}
+
+static PyObject* PyBobIpBaseHistogramScorer_score(PyBobIpBaseHistogramScorerObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+  char** kwlist = score.kwlist();
+
+  PyBlitzArrayObject* probe,* output = 0;
+  int n_threads = 1;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&|O&i", kwlist, &PyBlitzArray_Converter, &probe, &PyBlitzArray_OutputConverter, &output, &n_threads)){
+    score.print_usage();
+    return 0;
+  }
+  auto probe_ = make_safe(probe);
+  auto output_ = make_xsafe(output);
+  if (!check_histograms(self, probe, "probe", false)){
+    score.print_usage();
+    return 0;
+  }
+
+  const Py_ssize_t n_templates = self->cxx->getNumberOfTemplates();
+  if (output){
+    if (output->ndim != 1 || output->type_num != NPY_FLOAT64){
+      PyErr_Format(PyExc_TypeError, "`%s' only scores to 1D arrays of type float", Py_TYPE(self)->tp_name);
+      score.print_usage();
+      return 0;
+    }
+    if (output->shape[0] != n_templates){
+      PyErr_Format(PyExc_TypeError, "`%s' requires the shape of the output to be (%" PY_FORMAT_SIZE_T "d,), but it is (%" PY_FORMAT_SIZE_T "d,)", Py_TYPE(self)->tp_name, n_templates, output->shape[0]);
+      score.print_usage();
+      return 0;
+    }
+  } else {
+    Py_ssize_t osize[] = {n_templates};
+    output = (PyBlitzArrayObject*)PyBlitzArray_SimpleNew(NPY_FLOAT64, 1, osize);
+    output_ = make_safe(output);
+  }
+
+  switch (probe->type_num){
+    case NPY_UINT16:  score_inner<uint16_t>(self, probe, output, n_threads); break;
+    case NPY_UINT64:  score_inner<uint64_t>(self, probe, output, n_threads); break;
+    default:          score_inner<double>(self, probe, output, n_threads); break;
+  }
+
+  return PyBlitzArray_AsNumpyArray(output, 0);
+
+  BOB_CATCH_MEMBER("cannot score probe", 0)
+}
+
+static auto best = bob::extension::FunctionDoc(
+  "best",
+  "Compares the given probe to all enrolled templates, and returns the best ``k`` templates",
+  "The templates are ordered from best to worst, where lower scores are better for the ``'chi_square'`` :py:attr:`measure`, and higher scores are better for ``'intersection'``. "
+  "Templates with identical scores are ordered by their index. "
+  "The templates are processed by ``n_threads`` threads, and the global interpreter lock is released during the comparison.",
+  true
+)
+.add_prototype("probe, k, [n_threads]", "indices, scores")
+.add_parameter("probe", "array_like (2D, uint16, uint64 or float)", "The histogram sequence of the probe with shape :py:attr:`histogram_shape`")
+.add_parameter("k", "int", "The number of templates to return; must not be larger than ``len(self)``")
+.add_parameter("n_threads", "int", "[default: 1] The number of threads to use; if 0 or negative, all hardware threads are used")
+.add_return("indices", "array_like (1D, int32)", "The indices of the ``k`` best templates")
+.add_return("scores", "array_like (1D, float)", "The scores of the ``k`` best templates")
+;
+
+template <typename T>
+static void best_inner(PyBobIpBaseHistogramScorerObject* self, PyBlitzArrayObject* probe, PyBlitzArrayObject* indices, PyBlitzArrayObject* scores, int n_threads){
+  const blitz::Array<T,2>& p = *PyBlitzArrayCxx_AsBlitz<T,2>(probe);
+  blitz::Array<int,1>& i = *PyBlitzArrayCxx_AsBlitz<int32_t,1>(indices);
+  blitz::Array<double,1>& s = *PyBlitzArrayCxx_AsBlitz<double,1>(scores);
+  ReleaseGIL gil;
+  self->cxx->best(p, i, s, n_threads);
+}
+
+static PyObject* PyBobIpBaseHistogramScorer_best(PyBobIpBaseHistogramScorerObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+  char** kwlist = best.kwlist();
+
+  PyBlitzArrayObject* probe;
+  int k, n_threads = 1;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&i|i", kwlist, &PyBlitzArray_Converter, &probe, &k, &n_threads)){
+    best.print_usage();
+    return 0;
+  }
+  auto probe_ = make_safe(probe);
+  if (!check_histograms(self, probe, "probe", false)){
+    best.print_usage();
+    return 0;
+  }
+  if (k < 0){
+    PyErr_Format(PyExc_ValueError, "`%s' requires k to be non-negative, but it is %d", Py_TYPE(self)->tp_name, k);
+    best.print_usage();
+    return 0;
+  }
+
+  Py_ssize_t osize[] = {k};
+  PyBlitzArrayObject* indices = (PyBlitzArrayObject*)PyBlitzArray_SimpleNew(NPY_INT32, 1, osize);
+  auto indices_ = make_safe(indices);
+  PyBlitzArrayObject* scores = (PyBlitzArrayObject*)PyBlitzArray_SimpleNew(NPY_FLOAT64, 1, osize);
+  auto scores_ = make_safe(scores);
+
+  switch (probe->type_num){
+    case NPY_UINT16:  best_inner<uint16_t>(self, probe, indices, scores, n_threads); break;
+    case NPY_UINT64:  best_inner<uint64_t>(self, probe, indices, scores, n_threads); break;
+    default:          best_inner<double>(self, probe, indices, scores, n_threads); break;
+  }
+
+  return Py_BuildValue("NN", PyBlitzArray_AsNumpyArray(indices, 0), PyBlitzArray_AsNumpyArray(scores, 0));
+
+  BOB_CATCH_MEMBER("cannot select best templates", 0)
+}
+
+static PyMethodDef PyBobIpBaseHistogramScorer_methods[] = {
+  {
+    enroll.name(),
+    (PyCFunction)PyBobIpBaseHistogramScorer_enroll,
+    METH_VARARGS|METH_KEYWORDS,
+    enroll.doc()
+  },
+  {
+    clear.name(),
+    (PyCFunction)PyBobIpBaseHistogramScorer_clear,
+    METH_VARARGS|METH_KEYWORDS,
+    clear.doc()
+  },
+  {
+    score.name(),
+    (PyCFunction)PyBobIpBaseHistogramScorer_score,
+    METH_VARARGS|METH_KEYWORDS,
+    score.doc()
+  },
+  {
+    best.name(),
+    (PyCFunction)PyBobIpBaseHistogramScorer_best,
+    METH_VARARGS|METH_KEYWORDS,
+    best.doc()
+  },
+  {0} /* Sentinel */
+};
+
+
+/******************************************************************/
+/************ Module Section **************************************/
+/******************************************************************/
+
+static PySequenceMethods PyBobIpBaseHistogramScorer_sequence = {
+  (lenfunc)PyBobIpBaseHistogramScorer_len
+};
+
+// Define the HistogramScorer type struct; will be initialized later
+PyTypeObject PyBobIpBaseHistogramScorer_Type = {
+  PyVarObject_HEAD_INIT(0,0)
+  0
+};
+
+bool init_BobIpBaseHistogramScorer(PyObject* module)
+{
+  // initialize the type struct
+  PyBobIpBaseHistogramScorer_Type.tp_name = HistogramScorer_doc.name();
+  PyBobIpBaseHistogramScorer_Type.tp_basicsize = sizeof(PyBobIpBaseHistogramScorerObject);
+  PyBobIpBaseHistogramScorer_Type.tp_flags = Py_TPFLAGS_DEFAULT;
+  PyBobIpBaseHistogramScorer_Type.tp_doc = HistogramScorer_doc.doc();
+
+  // set the functions
+  PyBobIpBaseHistogramScorer_Type.tp_new = PyType_GenericNew;
+  PyBobIpBaseHistogramScorer_Type.tp_init = reinterpret_cast<initproc>(PyBobIpBaseHistogramScorer_init);
+  PyBobIpBaseHistogramScorer_Type.tp_dealloc = reinterpret_cast<destructor>(PyBobIpBaseHistogramScorer_delete);
+  PyBobIpBaseHistogramScorer_Type.tp_methods = PyBobIpBaseHistogramScorer_methods;
+  PyBobIpBaseHistogramScorer_Type.tp_getset = PyBobIpBaseHistogramScorer_getseters;
+  PyBobIpBaseHistogramScorer_Type.tp_as_sequence = &PyBobIpBaseHistogramScorer_sequence;
+  PyBobIpBaseHistogramScorer_Type.tp_call = reinterpret_cast<ternaryfunc>(PyBobIpBaseHistogramScorer_score);
+
+  // check that everything is fine
+  if (PyType_Ready(&PyBobIpBaseHistogramScorer_Type) < 0) return false;
+
+  // add the type to the module
+  Py_INCREF(&PyBobIpBaseHistogramScorer_Type);
+  return PyModule_AddObject(module, "HistogramScorer", (PyObject*)&PyBobIpBaseHistogramScorer_Type) >= 0;
+}
@@ -10,10 +10,14 @@
 #ifndef BOB_IP_BASE_AFFINE_H
 #define BOB_IP_BASE_AFFINE_H
 
+#include <vector>
+#include <limits>
 #include <boost/shared_ptr.hpp>
 #include <bob.core/assert.h>
 #include <bob.core/check.h>
 #include <bob.core/logging.h>
+#include <bob.ip.base/IntegralImage.h>
+#include <bob.ip.base/Parallel.h>
 
 #include <boost/random.hpp>
 #include <bob.core/random.h>
@@ -21,14 +25,132 @@
 
 namespace bob { namespace ip { namespace base {
 
-  /** Implementation of the bi-linear interpolation of a source to a target image. */
+  /** Converts an interpolated value to the target type; for integral target types, the value is rounded and clipped to the range of the type. */
+  template <typename U>
+  static inline U _convert(const double value){
+    if (std::numeric_limits<U>::is_integer){
+      if (value <= static_cast<double>(std::numeric_limits<U>::min())) return std::numeric_limits<U>::min();
+      if (value >= static_cast<double>(std::numeric_limits<U>::max())) return std::numeric_limits<U>::max();
+      return static_cast<U>(std::floor(value + 0.5));
+    }
+    return static_cast<U>(value);
+  }
+
+  /** Branch-free bi-linear interpolation of the four source pixels starting at the given pointer. */
+  template <typename T, typename U>
+  struct _bilinear {
+    static inline U interpolate(const T* s, const int stride_y, const int stride_x, const double my, const double mx){
+      return _convert<U>((1.-mx) * (1.-my) * s[0] + mx * (1.-my) * s[stride_x] + (1.-mx) * my * s[stride_y] + mx * my * s[stride_y + stride_x]);
+    }
+  };
+
+  /** Fixed-point bi-linear interpolation from uint8 to uint8 images, using 8-bit weights and rounding. */
+  template <>
+  struct _bilinear<uint8_t, uint8_t> {
+    static inline uint8_t interpolate(const uint8_t* s, const int stride_y, const int stride_x, const double my, const double mx){
+      const int ax = static_cast<int>(mx * 256. + .5), ay = static_cast<int>(my * 256. + .5);
+      const int top = s[0] * (256 - ax) + s[stride_x] * ax;
+      const int bottom = s[stride_y] * (256 - ax) + s[stride_y + stride_x] * ax;
+      return static_cast<uint8_t>((top * (256 - ay) + bottom * ay + (1 << 15)) >> 16);
+    }
+  };
 
+  /** Bi-linear interpolation of a single pixel, checking for each of the four source pixels whether it lies inside the source image (and the source mask). */
   template <typename T, bool mask>
+  static inline double _interpolate_checked(
+      const blitz::Array<T,2>& source,
+      const blitz::Array<bool,2>& source_mask,
+      const int h, const int w,
+      const double source_y, const double source_x,
+      bool* new_mask
+  ){
+    // split each source x and y in integral and decimal digits
+    const int ox = std::floor(source_x);
+    const int oy = std::floor(source_y);
+    const double mx = source_x - ox;
+    const double my = source_y - oy;
+
+    double res = 0.;
+    // add the four values bi-linearly interpolated
+    if (mask){
+      *new_mask = true;
+      // upper left
+      if (ox >= 0 && oy >= 0 && ox <= w && oy <= h && source_mask(oy,ox)){
+        res += (1.-mx) * (1.-my) * source(oy,ox);
+      } else if ((1.-mx) * (1.-my) > 0.){
+        *new_mask = false;
+      }
+
+      // upper right
+      if (ox >= -1 && oy >= 0 && ox < w && oy <= h && source_mask(oy,ox+1)){
+        res += mx * (1.-my) * source(oy,ox+1);
+      } else if (mx * (1.-my) > 0.){
+        *new_mask = false;
+      }
+      // lower left
+      if (ox >= 0 && oy >= -1 && ox <= w && oy < h && source_mask(oy+1,ox)){
+        res += (1.-mx) * my * source(oy+1,ox);
+      } else if ((1.-mx) * my > 0.){
+        *new_mask = false;
+      }
+      // lower right
+      if (ox >= -1 && oy >= -1 && ox < w && oy < h && source_mask(oy+1,ox+1)){
+        res += mx * my * source(oy+1,ox+1);
+      } else if (mx * my > 0.){
+        *new_mask = false;
+      }
+    } else {
+      // upper left
+      if (ox >= 0 && oy >= 0 && ox <= w && oy <= h)
+        res += (1.-mx) * (1.-my) * source(oy,ox);
+
+      // upper right
+      if (ox >= -1 && oy >= 0 && ox < w && oy <= h)
+        res += mx * (1.-my) * source(oy,ox+1);
+
+      // lower left
+      if (ox >= 0 && oy >= -1 && ox <= w && oy < h)
+        res += (1.-mx) * my * source(oy+1,ox);
+
+      // lower right
+      if (ox >= -1 && oy >= -1 && ox < w && oy < h)
+        res += mx * my * source(oy+1,ox+1);
+    }
+    return res;
+  }
+
+  /** Restricts the range [begin, end) of x to the values, for which position + x * delta lies inside [lower, upper]. */
+  static inline void _restrict_range(const double position, const double delta, const double lower, const double upper, int& begin, int& end){
+    if (delta == 0.){
+      // the position is constant
+      if (!(position >= lower && position <= upper)) end = begin;
+      return;
+    }
+    double first = (lower - position) / delta, last = (upper - position) / delta;
+    if (delta < 0.) std::swap(first, last);
+    // this test also catches NaN's
+    if (!(first <= last)){
+      end = begin;
+      return;
+    }
+    const double b = std::ceil(first), e = std::floor(last) + 1.;
+    if (b > begin) begin = b < end ? static_cast<int>(b) : end;
+    if (e < end) end = e > begin ? static_cast<int>(e) : begin;
+    if (end < begin) end = begin;
+  }
+
+  /**
+   * Implementation of the bi-linear interpolation of a source to a target image.
+   * The target image can be of any arithmetic type; interpolated values are rounded and clipped for integral target types.
+   * For uint8 source and target images, the interior of the image is interpolated with 8-bit fixed-point weights.
+   */
+
+  template <typename T, bool mask, typename U>
   void transform(
       const blitz::Array<T,2>& source,
       const blitz::Array<bool,2>& source_mask,
       const blitz::TinyVector<double,2>& source_center,
-      blitz::Array<double,2>& target,
+      blitz::Array<U,2>& target,
       blitz::Array<bool,2>& target_mask,
       const blitz::TinyVector<double,2>& target_center,
       const blitz::TinyVector<double,2>& scaling_factor,
@@ -68,8 +190,15 @@ namespace bob { namespace ip { namespace base {
     // some helpers for the interpolation
     int ox, oy;
     double mx, my;
-    int h = source.extent(0)-1;
-    int w = source.extent(1)-1;
+    const int h = source.extent(0)-1;
+    const int w = source.extent(1)-1;
+    // the offsets of the right and the lower source pixels
+    const int stride_y = source.stride(0), stride_x = source.stride(1);
+    const int mask_stride_y = source_mask.stride(0), mask_stride_x = source_mask.stride(1);
+
+    // The interior of each row is the range of target pixels, for which all four source pixels lie inside the source image.
+    // The small margin accounts for the rounding errors of the incremental position updates.
+    const double margin = 1e-6;
 
     int size_y = target.extent(0), size_x = target.extent(1);
 
@@ -77,69 +206,61 @@ namespace bob { namespace ip { namespace base {
     for (int y = 0; y < size_y; ++y){
       // set the source image point to first point in row
       double source_x = origin_x, source_y = origin_y;
-      // iterate over the row
-      for (int x = 0; x < size_x; ++x){
 
-        // We are at the desired pixel in the new image. Interpolate the old image's pixels:
-        double& res = target(y,x) = 0.;
+      // compute the interior range of this row
+      int x_begin = 0, x_end = size_x;
+      _restrict_range(origin_y, col_dy, margin, h - margin, x_begin, x_end);
+      _restrict_range(origin_x, col_dx, margin, w - margin, x_begin, x_end);
+
+      int x = 0;
+      // the left border of the row, with bounds checks
+      for (; x < x_begin; ++x){
+        target(y,x) = _convert<U>(_interpolate_checked<T,mask>(source, source_mask, h, w, source_y, source_x, mask ? &target_mask(y,x) : 0));
+        source_y += col_dy;
+        source_x += col_dx;
+      }
 
+      // the interior of the row, without bounds checks
+      for (; x < x_end; ++x){
         // split each source x and y in integral and decimal digits
-        ox = std::floor(source_x);
-        oy = std::floor(source_y);
+        // (positions are positive here, so truncation is identical to std::floor)
+        ox = static_cast<int>(source_x);
+        oy = static_cast<int>(source_y);
         mx = source_x - ox;
         my = source_y - oy;
 
-        // add the four values bi-linearly interpolated
+        const T* s = &source(oy,ox);
         if (mask){
+          // the masked pixels still need to be checked
+          double res = 0.;
           bool& new_mask = target_mask(y,x) = true;
-          // upper left
-          if (ox >= 0 && oy >= 0 && ox <= w && oy <= h && source_mask(oy,ox)){
-            res += (1.-mx) * (1.-my) * source(oy,ox);
-          } else if ((1.-mx) * (1.-my) > 0.){
-            new_mask = false;
-          }
-
-          // upper right
-          if (ox >= -1 && oy >= 0 && ox < w && oy <= h && source_mask(oy,ox+1)){
-            res += mx * (1.-my) * source(oy,ox+1);
-          } else if (mx * (1.-my) > 0.){
-            new_mask = false;
-          }
-          // lower left
-          if (ox >= 0 && oy >= -1 && ox <= w && oy < h && source_mask(oy+1,ox)){
-            res += (1.-mx) * my * source(oy+1,ox);
-          } else if ((1.-mx) * my > 0.){
-            new_mask = false;
-          }
-          // lower right
-          if (ox >= -1 && oy >= -1 && ox < w && oy < h && source_mask(oy+1,ox+1)){
-            res += mx * my * source(oy+1,ox+1);
-          } else if (mx * my > 0.){
-            new_mask = false;
-          }
+          const bool* m = &source_mask(oy,ox);
+          if (m[0]) res += (1.-mx) * (1.-my) * s[0];
+          else if ((1.-mx) * (1.-my) > 0.) new_mask = false;
+          if (m[mask_stride_x]) res += mx * (1.-my) * s[stride_x];
+          else if (mx * (1.-my) > 0.) new_mask = false;
+          if (m[mask_stride_y]) res += (1.-mx) * my * s[stride_y];
+          else if ((1.-mx) * my > 0.) new_mask = false;
+          if (m[mask_stride_y + mask_stride_x]) res += mx * my * s[stride_y + stride_x];
+          else if (mx * my > 0.) new_mask = false;
+          target(y,x) = _convert<U>(res);
         } else {
-          // upper left
-          if (ox >= 0 && oy >= 0 && ox <= w && oy <= h)
-            res += (1.-mx) * (1.-my) * source(oy,ox);
-
-          // upper right
-          if (ox >= -1 && oy >= 0 && ox < w && oy <= h)
-            res += mx * (1.-my) * source(oy,ox+1);
-
-          // lower left
-          if (ox >= 0 && oy >= -1 && ox <= w && oy < h)
-            res += (1.-mx) * my * source(oy+1,ox);
-
-          // lower right
-          if (ox >= -1 && oy >= -1 && ox < w && oy < h)
-            res += mx * my * source(oy+1,ox+1);
+          // branch-free bi-linear interpolation
+          target(y,x) = _bilinear<T,U>::interpolate(s, stride_y, stride_x, my, mx);
         }
 
-        // done with this pixel...
         // go to the next source pixel in the row
         source_y += col_dy;
         source_x += col_dx;
       }
+
+      // the right border of the row, with bounds checks
+      for (; x < size_x; ++x){
+        target(y,x) = _convert<U>(_interpolate_checked<T,mask>(source, source_mask, h, w, source_y, source_x, mask ? &target_mask(y,x) : 0));
+        source_y += col_dy;
+        source_x += col_dx;
+      }
+
       // at the end of the row, we shift the origin to the next line
       origin_y += row_dy;
       origin_x += row_dx;
@@ -160,20 +281,124 @@ namespace bob { namespace ip { namespace base {
     return blitz::TinyVector<double,2>(y_scale, x_scale);
   }
 
+  /**
+   * @brief This class stores the interpolation tables that are required to
+   *   scale an image of a given shape to an image of another given shape.
+   *   Since scaling does not rotate the image, the bi-linear interpolation
+   *   is separable, i.e., for each row (column) of the target image, only
+   *   two source rows (columns) and one weight are required.
+   *   Target pixel i along an axis is interpolated as
+   *   (1-weight[i]) * source[index0[i]] + weight[i] * source[index1[i]].
+   *   All indices are guaranteed to lie inside the source image.
+   */
+  class ScaleTables {
+    public:
+      /**
+       * @brief Computes the interpolation tables for the given shapes
+       * @param src_shape The shape of the source image
+       * @param dst_shape The shape of the target image
+       */
+      ScaleTables(const blitz::TinyVector<int,2>& src_shape, const blitz::TinyVector<int,2>& dst_shape);
+
+      const blitz::TinyVector<int,2>& getSourceShape() const {return m_src_shape;}
+      const blitz::TinyVector<int,2>& getTargetShape() const {return m_dst_shape;}
+
+      /** The source rows and weights required for each target row */
+      const std::vector<int>& getRowIndex0() const {return m_row_index0;}
+      const std::vector<int>& getRowIndex1() const {return m_row_index1;}
+      const std::vector<double>& getRowWeight() const {return m_row_weight;}
+      /** Flags that indicate, which source rows are used at all */
+      const std::vector<char>& getUsedRows() const {return m_used_rows;}
+
+      /** The source columns and weights required for each target column */
+      const std::vector<int>& getColumnIndex0() const {return m_col_index0;}
+      const std::vector<int>& getColumnIndex1() const {return m_col_index1;}
+      const std::vector<double>& getColumnWeight() const {return m_col_weight;}
+
+    private:
+      blitz::TinyVector<int,2> m_src_shape;
+      blitz::TinyVector<int,2> m_dst_shape;
+      std::vector<int> m_row_index0, m_row_index1, m_col_index0, m_col_index1;
+      std::vector<double> m_row_weight, m_col_weight;
+      std::vector<char> m_used_rows;
+  };
+
+  /**
+   * @brief Returns the interpolation tables to scale images from the given source shape to the given target shape.
+   *   The tables of the recently used shapes are cached, so that scaling several images of the same shape does not need to re-compute them.
+   *   This function is thread-safe.
+   * @param src_shape The shape of the source image
+   * @param dst_shape The shape of the target image
+   * @return The (shared) interpolation tables
+   */
+  boost::shared_ptr<const ScaleTables> getScaleTables(const blitz::TinyVector<int,2>& src_shape, const blitz::TinyVector<int,2>& dst_shape);
+
+  /**
+   * @brief Scales the given image using the given interpolation tables.
+   *   The image is first interpolated along the rows, storing the results in a buffer,
+   *   and afterwards the rows of the buffer are interpolated.
+   *   The inner loops are free of any boundary checks.
+   */
+  template <typename T, typename U>
+  void _scale(const blitz::Array<T,2>& src, blitz::Array<U,2>& dst, const ScaleTables& tables){
+    const int src_height = src.extent(0), dst_height = dst.extent(0), dst_width = dst.extent(1);
+    if (!src.size()){
+      // nothing can be interpolated from an empty image
+      dst = static_cast<U>(0);
+      return;
+    }
+    if (!dst.size()) return;
+
+    const std::vector<int>& row_index0 = tables.getRowIndex0(), & row_index1 = tables.getRowIndex1();
+    const std::vector<int>& col_index0 = tables.getColumnIndex0(), & col_index1 = tables.getColumnIndex1();
+    const std::vector<double>& row_weight = tables.getRowWeight(), & col_weight = tables.getColumnWeight();
+    const std::vector<char>& used_rows = tables.getUsedRows();
+
+    // first pass: interpolate the required source rows horizontally
+    std::vector<double> buffer(src_height * dst_width);
+    const int src_stride = src.stride(1);
+    for (int y = 0; y < src_height; ++y){
+      if (!used_rows[y]) continue;
+      const T* s = &src(y,0);
+      double* b = &buffer[y * dst_width];
+      for (int x = 0; x < dst_width; ++x){
+        const double w = col_weight[x];
+        b[x] = (1. - w) * s[col_index0[x] * src_stride] + w * s[col_index1[x] * src_stride];
+      }
+    }
+
+    // second pass: interpolate the buffered rows vertically
+    const int dst_stride = dst.stride(1);
+    for (int y = 0; y < dst_height; ++y){
+      const double* b0 = &buffer[row_index0[y] * dst_width];
+      const double* b1 = &buffer[row_index1[y] * dst_width];
+      const double w = row_weight[y];
+      U* d = &dst(y,0);
+      for (int x = 0; x < dst_width; ++x){
+        d[x * dst_stride] = _convert<U>((1. - w) * b0[x] + w * b1[x]);
+      }
+    }
+  }
+
+  /**
+   * @brief Scales the given uint8 image to a uint8 image using the given interpolation tables.
+   *   The interpolation uses 8-bit fixed-point weights and rounding.
+   */
+  void _scale(const blitz::Array<uint8_t,2>& src, blitz::Array<uint8_t,2>& dst, const ScaleTables& tables);
+
   /**
    * @brief Function which rescales a 2D blitz::array/image of a given type.
    *   The first dimension is the height (y-axis), whereas the second
    *   one is the width (x-axis).
    * @param src The input blitz array
    * @param dst The output blitz array. The new array is resized according
-   *   to the dimensions of this dst array.
+   *   to the dimensions of this dst array. For integral types, the
+   *   interpolated values are rounded.
    */
-  template <typename T>
-  void scale(const blitz::Array<T,2>& src, blitz::Array<double,2>& dst){
-    blitz::TinyVector<double,2> offset(0,0);
-    blitz::Array<bool,2> src_mask, dst_mask;
-    // .. apply scale with (0,0) as offset and 0 as rotation angle
-    transform<T,false>(src, src_mask, offset, dst, dst_mask, offset, _get_scale_factor(src.shape(), dst.shape()), 0.);
+  template <typename T, typename U>
+  void scale(const blitz::Array<T,2>& src, blitz::Array<U,2>& dst){
+    // scaling is separable, so we use the pre-computed interpolation tables
+    _scale(src, dst, *getScaleTables(src.shape(), dst.shape()));
   }
 
   /**
@@ -186,8 +411,8 @@ namespace bob { namespace ip { namespace base {
    *   to the dimensions of this dst array.
    * @param dst_mask The output blitz boolean mask array
    */
-  template <typename T>
-  void scale(const blitz::Array<T,2>& src, const blitz::Array<bool,2>& src_mask, blitz::Array<double,2>& dst, blitz::Array<bool,2>& dst_mask){
+  template <typename T, typename U>
+  void scale(const blitz::Array<T,2>& src, const blitz::Array<bool,2>& src_mask, blitz::Array<U,2>& dst, blitz::Array<bool,2>& dst_mask){
     blitz::TinyVector<double,2> offset(0,0);
     // .. apply scale with (0,0) as offset and 0 as rotation angle
     transform<T,true>(src, src_mask, offset, dst, dst_mask, offset, _get_scale_factor(src.shape(), dst.shape()), 0.);
@@ -201,21 +426,23 @@ namespace bob { namespace ip { namespace base {
    * @param dst The output blitz array. The new array is resized according
    *   to the dimensions of this dst array.
    */
-  template <typename T>
-  void scale(const blitz::Array<T,3>& src, blitz::Array<double,3>& dst)
+  template <typename T, typename U>
+  void scale(const blitz::Array<T,3>& src, blitz::Array<U,3>& dst)
   {
     // Check number of planes
     bob::core::array::assertSameDimensionLength(src.extent(0), dst.extent(0));
+    // all planes share the same interpolation tables
+    boost::shared_ptr<const ScaleTables> tables = getScaleTables(blitz::TinyVector<int,2>(src.extent(1), src.extent(2)), blitz::TinyVector<int,2>(dst.extent(1), dst.extent(2)));
     for (int p = 0; p < dst.extent(0); ++p){
       const blitz::Array<T,2> src_slice = src(p, blitz::Range::all(), blitz::Range::all());
-      blitz::Array<double,2> dst_slice =dst(p, blitz::Range::all(), blitz::Range::all());
+      blitz::Array<U,2> dst_slice =dst(p, blitz::Range::all(), blitz::Range::all());
       // Process one plane
-      scale(src_slice, dst_slice);
+      _scale(src_slice, dst_slice, *tables);
     }
   }
 
-  template <typename T>
-  void scale(const blitz::Array<T,3>& src, const blitz::Array<bool,3>& src_mask, blitz::Array<double,3>& dst, blitz::Array<bool,3>& dst_mask)
+  template <typename T, typename U>
+  void scale(const blitz::Array<T,3>& src, const blitz::Array<bool,3>& src_mask, blitz::Array<U,3>& dst, blitz::Array<bool,3>& dst_mask)
   {
     // Check number of planes
     bob::core::array::assertSameDimensionLength(src.extent(0), dst.extent(0));
@@ -224,13 +451,98 @@ namespace bob { namespace ip { namespace base {
     for (int p = 0; p < dst.extent(0); ++p){
       const blitz::Array<T,2> src_slice = src(p, blitz::Range::all(), blitz::Range::all());
       const blitz::Array<bool,2> src_mask_slice = src_mask(p, blitz::Range::all(), blitz::Range::all());
-      blitz::Array<double,2> dst_slice = dst(p, blitz::Range::all(), blitz::Range::all());
+      blitz::Array<U,2> dst_slice = dst(p, blitz::Range::all(), blitz::Range::all());
       blitz::Array<bool,2> dst_mask_slice = dst_mask(p, blitz::Range::all(), blitz::Range::all());
       // Process one plane
       scale(src_slice, src_mask_slice, dst_slice, dst_mask_slice);
     }
   }
 
+  /** Computes the source index and the fractional offset of the dst_size+1 boundaries of the target pixels, where target pixel i covers the source range [i*src_size/dst_size, (i+1)*src_size/dst_size). */
+  static inline void _area_boundaries(const int src_size, const int dst_size, std::vector<int>& index, std::vector<double>& weight){
+    index.resize(dst_size+1);
+    weight.resize(dst_size+1);
+    for (int i = 0; i <= dst_size; ++i){
+      const double position = static_cast<double>(i) * src_size / dst_size;
+      index[i] = std::min(static_cast<int>(position), src_size - 1);
+      weight[i] = position - index[i];
+    }
+  }
+
+  /**
+   * @brief Function which rescales a 2D blitz::array/image of a given type
+   *   by area averaging, i.e., each output pixel is the mean of the source
+   *   image over the exact (fractional) area that the pixel covers.
+   *   The box sums are computed in constant time from the integral image,
+   *   so that the costs do not depend on the scale factor. This is the
+   *   preferred method for down-scaling, since it does not alias.
+   * @param src The input blitz array
+   * @param dst The output blitz array. The new array is resized according
+   *   to the dimensions of this dst array. For integral types, the
+   *   averaged values are rounded.
+   */
+  template <typename T, typename U>
+  void scaleArea(const blitz::Array<T,2>& src, blitz::Array<U,2>& dst){
+    bob::core::array::assertZeroBase(src);
+    bob::core::array::assertZeroBase(dst);
+
+    const int src_height = src.extent(0), src_width = src.extent(1);
+    const int dst_height = dst.extent(0), dst_width = dst.extent(1);
+    if (!dst_height || !dst_width) return;
+    if (!src_height || !src_width){
+      dst = U(0);
+      return;
+    }
+
+    // integral image with zero border, i.e., integral_image(y,x) is the sum of src over [0,y) x [0,x)
+    blitz::Array<double,2> integral_image(src_height+1, src_width+1);
+    integral(src, integral_image, true);
+
+    std::vector<int> y_index, x_index;
+    std::vector<double> y_weight, x_weight;
+    _area_boundaries(src_height, dst_height, y_index, y_weight);
+    _area_boundaries(src_width, dst_width, x_index, x_weight);
+
+    // Since the source image is constant inside each pixel, the sum over
+    // [0,y) x [0,x) for fractional y and x is the bi-linear interpolation
+    // of the integral image; we keep these sums for two consecutive row boundaries
+    std::vector<double> previous(dst_width+1), current(dst_width+1);
+    const double normalizer = (static_cast<double>(dst_height) * dst_width) / (static_cast<double>(src_height) * src_width);
+    for (int b = 0; b <= dst_height; ++b){
+      const int iy = y_index[b];
+      const double wy = y_weight[b];
+      for (int c = 0; c <= dst_width; ++c){
+        const int ix = x_index[c];
+        const double wx = x_weight[c];
+        current[c] = (1. - wy) * ((1. - wx) * integral_image(iy, ix) + wx * integral_image(iy, ix+1))
+                   + wy * ((1. - wx) * integral_image(iy+1, ix) + wx * integral_image(iy+1, ix+1));
+      }
+      if (b){
+        for (int x = 0; x < dst_width; ++x){
+          dst(b-1, x) = _convert<U>((current[x+1] - current[x] - previous[x+1] + previous[x]) * normalizer);
+        }
+      }
+      std::swap(previous, current);
+    }
+  }
+
+  /**
+   * @brief Function which rescales a 3D blitz::array/image of a given type
+   *   by area averaging, see the 2D version of this function.
+   */
+  template <typename T, typename U>
+  void scaleArea(const blitz::Array<T,3>& src, blitz::Array<U,3>& dst)
+  {
+    // Check number of planes
+    bob::core::array::assertSameDimensionLength(src.extent(0), dst.extent(0));
+    for (int p = 0; p < dst.extent(0); ++p){
+      const blitz::Array<T,2> src_slice = src(p, blitz::Range::all(), blitz::Range::all());
+      blitz::Array<U,2> dst_slice = dst(p, blitz::Range::all(), blitz::Range::all());
+      // Process one plane
+      scaleArea(src_slice, dst_slice);
+    }
+  }
+
   /**
    * @brief Function which returns the shape of an output blitz::array
    *   when rescaling an input image with the given scale factor.
@@ -251,6 +563,79 @@ namespace bob { namespace ip { namespace base {
 **************  Rotating functionality  *********************************
 ************************************************************************/
 
+  /** Returns the number of (counter-clock-wise) quarter turns 0, 1, 2 or 3, when the angle is a multiple of 90 degrees, and -1 otherwise */
+  static inline int _quarterTurns(const double rotation_angle){
+    double angle = std::fmod(rotation_angle, 360.);
+    if (angle < 0.) angle += 360.;
+    const double quarters = angle / 90.;
+    if (quarters != std::floor(quarters)) return -1;
+    return static_cast<int>(quarters) % 4;
+  }
+
+  /** Copies a pixel of a rotated image; values are only rounded and clipped when a floating point image is written into an integral one */
+  template <typename T, typename U>
+  static inline U _copy(const T value){
+    if (std::numeric_limits<U>::is_integer && !std::numeric_limits<T>::is_integer) return _convert<U>(value);
+    return static_cast<U>(value);
+  }
+
+  /**
+   * Rotates the image by the given number of quarter turns, which is an exact permutation of the pixels.
+   * The target image is processed in square tiles, so that the source pixels of a tile, which are read column-wise for 90 and 270 degrees, stay in the cache.
+   * When masks are given, the source mask is permuted the same way, and pixels outside of the source mask are set to 0, as in transform.
+   */
+  template <typename T, bool mask, typename U>
+  void _rotateQuarterTurns(
+      const blitz::Array<T,2>& source,
+      const blitz::Array<bool,2>& source_mask,
+      blitz::Array<U,2>& target,
+      blitz::Array<bool,2>& target_mask,
+      const int quarter_turns
+  ){
+    const int tile = 64;
+    const int h = source.extent(0), w = source.extent(1);
+    const int size_y = target.extent(0), size_x = target.extent(1);
+    if (!target.size()) return;
+
+    // the position of target(0,0) in the source image, and the offsets in the source image when going one pixel down and right in the target image
+    int origin_y = 0, origin_x = 0, step_yy = 1, step_yx = 0, step_xy = 0, step_xx = 1;
+    switch (quarter_turns){
+      case 1: origin_x = w-1; step_yy = 0; step_yx = -1; step_xy = 1; step_xx = 0; break;
+      case 2: origin_y = h-1; origin_x = w-1; step_yy = -1; step_xx = -1; break;
+      case 3: origin_y = h-1; step_yy = 0; step_yx = 1; step_xy = -1; step_xx = 0; break;
+    }
+    const int stride_y = source.stride(0), stride_x = source.stride(1);
+    const int mask_stride_y = source_mask.stride(0), mask_stride_x = source_mask.stride(1);
+    const int s_dy = step_yy * stride_y + step_yx * stride_x, s_dx = step_xy * stride_y + step_xx * stride_x;
+    const int m_dy = step_yy * mask_stride_y + step_yx * mask_stride_x, m_dx = step_xy * mask_stride_y + step_xx * mask_stride_x;
+    const T* s0 = &source(origin_y, origin_x);
+    const bool* m0 = mask ? &source_mask(origin_y, origin_x) : 0;
+
+    for (int ty = 0; ty < size_y; ty += tile){
+      const int ey = std::min(ty + tile, size_y);
+      for (int tx = 0; tx < size_x; tx += tile){
+        const int ex = std::min(tx + tile, size_x);
+        for (int y = ty; y < ey; ++y){
+          const T* s = s0 + y * s_dy + tx * s_dx;
+          U* t = &target(y,tx);
+          const int t_dx = target.stride(1);
+          if (mask){
+            const bool* m = m0 + y * m_dy + tx * m_dx;
+            bool* n = &target_mask(y,tx);
+            const int n_dx = target_mask.stride(1);
+            for (int x = tx; x < ex; ++x, s += s_dx, m += m_dx, t += t_dx, n += n_dx){
+              *n = *m;
+              *t = *m ? _copy<T,U>(*s) : U(0);
+            }
+          } else {
+            for (int x = tx; x < ex; ++x, s += s_dx, t += t_dx)
+              *t = _copy<T,U>(*s);
+          }
+        }
+      }
+    }
+  }
+
   /**
    * @brief Function which rotates a 2D blitz::array/image of a given type with the given angle in degrees.
    *   The first dimension is the height (y-axis), whereas the second
@@ -259,12 +644,18 @@ namespace bob { namespace ip { namespace base {
    * @param dst The output blitz array
    * @param rotation_angle The angle in degrees to rotate the image with
    */
-  template <typename T>
-  void rotate(const blitz::Array<T,2>& src, blitz::Array<double,2>& dst, const double rotation_angle){
+  template <typename T, typename U>
+  void rotate(const blitz::Array<T,2>& src, blitz::Array<U,2>& dst, const double rotation_angle){
+    blitz::Array<bool,2> src_mask, dst_mask;
+    // multiples of 90 degrees are exact permutations of the pixels
+    const int quarter_turns = _quarterTurns(rotation_angle);
+    if (quarter_turns >= 0 && dst.extent(0) == src.extent(quarter_turns % 2) && dst.extent(1) == src.extent(1 - quarter_turns % 2)){
+      _rotateQuarterTurns<T,false>(src, src_mask, dst, dst_mask, quarter_turns);
+      return;
+    }
     // rotation offset is the center of the image
     blitz::TinyVector<double,2> src_offset((src.extent(0)-1.)/2.,(src.extent(1)-1.)/2.);
     blitz::TinyVector<double,2> dst_offset((dst.extent(0)-1.)/2.,(dst.extent(1)-1.)/2.);
-    blitz::Array<bool,2> src_mask, dst_mask;
     // .. apply scale with (0,0) as offset and 0 as rotation angle
     transform<T,false>(src, src_mask, src_offset, dst, dst_mask, dst_offset, blitz::TinyVector<double,2>(1., 1.), rotation_angle);
   }
@@ -279,8 +670,16 @@ namespace bob { namespace ip { namespace base {
    * @param dst_mask The output blitz boolean mask array
    * @param rotation_angle The angle in degrees to rotate the image with
    */
-  template <typename T>
-  void rotate(const blitz::Array<T,2>& src, const blitz::Array<bool,2>& src_mask, blitz::Array<double,2>& dst, blitz::Array<bool,2>& dst_mask, const double rotation_angle){
+  template <typename T, typename U>
+  void rotate(const blitz::Array<T,2>& src, const blitz::Array<bool,2>& src_mask, blitz::Array<U,2>& dst, blitz::Array<bool,2>& dst_mask, const double rotation_angle){
+    // multiples of 90 degrees are exact permutations of the pixels
+    const int quarter_turns = _quarterTurns(rotation_angle);
+    if (quarter_turns >= 0 && dst.extent(0) == src.extent(quarter_turns % 2) && dst.extent(1) == src.extent(1 - quarter_turns % 2)){
+      bob::core::array::assertSameShape(src, src_mask);
+      bob::core::array::assertSameShape(dst, dst_mask);
+      _rotateQuarterTurns<T,true>(src, src_mask, dst, dst_mask, quarter_turns);
+      return;
+    }
     // rotation offset is the center of the image
     blitz::TinyVector<double,2> src_offset((src.extent(0)-1.)/2.,(src.extent(1)-1.)/2.);
     blitz::TinyVector<double,2> dst_offset((dst.extent(0)-1.)/2.,(dst.extent(1)-1.)/2.);
@@ -296,21 +695,21 @@ namespace bob { namespace ip { namespace base {
    * @param dst The output blitz array
    * @param rotation_angle The angle in degrees to rotate the image with
    */
-  template <typename T>
-  void rotate(const blitz::Array<T,3>& src, blitz::Array<double,3>& dst, const double rotation_angle)
+  template <typename T, typename U>
+  void rotate(const blitz::Array<T,3>& src, blitz::Array<U,3>& dst, const double rotation_angle)
   {
     // Check number of planes
     bob::core::array::assertSameDimensionLength(src.extent(0), dst.extent(0));
     for (int p = 0; p < dst.extent(0); ++p){
       const blitz::Array<T,2> src_slice = src(p, blitz::Range::all(), blitz::Range::all());
-      blitz::Array<double,2> dst_slice = dst(p, blitz::Range::all(), blitz::Range::all());
+      blitz::Array<U,2> dst_slice = dst(p, blitz::Range::all(), blitz::Range::all());
       // Process one plane
       rotate(src_slice, dst_slice, rotation_angle);
     }
   }
 
-  template <typename T>
-  void rotate(const blitz::Array<T,3>& src, const blitz::Array<bool,3>& src_mask, blitz::Array<double,3>& dst, blitz::Array<bool,3>& dst_mask, const double rotation_angle)
+  template <typename T, typename U>
+  void rotate(const blitz::Array<T,3>& src, const blitz::Array<bool,3>& src_mask, blitz::Array<U,3>& dst, blitz::Array<bool,3>& dst_mask, const double rotation_angle)
   {
     // Check number of planes
     bob::core::array::assertSameDimensionLength(src.extent(0), dst.extent(0));
@@ -319,7 +718,7 @@ namespace bob { namespace ip { namespace base {
     for (int p = 0; p < dst.extent(0); ++p){
       const blitz::Array<T,2> src_slice = src(p, blitz::Range::all(), blitz::Range::all());
       const blitz::Array<bool,2> src_mask_slice = src_mask(p, blitz::Range::all(), blitz::Range::all());
-      blitz::Array<double,2> dst_slice = dst(p, blitz::Range::all(), blitz::Range::all());
+      blitz::Array<U,2> dst_slice = dst(p, blitz::Range::all(), blitz::Range::all());
       blitz::Array<bool,2> dst_mask_slice = dst_mask(p, blitz::Range::all(), blitz::Range::all());
       // Process one plane
       rotate(src_slice, src_mask_slice, dst_slice, dst_mask_slice, rotation_angle);
@@ -354,8 +753,13 @@ namespace bob { namespace ip { namespace base {
   /**
     * @brief Function which extracts a rectangle of maximal area from a
     *   2D mask of booleans (i.e. a 2D blitz array).
+    *   The runtime is linear in the number of pixels of the mask.
+    *   When several rectangles have the maximal area, the one with the
+    *   smallest top, left and height (in this order) is returned.
     * @warning The function assumes that the true values on the mask form
-    *   a convex area.
+    *   a convex area. Strictly speaking, only rectangles whose top-left
+    *   corner lies in the first sequence of true values in its row are
+    *   considered.
     * @param mask The 2D input blitz array mask.
     * @result A blitz::TinyVector which contains in the following order:
     *   0/ The y-coordinate of the top left corner
@@ -365,6 +769,17 @@ namespace bob { namespace ip { namespace base {
     */
   const blitz::TinyVector<int,4> maxRectInMask(const blitz::Array<bool,2>& mask);
 
+  /**
+    * @brief Function which extracts rectangles of maximal area from a
+    *   stack of 2D masks, see the 2D version of this function.
+    *   The masks are distributed over n_threads threads (see
+    *   bob::ip::base::parallelFor).
+    * @param masks The 3D stack of masks, of shape (N, height, width).
+    * @param rects The resulting rectangles, of shape (N, 4), each containing
+    *   the top, left, height and width of the rectangle.
+    */
+  void maxRectInMask(const blitz::Array<bool,3>& masks, blitz::Array<int32_t,2>& rects, const int n_threads = 1);
+
 
   /**
     * @brief Function which extracts an image with a nearest neighbour
@@ -572,6 +987,118 @@ namespace bob { namespace ip { namespace base {
   }
 
 
+  /** One step of the SplitMix64 generator, which is used for the counter-based random streams of extrapolateMaskRandom */
+  static inline uint64_t _splitmix64(uint64_t& state){
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+  }
+
+  /** Returns a uniformly distributed random number in [0,1) from the given SplitMix64 stream */
+  static inline double _uniform(uint64_t& state){
+    return (_splitmix64(state) >> 11) * (1. / 9007199254740992.);
+  }
+
+  /**
+    * @brief Computes the wavefront of the unmasked pixels that are connected to the masked area.
+    * @param mask The 2D mask
+    * @param distance The city-block distance of each pixel (y * width + x) to the masked area; -1 for pixels that are not connected
+    * @param order The indices (y * width + x) of all connected unmasked pixels, sorted by distance
+    * @param layers The pixels with distance d+1 are stored in order[layers[d]] to order[layers[d+1]-1]
+    */
+  void _wavefrontLayers(const blitz::Array<bool,2>& mask, std::vector<int>& distance, std::vector<int>& order, std::vector<int>& layers);
+
+  /**
+    * @brief Function which fills unmasked pixel areas of an image with pixel values from the border of the masked part of the image
+    *   by adding some random noise.
+    *   Contrary to the version above, the unmasked pixels are filled in layers of increasing distance to the masked area.
+    *   Each pixel is filled with one of the pixels of the previous layers, which are chosen
+    *   from the 2*neighbors+1 pixels around a neighboring pixel of the previous layer.
+    *   The random numbers of each pixel are generated from a separate stream that depends only on the
+    *   seed and the pixel position, so that the pixels of one layer can be filled in parallel,
+    *   and the result does not depend on the number of threads.
+    * @param mask The 2D input blitz array mask; the masked area does not need to be convex.
+    * @param img The 2D input/output blitz array/image; for integral types, the values are rounded and clipped.
+    * @param seed The seed of the random streams
+    * @param random_factor The standard deviation of a normal distribution to multiply pixel values with
+    * @param neighbors The (maximum) number of additional neighboring border values to choose from
+    * @param n_threads The number of threads to use (see bob::ip::base::parallelFor)
+    * @warning Pixels that are not connected to the masked area are not filled.
+    */
+  template <typename T>
+  void extrapolateMaskRandom(const blitz::Array<bool,2>& mask, blitz::Array<T,2>& img, const uint64_t seed, double random_factor = 0.01, int neighbors = 5, int n_threads = 1){
+    // Check input and output size
+    bob::core::array::assertZeroBase(mask);
+    bob::core::array::assertZeroBase(img);
+    bob::core::array::assertSameShape(mask, img);
+    const int height = img.extent(0), width = img.extent(1);
+
+    std::vector<int> distance, order, layers;
+    _wavefrontLayers(mask, distance, order, layers);
+
+    // the four neighbors: up, left, down, right
+    static const int directions_y[] = {-1, 0, 1, 0};
+    static const int directions_x[] = {0, -1, 0, 1};
+
+    for (int d = 0; d + 1 < static_cast<int>(layers.size()); ++d){
+      const int layer_begin = layers[d], layer_size = layers[d+1] - layers[d];
+      // the pixels of one layer are filled from the previous layers only, so they are independent;
+      // small layers are not worth to be split
+      parallelFor(layer_size, getNumberOfThreads(n_threads, (layer_size + 255) / 256), [&](int begin, int end){
+        for (int i = begin; i < end; ++i){
+          const int index = order[layer_begin + i];
+          const int y = index / width, x = index % width;
+
+          // initialize the random stream of this pixel
+          uint64_t state = static_cast<uint64_t>(index);
+          state = _splitmix64(state) ^ seed;
+
+          // choose one of the neighbors of the previous layer
+          int parents[4], n_parents = 0;
+          for (int k = 0; k < 4; ++k){
+            const int pos_y = y + directions_y[k], pos_x = x + directions_x[k];
+            if (pos_y >= 0 && pos_y < height && pos_x >= 0 && pos_x < width && distance[pos_y * width + pos_x] == d)
+              parents[n_parents++] = k;
+          }
+          const int k = parents[std::min(static_cast<int>(_uniform(state) * n_parents), n_parents - 1)];
+          const int valid_y = y + directions_y[k], valid_x = x + directions_x[k];
+
+          double value = img(valid_y, valid_x);
+          if (neighbors >= 1){
+            // choose one of the pixels of the previous layers, perpendicular to the direction of the chosen neighbor
+            const int tangent_y = directions_x[k], tangent_x = directions_y[k];
+            int count = 0;
+            for (int c = -neighbors; c <= neighbors; ++c){
+              const int pos_y = valid_y + c * tangent_y, pos_x = valid_x + c * tangent_x;
+              if (pos_y >= 0 && pos_y < height && pos_x >= 0 && pos_x < width && distance[pos_y * width + pos_x] >= 0 && distance[pos_y * width + pos_x] <= d)
+                ++count;
+            }
+            int chosen = std::min(static_cast<int>(_uniform(state) * count), count - 1);
+            for (int c = -neighbors; c <= neighbors; ++c){
+              const int pos_y = valid_y + c * tangent_y, pos_x = valid_x + c * tangent_x;
+              if (pos_y >= 0 && pos_y < height && pos_x >= 0 && pos_x < width && distance[pos_y * width + pos_x] >= 0 && distance[pos_y * width + pos_x] <= d && !chosen--){
+                value = img(pos_y, pos_x);
+                break;
+              }
+            }
+          }
+          if (random_factor){
+            // normal distributed factor with mean 1, using the Box-Muller transform
+            const double u1 = 1. - _uniform(state), u2 = _uniform(state);
+            value *= 1. + random_factor * std::sqrt(-2. * std::log(u1)) * std::cos(2. * M_PI * u2);
+          }
+          img(y, x) = _convert<T>(value);
+        }
+      });
+    }
+
+    const int unmasked = height * width - blitz::count(mask);
+    if (static_cast<int>(order.size()) < unmasked){
+      bob::core::warn << (unmasked - order.size()) << " pixels are not connected to the masked area and could not be filled";
+    }
+  }
+
 } } } // namespaces
 
 #endif // BOB_IP_BASE_AFFINE_H
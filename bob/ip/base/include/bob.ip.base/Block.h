@@ -10,6 +10,8 @@
 #ifndef BOB_IP_BASE_BLOCK_H
 #define BOB_IP_BASE_BLOCK_H
 
+#include <vector>
+#include <algorithm>
 #include <bob.core/assert.h>
 
 namespace bob { namespace ip { namespace base {
@@ -82,6 +84,25 @@ namespace bob { namespace ip { namespace base {
     if (overlap_w >= block_w) throw std::runtime_error((boost::format("setting `overlap_w' to %lu is outside the expected range [0, %lu]") % overlap_w % (block_w-1)).str());
   }
 
+  /**
+    * @brief Function which computes, for each of the given number of
+    *   positions along one axis, the first and the last of the n_blocks
+    *   blocks with the given size and step (i.e., block size minus
+    *   overlap) that contain it, see blockReference.
+    *   For positions outside of all blocks, first > last.
+    */
+  inline void _blockRange(
+    const int length, const int size, const int step, const int n_blocks,
+    std::vector<int>& first, std::vector<int>& last
+  ){
+    first.resize(length);
+    last.resize(length);
+    for (int i = 0; i < length; ++i){
+      first[i] = i < size ? 0 : (i - size) / step + 1;
+      last[i] = std::min(i / step, n_blocks - 1);
+    }
+  }
+
 
   /**
     * @brief Function which returns the expected shape of the output
@@ -91,26 +91,58 @@ namespace bob { namespace ip { namespace base {
 
       /**
         * @brief Process a 2D face image by applying the geometric
-        * normalization
+        * normalization; the output can be of any arithmetic type,
+        * e.g., float64, float32 or uint8 (see bob::ip::base::transform)
         */
-      template <typename T>
+      template <typename T, typename U>
       void extract(
         const blitz::Array<T,2>& src,
-        blitz::Array<double,2>& dst,
+        blitz::Array<U,2>& dst,
         const blitz::TinyVector<double,2>& rightEye,
         const blitz::TinyVector<double,2>& leftEye
       ) const;
 
-      template <typename T>
+      template <typename T, typename U>
       void extract(
         const blitz::Array<T,2>& src,
         const blitz::Array<bool,2>& srcMask,
-        blitz::Array<double,2>& dst,
+        blitz::Array<U,2>& dst,
         blitz::Array<bool,2>& dstMask,
         const blitz::TinyVector<double,2>& rightEye,
         const blitz::TinyVector<double,2>& leftEye
       ) const;
 
+      /**
+        * @brief Process several faces of the same 2D image at once.
+        * The eye positions of the k'th face are given as
+        * (right_y, right_x, left_y, left_x) in eyes(k,:), and the normalized
+        * face is written to dst(k,:,:). If parameters is non-empty, it must be
+        * of shape (N,4) and receives the (angle, scale, offset_y, offset_x)
+        * that were used for the k'th face.
+        * The faces are distributed over n_threads threads (see
+        * bob::ip::base::parallelFor); contrary to the single-face extract,
+        * the "last" angle, scale and offset of this object are not modified.
+        */
+      template <typename T, typename U>
+      void extract(
+        const blitz::Array<T,2>& src,
+        blitz::Array<U,3>& dst,
+        const blitz::Array<double,2>& eyes,
+        blitz::Array<double,2>& parameters,
+        const int n_threads = 1
+      ) const;
+
+      template <typename T, typename U>
+      void extract(
+        const blitz::Array<T,2>& src,
+        const blitz::Array<bool,2>& srcMask,
+        blitz::Array<U,3>& dst,
+        blitz::Array<bool,3>& dstMask,
+        const blitz::Array<double,2>& eyes,
+        blitz::Array<double,2>& parameters,
+        const int n_threads = 1
+      ) const;
+
       /**
        * @brief Getter function for the bob::ip::GeomNorm object that is doing the job.
        *
@@ -122,11 +154,34 @@ namespace bob { namespace ip { namespace base {
 
     private:
 
-      template <typename T, bool mask>
+      /**
+        * Computes the rotation angle, the scaling factor and the rotation
+        * center of the geometric normalization for the given eye positions
+        */
+      void computeParameters(
+        const blitz::TinyVector<double,2>& rightEye,
+        const blitz::TinyVector<double,2>& leftEye,
+        double& angle,
+        double& scale,
+        blitz::TinyVector<double,2>& center
+      ) const;
+
+      template <typename T, typename U, bool mask>
+      void processBatch(
+        const blitz::Array<T,2>& src,
+        const blitz::Array<bool,2>& srcMask,
+        blitz::Array<U,3>& dst,
+        blitz::Array<bool,3>& dstMask,
+        const blitz::Array<double,2>& eyes,
+        blitz::Array<double,2>& parameters,
+        const int n_threads
+      ) const;
+
+      template <typename T, typename U, bool mask>
       void processNoCheck(
         const blitz::Array<T,2>& src,
         const blitz::Array<bool,2>& srcMask,
-        blitz::Array<double,2>& dst,
+        blitz::Array<U,2>& dst,
         blitz::Array<bool,2>& dstMask,
         const blitz::TinyVector<double,2>& rightEye,
         const blitz::TinyVector<double,2>& leftEye
@@ -142,10 +197,10 @@ namespace bob { namespace ip { namespace base {
       mutable boost::shared_ptr<GeomNorm> m_geomNorm;
   };
 
-  template <typename T>
+  template <typename T, typename U>
   inline void FaceEyesNorm::extract(
     const blitz::Array<T,2>& src,
-    blitz::Array<double,2>& dst,
+    blitz::Array<U,2>& dst,
     const blitz::TinyVector<double,2>& rightEye,
     const blitz::TinyVector<double,2>& leftEye
   ) const
@@ -159,14 +214,14 @@ namespace bob { namespace ip { namespace base {
 
     // Process
     blitz::Array<bool,2> srcMask, dstMask;
-    processNoCheck<T,false>(src, srcMask, dst, dstMask, rightEye, leftEye);
+    processNoCheck<T,U,false>(src, srcMask, dst, dstMask, rightEye, leftEye);
   }
 
-  template <typename T>
+  template <typename T, typename U>
   inline void FaceEyesNorm::extract(
     const blitz::Array<T,2>& src,
     const blitz::Array<bool,2>& srcMask,
-    blitz::Array<double,2>& dst,
+    blitz::Array<U,2>& dst,
     blitz::Array<bool,2>& dstMask,
     const blitz::TinyVector<double,2>& rightEye,
     const blitz::TinyVector<double,2>& leftEye
@@ -184,32 +239,24 @@ namespace bob { namespace ip { namespace base {
     bob::core::array::assertSameShape(dst, m_geomNorm->getCropSize());
 
     // Process
-    processNoCheck<T,true>(src, srcMask, dst, dstMask, rightEye, leftEye);
+    processNoCheck<T,U,true>(src, srcMask, dst, dstMask, rightEye, leftEye);
   }
 
-  template <typename T, bool mask>
+  template <typename T, typename U, bool mask>
   inline void FaceEyesNorm::processNoCheck(
     const blitz::Array<T,2>& src,
     const blitz::Array<bool,2>& srcMask,
-    blitz::Array<double,2>& dst,
+    blitz::Array<U,2>& dst,
     blitz::Array<bool,2>& dstMask,
     const blitz::TinyVector<double,2>& rightEye,
     const blitz::TinyVector<double,2>& leftEye
   ) const
   {
-    // Get angle to horizontal
-    double dy = leftEye[0] - rightEye[0], dx = leftEye[1] - rightEye[1];
-    double angle = std::atan2(dy, dx);
-    m_geomNorm->setRotationAngle(angle * 180. / M_PI - m_eyesAngle);
-
-    // Get scaling factor
-    m_geomNorm->setScalingFactor(m_eyesDistance / sqrt(_sqr(leftEye[0]-rightEye[0]) + _sqr(leftEye[1]-rightEye[1])));
-
-    // Get the center (of the eye centers segment)
-    m_lastCenter = blitz::TinyVector<double,2>(
-      (rightEye[0] + leftEye[0]) / 2.,
-      (rightEye[1] + leftEye[1]) / 2.
-    );
+    // Get angle, scale and center of the normalization
+    double angle, scale;
+    computeParameters(rightEye, leftEye, angle, scale, m_lastCenter);
+    m_geomNorm->setRotationAngle(angle);
+    m_geomNorm->setScalingFactor(scale);
 
     // Perform the normalization
     if(mask)
@@ -218,6 +265,102 @@ namespace bob { namespace ip { namespace base {
       m_geomNorm->process(src, dst, m_lastCenter);
   }
 
+  template <typename T, typename U>
+  inline void FaceEyesNorm::extract(
+    const blitz::Array<T,2>& src,
+    blitz::Array<U,3>& dst,
+    const blitz::Array<double,2>& eyes,
+    blitz::Array<double,2>& parameters,
+    const int n_threads
+  ) const
+  {
+    // Check input
+    bob::core::array::assertZeroBase(src);
+
+    // Process
+    blitz::Array<bool,2> srcMask;
+    blitz::Array<bool,3> dstMask;
+    processBatch<T,U,false>(src, srcMask, dst, dstMask, eyes, parameters, n_threads);
+  }
+
+  template <typename T, typename U>
+  inline void FaceEyesNorm::extract(
+    const blitz::Array<T,2>& src,
+    const blitz::Array<bool,2>& srcMask,
+    blitz::Array<U,3>& dst,
+    blitz::Array<bool,3>& dstMask,
+    const blitz::Array<double,2>& eyes,
+    blitz::Array<double,2>& parameters,
+    const int n_threads
+  ) const
+  {
+    // Check input
+    bob::core::array::assertZeroBase(src);
+    bob::core::array::assertZeroBase(srcMask);
+    bob::core::array::assertSameShape(src,srcMask);
+
+    // Check output
+    bob::core::array::assertZeroBase(dstMask);
+    bob::core::array::assertSameShape(dst,dstMask);
+
+    // Process
+    processBatch<T,U,true>(src, srcMask, dst, dstMask, eyes, parameters, n_threads);
+  }
+
+  template <typename T, typename U, bool mask>
+  inline void FaceEyesNorm::processBatch(
+    const blitz::Array<T,2>& src,
+    const blitz::Array<bool,2>& srcMask,
+    blitz::Array<U,3>& dst,
+    blitz::Array<bool,3>& dstMask,
+    const blitz::Array<double,2>& eyes,
+    blitz::Array<double,2>& parameters,
+    const int n_threads
+  ) const
+  {
+    // Check input
+    bob::core::array::assertZeroBase(eyes);
+    const int n_items = eyes.extent(0);
+    bob::core::array::assertSameDimensionLength(eyes.extent(1), 4);
+
+    // Check output
+    const blitz::TinyVector<int,2>& cropSize = m_geomNorm->getCropSize();
+    bob::core::array::assertZeroBase(dst);
+    bob::core::array::assertSameDimensionLength(dst.extent(0), n_items);
+    bob::core::array::assertSameDimensionLength(dst.extent(1), cropSize[0]);
+    bob::core::array::assertSameDimensionLength(dst.extent(2), cropSize[1]);
+    if (parameters.size()){
+      bob::core::array::assertZeroBase(parameters);
+      bob::core::array::assertSameDimensionLength(parameters.extent(0), n_items);
+      bob::core::array::assertSameDimensionLength(parameters.extent(1), 4);
+    }
+
+    // Slice the outputs beforehand, since blitz reference counting is not thread-safe
+    std::vector<blitz::Array<U,2> > dstSlices(n_items);
+    std::vector<blitz::Array<bool,2> > dstMaskSlices(n_items);
+    for (int k = 0; k < n_items; ++k){
+      dstSlices[k].reference(dst(k, blitz::Range::all(), blitz::Range::all()));
+      if (mask) dstMaskSlices[k].reference(dstMask(k, blitz::Range::all(), blitz::Range::all()));
+    }
+
+    // Process, using only local copies of the normalization parameters
+    const blitz::TinyVector<double,2> cropOffset = m_geomNorm->getCropOffset();
+    parallelFor(n_items, n_threads, [&](int begin, int end){
+      for (int k = begin; k < end; ++k){
+        double angle, scale;
+        blitz::TinyVector<double,2> center;
+        computeParameters(blitz::TinyVector<double,2>(eyes(k,0), eyes(k,1)), blitz::TinyVector<double,2>(eyes(k,2), eyes(k,3)), angle, scale, center);
+        bob::ip::base::transform<T,mask>(src, srcMask, center, dstSlices[k], dstMaskSlices[k], cropOffset, blitz::TinyVector<double,2>(scale, scale), angle);
+        if (parameters.size()){
+          parameters(k,0) = angle;
+          parameters(k,1) = scale;
+          parameters(k,2) = center[0];
+          parameters(k,3) = center[1];
+        }
+      }
+    });
+  }
+
 } } } // namespaces
 
 #endif /* BOB_IP_BASE_FACE_EYES_NORM_H */
@@ -15,6 +15,7 @@
 #include <bob.core/check.h>
 
 #include <bob.ip.base/Affine.h>
+#include <bob.ip.base/Parallel.h>
 
 namespace bob { namespace ip { namespace base {
 
@@ -82,21 +83,33 @@ namespace bob { namespace ip { namespace base {
 
       /**
         * @brief Process a 2D blitz Array/Image by applying the geometric
-        * normalization
+        * normalization; the output can be of any arithmetic type,
+        * e.g., float64, float32 or uint8 (see bob::ip::base::transform)
         */
-      template <typename T>
-      void process(const blitz::Array<T,2>& src, blitz::Array<double,2>& dst, const blitz::TinyVector<double,2>& center) const;
-      template <typename T>
-      void process(const blitz::Array<T,2>& src, const blitz::Array<bool,2>& src_mask, blitz::Array<double,2>& dst, blitz::Array<bool,2>& dst_mask, const blitz::TinyVector<double,2>& center) const;
+      template <typename T, typename U>
+      void process(const blitz::Array<T,2>& src, blitz::Array<U,2>& dst, const blitz::TinyVector<double,2>& center) const;
+      template <typename T, typename U>
+      void process(const blitz::Array<T,2>& src, const blitz::Array<bool,2>& src_mask, blitz::Array<U,2>& dst, blitz::Array<bool,2>& dst_mask, const blitz::TinyVector<double,2>& center) const;
 
       /**
        * @brief Process a 3D blitz Array/Image by applying the geometric
        * normalization to each color plane
        */
-      template <typename T>
-      void process(const blitz::Array<T,3>& src, blitz::Array<double,3>& dst, const blitz::TinyVector<double,2>& center) const;
-      template <typename T>
-      void process(const blitz::Array<T,3>& src, const blitz::Array<bool,3>& src_mask, blitz::Array<double,3>& dst, blitz::Array<bool,3>& dst_mask, const blitz::TinyVector<double,2>& center) const;
+      template <typename T, typename U>
+      void process(const blitz::Array<T,3>& src, blitz::Array<U,3>& dst, const blitz::TinyVector<double,2>& center) const;
+      template <typename T, typename U>
+      void process(const blitz::Array<T,3>& src, const blitz::Array<bool,3>& src_mask, blitz::Array<U,3>& dst, blitz::Array<bool,3>& dst_mask, const blitz::TinyVector<double,2>& center) const;
+
+      /**
+       * @brief Process several crops of the same 2D blitz Array/Image at once.
+       * The k'th crop is centered at (centers(k,0), centers(k,1)) and written
+       * to dst(k,:,:). When non-empty, angles(k) and scales(k) replace the
+       * rotation angle and the scaling factor of this object for the k'th crop.
+       * The crops are distributed over n_threads threads (see
+       * bob::ip::base::parallelFor).
+       */
+      template <typename T, typename U>
+      void process(const blitz::Array<T,2>& src, blitz::Array<U,3>& dst, const blitz::Array<double,2>& centers, const blitz::Array<double,1>& angles, const blitz::Array<double,1>& scales, const int n_threads = 1) const;
 
       /**
        * @brief applies the geometric normalization to the given input position
@@ -113,8 +126,8 @@ namespace bob { namespace ip { namespace base {
       blitz::TinyVector<double,2> m_crop_offset;
   };
 
-  template <typename T>
-  void GeomNorm::process(const blitz::Array<T,2>& src, blitz::Array<double,2>& dst, const blitz::TinyVector<double,2>& center) const
+  template <typename T, typename U>
+  void GeomNorm::process(const blitz::Array<T,2>& src, blitz::Array<U,2>& dst, const blitz::TinyVector<double,2>& center) const
   {
     // Check input
     bob::core::array::assertZeroBase(src);
@@ -129,8 +142,8 @@ namespace bob { namespace ip { namespace base {
     bob::ip::base::transform<T,false>(src, src_mask, center, dst, dst_mask, m_crop_offset, blitz::TinyVector<double,2>(m_scaling_factor, m_scaling_factor), m_rotation_angle);
   }
 
-  template <typename T>
-  void GeomNorm::process(const blitz::Array<T,2>& src, const blitz::Array<bool,2>& src_mask, blitz::Array<double,2>& dst, blitz::Array<bool,2>& dst_mask, const blitz::TinyVector<double,2>& center) const
+  template <typename T, typename U>
+  void GeomNorm::process(const blitz::Array<T,2>& src, const blitz::Array<bool,2>& src_mask, blitz::Array<U,2>& dst, blitz::Array<bool,2>& dst_mask, const blitz::TinyVector<double,2>& center) const
   {
     // Check input
     bob::core::array::assertZeroBase(src);
@@ -148,13 +161,13 @@ namespace bob { namespace ip { namespace base {
     bob::ip::base::transform<T,true>(src, src_mask, center, dst, dst_mask, m_crop_offset, blitz::TinyVector<double,2>(m_scaling_factor, m_scaling_factor), m_rotation_angle);
   }
 
-  template <typename T>
-  void GeomNorm::process(const blitz::Array<T,3>& src, blitz::Array<double,3>& dst, const blitz::TinyVector<double,2>& center) const
+  template <typename T, typename U>
+  void GeomNorm::process(const blitz::Array<T,3>& src, blitz::Array<U,3>& dst, const blitz::TinyVector<double,2>& center) const
   {
     for( int p=0; p<dst.extent(0); ++p) {
       const blitz::Array<T,2> src_slice =
         src( p, blitz::Range::all(), blitz::Range::all() );
-      blitz::Array<double,2> dst_slice =
+      blitz::Array<U,2> dst_slice =
         dst( p, blitz::Range::all(), blitz::Range::all() );
 
       // Process one plane
@@ -162,13 +175,13 @@ namespace bob { namespace ip { namespace base {
     }
   }
 
-  template <typename T>
-  void GeomNorm::process(const blitz::Array<T,3>& src, const blitz::Array<bool,3>& src_mask, blitz::Array<double,3>& dst, blitz::Array<bool,3>& dst_mask, const blitz::TinyVector<double,2>& center) const
+  template <typename T, typename U>
+  void GeomNorm::process(const blitz::Array<T,3>& src, const blitz::Array<bool,3>& src_mask, blitz::Array<U,3>& dst, blitz::Array<bool,3>& dst_mask, const blitz::TinyVector<double,2>& center) const
   {
     for( int p=0; p<dst.extent(0); ++p) {
       const blitz::Array<T,2> src_slice = src( p, blitz::Range::all(), blitz::Range::all() );
       const blitz::Array<bool,2> src_mask_slice = src_mask( p, blitz::Range::all(), blitz::Range::all() );
-      blitz::Array<double,2> dst_slice = dst( p, blitz::Range::all(), blitz::Range::all() );
+      blitz::Array<U,2> dst_slice = dst( p, blitz::Range::all(), blitz::Range::all() );
       blitz::Array<bool,2> dst_mask_slice = dst_mask( p, blitz::Range::all(), blitz::Range::all() );
 
       // Process one plane
@@ -176,6 +189,40 @@ namespace bob { namespace ip { namespace base {
     }
   }
 
+  template <typename T, typename U>
+  void GeomNorm::process(const blitz::Array<T,2>& src, blitz::Array<U,3>& dst, const blitz::Array<double,2>& centers, const blitz::Array<double,1>& angles, const blitz::Array<double,1>& scales, const int n_threads) const
+  {
+    // Check input
+    bob::core::array::assertZeroBase(src);
+    bob::core::array::assertZeroBase(centers);
+    const int n_items = centers.extent(0);
+    bob::core::array::assertSameDimensionLength(centers.extent(1), 2);
+    if (angles.size()) bob::core::array::assertSameDimensionLength(angles.extent(0), n_items);
+    if (scales.size()) bob::core::array::assertSameDimensionLength(scales.extent(0), n_items);
+
+    // Check output
+    bob::core::array::assertZeroBase(dst);
+    bob::core::array::assertSameDimensionLength(dst.extent(0), n_items);
+    bob::core::array::assertSameDimensionLength(dst.extent(1), m_crop_size[0]);
+    bob::core::array::assertSameDimensionLength(dst.extent(2), m_crop_size[1]);
+
+    // Slice the output beforehand, since blitz reference counting is not thread-safe
+    std::vector<blitz::Array<U,2> > dst_slices(n_items);
+    for (int k = 0; k < n_items; ++k){
+      dst_slices[k].reference(dst(k, blitz::Range::all(), blitz::Range::all()));
+    }
+
+    // Process
+    parallelFor(n_items, n_threads, [&](int begin, int end){
+      blitz::Array<bool,2> src_mask, dst_mask;
+      for (int k = begin; k < end; ++k){
+        const double angle = angles.size() ? angles(k) : m_rotation_angle;
+        const double scale = scales.size() ? scales(k) : m_scaling_factor;
+        bob::ip::base::transform<T,false>(src, src_mask, blitz::TinyVector<double,2>(centers(k,0), centers(k,1)), dst_slices[k], dst_mask, m_crop_offset, blitz::TinyVector<double,2>(scale, scale), angle);
+      }
+    });
+  }
+
 } } } // namespaces
 
 #endif // BOB_IP_BASE_GEOM_NORM_H
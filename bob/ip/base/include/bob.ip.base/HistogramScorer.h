@@ -0,0 +1,358 @@
+/**
+ * @date Sat Oct 17 18:42:17 CEST 2026
+ *
+ * This file defines a class that compares histogram sequences, e.g., LBPHS features, to many enrolled templates
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#ifndef BOB_IP_BASE_HISTOGRAM_SCORER_H
+#define BOB_IP_BASE_HISTOGRAM_SCORER_H
+
+#include <cmath>
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+#include <boost/format.hpp>
+#include <boost/thread/shared_mutex.hpp>
+#include <boost/thread/locks.hpp>
+#include <blitz/array.h>
+
+#include <bob.core/assert.h>
+#include <bob.ip.base/Parallel.h>
+
+namespace bob { namespace ip { namespace base {
+
+  /**
+   * The measures that can be used to compare histograms
+   */
+  typedef enum{
+    HISTOGRAM_CHI_SQUARE = 0,   //!< chi-square distance sum((p-t)^2 / (p+t)); lower values are better
+    HISTOGRAM_INTERSECTION = 1  //!< histogram intersection sum(min(p,t)); higher values are better
+  } HistogramMeasure;
+
+  /**
+   * @brief This class stores the histogram sequences of many enrolled
+   * templates, e.g., LBPHS features of shape (#blocks, #bins), and compares
+   * probe histogram sequences to all of them.
+   *
+   * The score of a template is the weighted sum of the scores of its blocks,
+   * where all block weights are 1 by default.
+   * In compact mode, the templates are stored as 16 bit counts, which is
+   * suitable for non-normalized LBPHS features; otherwise they are stored as
+   * 32 bit floating point values. The scores are computed in single precision
+   * per block, and accumulated in double precision over the blocks.
+   *
+   * Templates can be enrolled while other threads score probes; enrollment
+   * waits until all running scorings are finished, and vice versa.
+   */
+  class HistogramScorer {
+
+    public:
+
+      /**
+       * @brief Creates an empty scorer for histogram sequences of the given shape (#blocks, #bins)
+       */
+      HistogramScorer(const blitz::TinyVector<int,2>& histogram_shape, const HistogramMeasure measure = HISTOGRAM_CHI_SQUARE, const bool compact = true);
+
+      /**
+       * @brief Copy constructor; the templates are copied
+       */
+      HistogramScorer(const HistogramScorer& other);
+
+      /**
+       * @brief Destructor
+       */
+      virtual ~HistogramScorer();
+
+      /**
+       * @brief Assignment
+       */
+      HistogramScorer& operator=(const HistogramScorer& other);
+
+      /**
+       * @brief Accessors
+       */
+      const blitz::TinyVector<int,2>& getHistogramShape() const { return m_shape; }
+      HistogramMeasure getMeasure() const { return m_measure; }
+      bool isCompact() const { return m_compact; }
+      int getNumberOfTemplates() const { boost::shared_lock<boost::shared_mutex> lock(m_mutex); return m_n_templates; }
+      const blitz::Array<double,1>& getWeights() const { return m_weights; }
+
+      /**
+       * @brief Mutators; the weights are one per block, an empty array resets all weights to 1
+       */
+      void setMeasure(const HistogramMeasure measure) { boost::unique_lock<boost::shared_mutex> lock(m_mutex); m_measure = measure; }
+      void setWeights(const blitz::Array<double,1>& weights);
+
+      /**
+       * @brief Returns true, if score a is better than score b for the current measure
+       */
+      bool isBetter(const double a, const double b) const { return m_measure == HISTOGRAM_CHI_SQUARE ? a < b : a > b; }
+
+      /**
+       * @brief Enrolls one template with the given histogram sequence of shape (#blocks, #bins).
+       * All values need to be finite; in compact mode, they need to be integral values in [0, 65535].
+       */
+      template <typename T>
+        void enroll(const blitz::Array<T,2>& histograms);
+
+      /**
+       * @brief Enrolls several templates with the given histogram sequences of shape (#templates, #blocks, #bins)
+       */
+      template <typename T>
+        void enroll(const blitz::Array<T,3>& histograms);
+
+      /**
+       * @brief Removes all templates
+       */
+      void clear();
+
+      /**
+       * @brief Compares the given probe histogram sequence to all templates,
+       * and writes one score per template into scores.
+       * The templates are processed by n_threads threads; if n_threads is 0 or negative, all hardware threads are used.
+       */
+      template <typename T>
+        void score(const blitz::Array<T,2>& probe, blitz::Array<double,1>& scores, const int n_threads = 1) const;
+
+      /**
+       * @brief Compares the given probe histogram sequence to all templates,
+       * and writes the indices and scores of the indices.extent(0) best templates, ordered from best to worst.
+       */
+      template <typename T>
+        void best(const blitz::Array<T,2>& probe, blitz::Array<int,1>& indices, blitz::Array<double,1>& scores, const int n_threads = 1) const;
+
+    private:
+
+      /**
+       * @brief Checks the shape of the given histogram sequence
+       */
+      void checkShape(const blitz::TinyVector<int,2>& shape) const;
+
+      /**
+       * @brief Checks the shape and the values of the given histogram sequence, see enroll
+       */
+      template <typename T>
+        void checkValues(const blitz::Array<T,2>& histograms) const;
+
+      /**
+       * @brief Appends the checked histogram sequence to the template storage; the mutex needs to be locked exclusively
+       */
+      template <typename T, typename U>
+        void append(const blitz::Array<T,2>& histograms, std::vector<U>& storage);
+
+      /**
+       * @brief Computes the scores of all templates for the given contiguous probe histogram sequence
+       */
+      void score_(const std::vector<float>& probe, double* scores, const int n_threads) const;
+
+      /**
+       * @brief Computes the scores of all templates of the given storage
+       */
+      template <typename U>
+        void score_(const std::vector<float>& probe, const std::vector<U>& storage, double* scores, const int n_threads) const;
+
+      /**
+       * @brief Copies the given probe histogram sequence into a contiguous single precision buffer, rejecting non-finite values
+       */
+      template <typename T>
+        std::vector<float> prepare(const blitz::Array<T,2>& probe) const;
+
+      blitz::TinyVector<int,2> m_shape;
+      HistogramMeasure m_measure;
+      bool m_compact;
+      blitz::Array<double,1> m_weights;
+
+      int m_n_templates;
+      std::vector<uint16_t> m_counts;
+      std::vector<float> m_values;
+
+      // enrollment and mutators lock exclusively, scoring locks shared
+      mutable boost::shared_mutex m_mutex;
+  };
+
+  /**
+   * The chi-square distance of two histograms of length n.
+   * Four partial sums are used, so that the compiler can vectorize the loop without changing the order of the additions.
+   */
+  template <typename U>
+    static inline float _chiSquare(const float* probe, const U* model, const int n){
+      float sum[4] = {0.f, 0.f, 0.f, 0.f};
+      int i = 0;
+      for (; i + 4 <= n; i += 4){
+        for (int j = 0; j < 4; ++j){
+          const float p = probe[i+j], t = static_cast<float>(model[i+j]);
+          const float s = p + t, d = p - t;
+          sum[j] += s > 0.f ? d * d / s : 0.f;
+        }
+      }
+      for (; i < n; ++i){
+        const float p = probe[i], t = static_cast<float>(model[i]);
+        const float s = p + t, d = p - t;
+        sum[0] += s > 0.f ? d * d / s : 0.f;
+      }
+      return (sum[0] + sum[1]) + (sum[2] + sum[3]);
+    }
+
+  /**
+   * The intersection of two histograms of length n, see _chiSquare.
+   */
+  template <typename U>
+    static inline float _histogramIntersection(const float* probe, const U* model, const int n){
+      float sum[4] = {0.f, 0.f, 0.f, 0.f};
+      int i = 0;
+      for (; i + 4 <= n; i += 4){
+        for (int j = 0; j < 4; ++j)
+          sum[j] += std::min(probe[i+j], static_cast<float>(model[i+j]));
+      }
+      for (; i < n; ++i)
+        sum[0] += std::min(probe[i], static_cast<float>(model[i]));
+      return (sum[0] + sum[1]) + (sum[2] + sum[3]);
+    }
+
+  template <typename T>
+    inline void HistogramScorer::checkValues(const blitz::Array<T,2>& histograms) const
+  {
+    checkShape(histograms.shape());
+    for (int b = 0; b < m_shape[0]; ++b){
+      for (int l = 0; l < m_shape[1]; ++l){
+        const double value = static_cast<double>(histograms(b + histograms.lbound(0), l + histograms.lbound(1)));
+        if (!std::isfinite(static_cast<float>(value)))
+          throw std::runtime_error((boost::format("The histogram value %g of block %d and bin %d is not finite in single precision") % value % b % l).str());
+        if (m_compact && (value < 0. || value > std::numeric_limits<uint16_t>::max() || value != std::floor(value)))
+          throw std::runtime_error((boost::format("The histogram value %g of block %d and bin %d cannot be stored as 16 bit count; use non-compact storage for normalized histograms") % value % b % l).str());
+      }
+    }
+  }
+
+  template <typename T, typename U>
+    inline void HistogramScorer::append(const blitz::Array<T,2>& histograms, std::vector<U>& storage)
+  {
+    storage.reserve(storage.size() + m_shape[0] * m_shape[1]);
+    for (int b = 0; b < m_shape[0]; ++b)
+      for (int l = 0; l < m_shape[1]; ++l)
+        storage.push_back(static_cast<U>(histograms(b + histograms.lbound(0), l + histograms.lbound(1))));
+    ++m_n_templates;
+  }
+
+  template <typename T>
+    inline void HistogramScorer::enroll(const blitz::Array<T,2>& histograms)
+  {
+    checkValues(histograms);
+    boost::unique_lock<boost::shared_mutex> lock(m_mutex);
+    if (m_compact)
+      append(histograms, m_counts);
+    else
+      append(histograms, m_values);
+  }
+
+  template <typename T>
+    inline void HistogramScorer::enroll(const blitz::Array<T,3>& histograms)
+  {
+    checkShape(blitz::TinyVector<int,2>(histograms.extent(1), histograms.extent(2)));
+    // check all histogram sequences before any of them is appended
+    std::vector<blitz::Array<T,2> > templates;
+    for (int i = histograms.lbound(0); i <= histograms.ubound(0); ++i){
+      templates.push_back(histograms(i, blitz::Range::all(), blitz::Range::all()));
+      checkValues(templates.back());
+    }
+    boost::unique_lock<boost::shared_mutex> lock(m_mutex);
+    for (size_t i = 0; i < templates.size(); ++i){
+      if (m_compact)
+        append(templates[i], m_counts);
+      else
+        append(templates[i], m_values);
+    }
+  }
+
+  template <typename T>
+    inline std::vector<float> HistogramScorer::prepare(const blitz::Array<T,2>& probe) const
+  {
+    checkShape(probe.shape());
+    std::vector<float> buffer;
+    buffer.reserve(m_shape[0] * m_shape[1]);
+    for (int b = probe.lbound(0); b <= probe.ubound(0); ++b){
+      for (int l = probe.lbound(1); l <= probe.ubound(1); ++l){
+        const float value = static_cast<float>(probe(b,l));
+        if (!std::isfinite(value))
+          throw std::runtime_error((boost::format("The probe value %g of block %d and bin %d is not finite in single precision") % static_cast<double>(probe(b,l)) % (b - probe.lbound(0)) % (l - probe.lbound(1))).str());
+        buffer.push_back(value);
+      }
+    }
+    return buffer;
+  }
+
+  template <typename U>
+    inline void HistogramScorer::score_(const std::vector<float>& probe, const std::vector<U>& storage, double* scores, const int n_threads) const
+  {
+    const int n_blocks = m_shape[0], n_bins = m_shape[1];
+    const double* weights = m_weights.size() ? m_weights.data() : 0;
+    const U* data = storage.data();
+    const bool chi_square = m_measure == HISTOGRAM_CHI_SQUARE;
+    parallelFor(m_n_templates, n_threads, [&](int begin, int end){
+      for (int i = begin; i < end; ++i){
+        const U* model = data + static_cast<size_t>(i) * n_blocks * n_bins;
+        const float* p = probe.data();
+        double score = 0.;
+        for (int b = 0; b < n_blocks; ++b, p += n_bins, model += n_bins){
+          const double s = chi_square ? _chiSquare(p, model, n_bins) : _histogramIntersection(p, model, n_bins);
+          score += weights ? weights[b] * s : s;
+        }
+        scores[i] = score;
+      }
+    });
+  }
+
+  template <typename T>
+    inline void HistogramScorer::score(const blitz::Array<T,2>& probe, blitz::Array<double,1>& scores, const int n_threads) const
+  {
+    const std::vector<float> p = prepare(probe);
+    boost::shared_lock<boost::shared_mutex> lock(m_mutex);
+    bob::core::array::assertZeroBase(scores);
+    bob::core::array::assertSameShape(scores, blitz::TinyVector<int,1>(m_n_templates));
+    if (scores.stride(0) == 1){
+      score_(p, scores.data(), n_threads);
+    } else {
+      std::vector<double> s(m_n_templates);
+      score_(p, s.data(), n_threads);
+      for (int i = 0; i < m_n_templates; ++i) scores(i) = s[i];
+    }
+  }
+
+  template <typename T>
+    inline void HistogramScorer::best(const blitz::Array<T,2>& probe, blitz::Array<int,1>& indices, blitz::Array<double,1>& scores, const int n_threads) const
+  {
+    bob::core::array::assertZeroBase(indices);
+    bob::core::array::assertZeroBase(scores);
+    bob::core::array::assertSameShape(scores, indices.shape());
+    const std::vector<float> p = prepare(probe);
+    boost::shared_lock<boost::shared_mutex> lock(m_mutex);
+    const int k = indices.extent(0);
+    if (k > m_n_templates)
+      throw std::runtime_error((boost::format("Cannot select the %d best of %d templates") % k % m_n_templates).str());
+
+    std::vector<double> s(m_n_templates);
+    score_(p, s.data(), n_threads);
+    const bool lower_is_better = m_measure == HISTOGRAM_CHI_SQUARE;
+    lock.unlock();
+
+    // select the k best templates; ties are resolved by the template index, and NaN scores are the worst
+    const int n_templates = s.size();
+    std::vector<int> order(n_templates);
+    for (int i = 0; i < n_templates; ++i) order[i] = i;
+    std::partial_sort(order.begin(), order.begin() + k, order.end(), [&](int a, int b){
+      const bool nan_a = std::isnan(s[a]), nan_b = std::isnan(s[b]);
+      if (nan_a || nan_b) return nan_b && (!nan_a || a < b);
+      return (lower_is_better ? s[a] < s[b] : s[a] > s[b]) || (s[a] == s[b] && a < b);
+    });
+    for (int i = 0; i < k; ++i){
+      indices(i) = order[i];
+      scores(i) = s[order[i]];
+    }
+  }
+
+} } } // namespaces
+
+#endif // BOB_IP_BASE_HISTOGRAM_SCORER_H
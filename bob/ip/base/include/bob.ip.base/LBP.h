@@ -16,18 +16,25 @@
 
 #include <math.h>
 #include <stdint.h>
+#include <cstdlib>
 #include <numeric>
+#include <limits>
+#include <type_traits>
 #include <stdexcept>
+#include <vector>
+#include <algorithm>
 #include <boost/format.hpp>
 
 #include <blitz/array.h>
 
 #include <bob.core/assert.h>
 #include <bob.core/cast.h>
-#include <bob.sp/interpolate.h>
 #include <bob.io.base/HDF5File.h>
 
 #include <bob.ip.base/IntegralImage.h>
+#include <bob.ip.base/Block.h>
+#include <bob.ip.base/Parallel.h>
+#include <bob.ip.base/PreparedImage.h>
 
 
 namespace bob { namespace ip { namespace base {
@@ -59,6 +66,8 @@ namespace bob { namespace ip { namespace base {
    *   "Multivariate Boosting with Look-Up Tables for Face Processing"
    *   http://publications.idiap.ch/index.php/publications/show/2315
    *
+   *   The extraction functions do not modify the LBP object, so that a
+   *   configured object can be used by several threads at the same time.
    */
   class LBP {
 
@@ -225,10 +234,12 @@ namespace bob { namespace ip { namespace base {
        * Extract LBP features from a 2D blitz::Array, and save
        *   the resulting LBP codes in the dst 2D blitz::Array.
        *   For multi-block LBP types, the given image might be an integral image.
-       *   Please set is_integral_image to true in this case
+       *   Please set is_integral_image to true in this case.
+       *   The rows of the output image are split into bands, which are processed by n_threads threads;
+       *   if n_threads is 0 or negative, all hardware threads are used.
        */
       template <typename T>
-        void extract(const blitz::Array<T,2>& src, blitz::Array<uint16_t,2>& dst, bool is_integral_image = false) const;
+        void extract(const blitz::Array<T,2>& src, blitz::Array<uint16_t,2>& dst, bool is_integral_image = false, const int n_threads = 1) const;
 
       /**
        * Extract LBP features from a 2D blitz::Array, and save
@@ -238,7 +249,21 @@ namespace bob { namespace ip { namespace base {
        *   This function does not perform any kind of checks.
        */
       template <typename T>
-        void extract_(const blitz::Array<T,2>& src, blitz::Array<uint16_t,2>& dst, bool is_integral_image = false) const;
+        void extract_(const blitz::Array<T,2>& src, blitz::Array<uint16_t,2>& dst, bool is_integral_image = false, const int n_threads = 1) const;
+
+      /**
+       * Extract LBP features from a 2D blitz::Array, and add each code
+       *   to the histograms (rows of dst) of all blocks of the LBP image
+       *   with the given block size and overlap that contain it, see bob::ip::base::lbphs.
+       *   The LBP image is not stored; only one row of LBP codes is kept at a time.
+       *   When sliding_window is enabled, the histogram of each block is instead derived from the one of its left neighbor,
+       *   by removing the codes of the columns that leave the block and adding the codes of the columns that enter it,
+       *   keeping the LBP codes of one row of blocks at a time.
+       *   This is faster for heavily overlapping blocks, as the costs do not grow with the block overlap.
+       *   This function does not perform any kind of checks, and it does not reset dst.
+       */
+      template <typename T>
+        void extractHistograms_(const blitz::Array<T,2>& src, const blitz::TinyVector<int,2>& block_size, const blitz::TinyVector<int,2>& block_overlap, blitz::Array<uint64_t,2>& dst, bool sliding_window = false) const;
 
 
       /**
@@ -261,6 +286,21 @@ namespace bob { namespace ip { namespace base {
       template <typename T>
         uint16_t extract_(const blitz::Array<T,2>& src, int y, int x, bool is_integral_image = false) const;
 
+      /**
+       * Extract LBP features from a prepared image, and save
+       *   the resulting LBP codes in the dst 2D blitz::Array.
+       *   For multi-block LBP types, the integral image of the prepared image is used,
+       *   which is computed only once, however often the prepared image is used.
+       */
+      void extract(const PreparedImage& src, blitz::Array<uint16_t,2>& dst, const int n_threads = 1) const;
+
+      /**
+       * Extract the LBP code of a prepared image at the given
+       *   location, and return it.
+       *   For multi-block LBP types, the integral image of the prepared image is used.
+       */
+      uint16_t extract(const PreparedImage& src, int y, int x) const;
+
 
       /**
        * Get the required shape of the dst output blitz array,
@@ -280,6 +320,11 @@ namespace bob { namespace ip { namespace base {
 
     private:
 
+      // the multi-scale extractor computes the LBP images of several LBP's from the same integral image
+      friend class MultiScaleLBP;
+      // the feature set evaluates the LBP codes of several LBP's at many positions without checks
+      friend class LBPFeatureSet;
+
       /**
        * Initialize the look up table and the relative positions for the current setup
        */
@@ -294,9 +339,81 @@ namespace bob { namespace ip { namespace base {
        * Computes the LBP image from the given image.
        * For multi-block LBP features, the src image must be an integral image,
        * for other types of LBP it is not.
+       * Only the rows [y_begin, y_end) of the dst image are computed.
+       */
+      template <typename T>
+        void apply(const blitz::Array<T,2>& src, blitz::Array<uint16_t,2>& dst, const int y_begin, const int y_end) const;
+
+      /**
+       * Adds the LBP codes of the given image, which is an integral image for multi-block LBP's, to the block histograms, see extractHistograms_.
+       * The lbp_shape is the shape of the LBP image of the original image.
+       */
+      template <typename T>
+        void accumulateHistograms(const blitz::Array<T,2>& src, const blitz::TinyVector<int,2>& lbp_shape, const blitz::TinyVector<int,2>& block_size, const blitz::TinyVector<int,2>& block_overlap, blitz::Array<uint64_t,2>& dst, bool sliding_window) const;
+
+      /**
+       * Same as accumulateHistograms, but the block histograms are slid along each row of blocks, see extractHistograms_.
+       */
+      template <typename T>
+        void slideHistograms(const blitz::Array<T,2>& src, const blitz::TinyVector<int,2>& lbp_shape, const blitz::TinyVector<int,2>& block_size, const blitz::TinyVector<int,2>& block_overlap, blitz::Array<uint64_t,2>& dst) const;
+
+      /**
+       * Functors that are called with the integral image of the source image, see _withIntegralImage.
+       */
+      struct ApplyIntegral;
+      struct HistogramsIntegral;
+      struct CodeIntegral;
+
+      /**
+       * Returns true, if the LBP codes can be computed by one of the kernels that are specialized for the number of neighbors and the LBP type.
+       * This is the case for rectangular, circular and multi-block LBP's with 4, 8 or 16 neighbors and shrinking borders, which are not compared to the average.
+       */
+      bool isSpecialized() const {
+        return !m_to_average && !m_add_average_bit && m_border_handling == LBP_BORDER_SHRINK && (m_P == 4 || m_P == 8 || m_P == 16);
+      }
+
+      /**
+       * Selects the specialized kernel for the current LBP type and the given number of neighbors P.
+       */
+      template <typename T, int P>
+        void applySpecialized(const blitz::Array<T,2>& src, blitz::Array<uint16_t,2>& dst, const int y_begin, const int y_end) const;
+
+      /**
+       * Selects the specialized multi-block, circular or rectangular kernel for the given number of neighbors P and LBP type E.
+       */
+      template <typename T, int P, ELBPType E>
+        void applyKernel(const blitz::Array<T,2>& src, blitz::Array<uint16_t,2>& dst, const int y_begin, const int y_end) const;
+
+      /**
+       * Computes the multi-block LBP image from the given integral image.
+       * The number of neighbors P and the LBP type E are template parameters.
+       * Block sums of integer integral images are computed and compared exactly.
+       */
+      template <typename T, int P, ELBPType E>
+        void applyMultiBlock(const blitz::Array<T,2>& src, blitz::Array<uint16_t,2>& dst, const int y_begin, const int y_end) const;
+
+      /**
+       * Computes the LBP image row by row, comparing whole rows of neighbors with the center row.
+       * The number of neighbors P and the LBP type E are template parameters, so that the loop over the neighbors is unrolled.
+       * Images of integral types are compared exactly.
+       */
+      template <typename T, int P, ELBPType E>
+        void applyRectangular(const blitz::Array<T,2>& src, blitz::Array<uint16_t,2>& dst, const int y_begin, const int y_end) const;
+
+      /**
+       * Computes the circular or elliptical LBP image with shrinking borders,
+       * interpolating the neighbors with the pre-computed bi-linear taps and weights.
+       * The number of neighbors P and the LBP type E are template parameters.
+       */
+      template <typename T, int P, ELBPType E>
+        void applyCircular(const blitz::Array<T,2>& src, blitz::Array<uint16_t,2>& dst, const int y_begin, const int y_end) const;
+
+      /**
+       * Computes the circular or elliptical LBP image with shrinking borders for any configuration,
+       * interpolating the neighbors with the pre-computed bi-linear taps and weights.
        */
       template <typename T>
-        void apply(const blitz::Array<T,2>& src, blitz::Array<uint16_t,2>& dst) const;
+        void applyCircularGeneric(const blitz::Array<T,2>& src, blitz::Array<uint16_t,2>& dst, const int y_begin, const int y_end) const;
 
       /**
        * Extract the LBP code of a 2D blitz::Array at the given location, and return it.
@@ -306,6 +423,13 @@ namespace bob { namespace ip { namespace base {
       template <typename T>
         uint16_t lbp_code(const blitz::Array<T,2>& src, int y, int x) const;
 
+      /**
+       * Computes the LBP code from the given neighbor pixels and the given center pixel.
+       * Pixels of integral type (such as block sums of integer integral images) are compared exactly.
+       */
+      template <typename V>
+        uint16_t lbp_code(const V* pixels, const V center) const;
+
 
       /**
        * Attributes
@@ -330,13 +454,10 @@ namespace bob { namespace ip { namespace base {
 
       // the positions of the points that have to be processed
       blitz::Array<double, 2> m_positions;
+      // for circular LBP's, the rows and columns of the four bi-linear interpolation taps of each point
       blitz::Array<int, 2> m_int_positions;
-
-      // a pre-allocated copy of the integral image, just for speed purposes
-      mutable blitz::Array<double, 2> _integral_image;
-
-      // a pre-allocated vector to store the pixels for extracting LBP codes
-      mutable std::vector<double> _pixels;
+      // for circular LBP's, the bi-linear interpolation weights of the four taps of each point
+      blitz::Array<double, 2> m_weights;
   };
 
   ///////////////////////////////////////////////////
@@ -344,39 +465,416 @@ namespace bob { namespace ip { namespace base {
   ///////////////////////////////////////////////////
 
   template <typename T>
-    inline void LBP::extract(const blitz::Array<T,2>& src, blitz::Array<uint16_t,2>& dst, bool is_integral_image) const
+    inline void LBP::extract(const blitz::Array<T,2>& src, blitz::Array<uint16_t,2>& dst, bool is_integral_image, const int n_threads) const
     {
       bob::core::array::assertZeroBase(src);
       bob::core::array::assertZeroBase(dst);
       bob::core::array::assertSameShape(dst, getLBPShape(src.shape(), is_integral_image) );
-      extract_<T>(src, dst, is_integral_image);
+      extract_<T>(src, dst, is_integral_image, n_threads);
+    }
+
+  /**
+   * Returns the number of bits of the unsigned integer type that can hold the integral image of the given image without overflow,
+   * or 0 if the image is not of an unsigned integral type and its integral image needs to be computed in double precision.
+   */
+  template <typename T>
+  static inline int _integralType(const blitz::Array<T,2>& src){
+    if (!std::numeric_limits<T>::is_integer || std::numeric_limits<T>::is_signed) return 0;
+    const double max_sum = static_cast<double>(std::numeric_limits<T>::max()) * src.extent(0) * src.extent(1);
+    if (max_sum <= static_cast<double>(std::numeric_limits<uint32_t>::max())) return 32;
+    if (max_sum <= static_cast<double>(std::numeric_limits<uint64_t>::max())) return 64;
+    return 0;
+  }
+
+  /**
+   * Computes the integral image of the given image, using the type selected by _integralType, and calls function(integral_image).
+   * The function needs to accept integral images of types uint32_t, uint64_t and double.
+   */
+  template <typename T, typename F>
+  static inline void _withIntegralImage(const blitz::Array<T,2>& src, const F& function){
+    switch (_integralType(src)){
+      case 32:{
+        blitz::Array<uint32_t,2> integral_image(src.extent(0)+1, src.extent(1)+1);
+        bob::ip::base::integral(src, integral_image, true);
+        function(integral_image);
+        break;
+      }
+      case 64:{
+        blitz::Array<uint64_t,2> integral_image(src.extent(0)+1, src.extent(1)+1);
+        bob::ip::base::integral(src, integral_image, true);
+        function(integral_image);
+        break;
+      }
+      default:{
+        blitz::Array<double,2> integral_image(src.extent(0)+1, src.extent(1)+1);
+        bob::ip::base::integral(src, integral_image, true);
+        function(integral_image);
+      }
     }
+  }
+
+  struct LBP::ApplyIntegral{
+    const LBP& lbp;
+    blitz::Array<uint16_t,2>& dst;
+    const int n_threads;
+    template <typename U>
+      void operator()(const blitz::Array<U,2>& integral_image) const {
+        parallelFor(dst.extent(0), n_threads, [&](int begin, int end){ lbp.apply<U>(integral_image, dst, begin, end); });
+      }
+  };
+
+  struct LBP::HistogramsIntegral{
+    const LBP& lbp;
+    const blitz::TinyVector<int,2>& lbp_shape;
+    const blitz::TinyVector<int,2>& block_size;
+    const blitz::TinyVector<int,2>& block_overlap;
+    blitz::Array<uint64_t,2>& dst;
+    const bool sliding_window;
+    template <typename U>
+      void operator()(const blitz::Array<U,2>& integral_image) const {
+        lbp.accumulateHistograms(integral_image, lbp_shape, block_size, block_overlap, dst, sliding_window);
+      }
+  };
+
+  struct LBP::CodeIntegral{
+    const LBP& lbp;
+    const int y, x;
+    uint16_t& code;
+    template <typename U>
+      void operator()(const blitz::Array<U,2>& integral_image) const {
+        code = lbp.lbp_code<U>(integral_image, y, x);
+      }
+  };
 
   template <typename T>
-    inline void LBP::extract_(const blitz::Array<T,2>& src, blitz::Array<uint16_t,2>& dst, bool is_integral_image) const
+    inline void LBP::extract_(const blitz::Array<T,2>& src, blitz::Array<uint16_t,2>& dst, bool is_integral_image, const int n_threads) const
     {
       if (isMultiBlockLBP() && !is_integral_image){
-        // apply integral image
-        _integral_image.resize(src.extent(0)+1, src.extent(1)+1);
-        bob::ip::base::integral(src, _integral_image, true);
-        apply<double>(_integral_image, dst);
+        // apply integral image; images of integral type are integrated exactly, using the smallest sufficient integer type
+        _withIntegralImage(src, ApplyIntegral{*this, dst, n_threads});
       } else {
-        apply<T>(src, dst);
+        parallelFor(dst.extent(0), n_threads, [&](int begin, int end){ apply<T>(src, dst, begin, end); });
+      }
+    }
+
+  template <typename T>
+    inline void LBP::extractHistograms_(const blitz::Array<T,2>& src, const blitz::TinyVector<int,2>& block_size, const blitz::TinyVector<int,2>& block_overlap, blitz::Array<uint64_t,2>& dst, bool sliding_window) const
+    {
+      const blitz::TinyVector<int,2> lbp_shape = getLBPShape(src.shape());
+      if (isMultiBlockLBP()){
+        // apply integral image; images of integral type are integrated exactly, using the smallest sufficient integer type
+        _withIntegralImage(src, HistogramsIntegral{*this, lbp_shape, block_size, block_overlap, dst, sliding_window});
+      } else {
+        accumulateHistograms(src, lbp_shape, block_size, block_overlap, dst, sliding_window);
+      }
+    }
+
+  /**
+   * Adds one row of codes, shifted by offset, to the histograms of all blocks that contain them, see bob::ip::base::blockReference.
+   * The block rows that contain the row are [first_h, last_h], the block columns that contain the code x are [first_w[x], last_w[x]].
+   * The histogram of the block (h,w) is stored in row h * n_blocks_w + w of the histograms.
+   */
+  static inline void _accumulateBlockHistograms(const uint16_t* codes, const int offset,
+      const int first_h, const int last_h, const std::vector<int>& first_w, const std::vector<int>& last_w, const int n_blocks_w,
+      blitz::Array<uint64_t,2>& histograms)
+  {
+    const int width = first_w.size();
+    for (int x = 0; x < width; ++x){
+      const int code = offset + codes[x];
+      for (int h = first_h; h <= last_h; ++h){
+        uint64_t* histogram = &histograms(h * n_blocks_w, code);
+        for (int w = first_w[x]; w <= last_w[x]; ++w)
+          ++histogram[w * histograms.stride(0)];
+      }
+    }
+  }
+
+  template <typename T>
+    inline void LBP::accumulateHistograms(const blitz::Array<T,2>& src, const blitz::TinyVector<int,2>& lbp_shape, const blitz::TinyVector<int,2>& block_size, const blitz::TinyVector<int,2>& block_overlap, blitz::Array<uint64_t,2>& dst, bool sliding_window) const
+    {
+      if (sliding_window){
+        slideHistograms(src, lbp_shape, block_size, block_overlap, dst);
+        return;
+      }
+
+      // the block layout in the LBP image, see bob::ip::base::blockReference
+      const blitz::TinyVector<int,2> step = block_size - block_overlap;
+      const int n_blocks_h = (lbp_shape[0] - block_overlap[0]) / step[0];
+      const int n_blocks_w = (lbp_shape[1] - block_overlap[1]) / step[1];
+      if (n_blocks_h <= 0 || n_blocks_w <= 0) return;
+
+      // only the LBP codes that lie in any of the blocks are computed
+      const int height = (n_blocks_h - 1) * step[0] + block_size[0];
+      const int width = (n_blocks_w - 1) * step[1] + block_size[1];
+
+      // the first and the last block row and column that contain the LBP codes of each row and column
+      std::vector<int> first_h, last_h, first_w, last_w;
+      _blockRange(height, block_size[0], step[0], n_blocks_h, first_h, last_h);
+      _blockRange(width, block_size[1], step[1], n_blocks_w, first_w, last_w);
+
+      // the row buffer is re-indexed to the current row, so that the LBP kernels can write row y into it
+      blitz::Array<uint16_t,2> codes(blitz::Range(0,0), blitz::Range(0, width-1));
+      for (int y = 0; y < height; ++y){
+        codes.reindexSelf(blitz::TinyVector<int,2>(y, 0));
+        apply<T>(src, codes, y, y+1);
+
+        _accumulateBlockHistograms(&codes(y,0), 0, first_h[y], last_h[y], first_w, last_w, n_blocks_w, dst);
+      }
+    }
+
+  template <typename T>
+    inline void LBP::slideHistograms(const blitz::Array<T,2>& src, const blitz::TinyVector<int,2>& lbp_shape, const blitz::TinyVector<int,2>& block_size, const blitz::TinyVector<int,2>& block_overlap, blitz::Array<uint64_t,2>& dst) const
+    {
+      // the block layout in the LBP image, see bob::ip::base::blockReference
+      const blitz::TinyVector<int,2> step = block_size - block_overlap;
+      const int n_blocks_h = (lbp_shape[0] - block_overlap[0]) / step[0];
+      const int n_blocks_w = (lbp_shape[1] - block_overlap[1]) / step[1];
+      if (n_blocks_h <= 0 || n_blocks_w <= 0) return;
+
+      const int width = (n_blocks_w - 1) * step[1] + block_size[1];
+
+      // the LBP codes of the last block_size[0] rows, where row y is stored at y % block_size[0]
+      blitz::Array<uint16_t,2> codes(block_size[0], width);
+      std::vector<uint64_t> histogram(dst.extent(1));
+      int next_y = 0;
+      for (int h = 0; h < n_blocks_h; ++h){
+        const int y_begin = h * step[0], y_end = y_begin + block_size[0];
+        // compute the LBP codes of the rows that enter the current row of blocks
+        for (; next_y < y_end; ++next_y){
+          blitz::Array<uint16_t,2> row = codes(blitz::Range(next_y % block_size[0], next_y % block_size[0]), blitz::Range::all());
+          row.reindexSelf(blitz::TinyVector<int,2>(next_y, 0));
+          apply<T>(src, row, next_y, next_y+1);
+        }
+
+        // the histogram of the first block is counted, all others are derived from their left neighbor
+        std::fill(histogram.begin(), histogram.end(), 0);
+        for (int y = y_begin; y < y_end; ++y){
+          const uint16_t* code = &codes(y % block_size[0], 0);
+          for (int x = 0; x < block_size[1]; ++x)
+            ++histogram[code[x]];
+        }
+        for (int w = 0; w < n_blocks_w; ++w){
+          if (w){
+            const int x_begin = w * step[1];
+            for (int y = y_begin; y < y_end; ++y){
+              const uint16_t* code = &codes(y % block_size[0], 0);
+              for (int x = x_begin - step[1]; x < x_begin; ++x)
+                --histogram[code[x]];
+              for (int x = x_begin - step[1] + block_size[1]; x < x_begin + block_size[1]; ++x)
+                ++histogram[code[x]];
+            }
+          }
+          const int b = h * n_blocks_w + w;
+          for (int l = 0; l < (int)histogram.size(); ++l)
+            dst(b, l) += histogram[l];
+        }
       }
     }
 
     template <typename T>
-      inline void LBP::apply(const blitz::Array<T,2>& src, blitz::Array<uint16_t,2>& dst) const
+      inline void LBP::apply(const blitz::Array<T,2>& src, blitz::Array<uint16_t,2>& dst, const int y_begin, const int y_end) const
     {
+      if (isSpecialized()){
+        switch (m_P){
+          case 4: applySpecialized<T,4>(src, dst, y_begin, y_end); break;
+          case 8: applySpecialized<T,8>(src, dst, y_begin, y_end); break;
+          default: applySpecialized<T,16>(src, dst, y_begin, y_end);
+        }
+        return;
+      }
+      if (!isMultiBlockLBP() && m_circular && m_border_handling == LBP_BORDER_SHRINK){
+        applyCircularGeneric<T>(src, dst, y_begin, y_end);
+        return;
+      }
+
       // offset in the source image
       const blitz::TinyVector<int,2> offset = getOffset();
 
       // iterate over target pixels
-      for (int y = 0; y < dst.extent(0); ++y)
+      for (int y = y_begin; y < y_end; ++y)
         for (int x = 0; x < dst.extent(1); ++x)
           dst(y, x) = lbp_code(src, y + offset[0], x + offset[1]);
     }
 
+  /** The comparison of a neighbor with the center used in lbp_code; for integral types, isClose is only true for identical values */
+  template <typename T>
+  static inline bool _lbp_compare(const T pixel, const T center){
+    if (std::numeric_limits<T>::is_integer) return pixel >= center;
+    return pixel > center || bob::core::isClose(static_cast<double>(pixel), static_cast<double>(center));
+  }
+
+  /** Returns true, if the product of the two differences is not negative; for integral types, the product is not computed, so that it cannot overflow */
+  template <typename V>
+  static inline bool _lbp_same_direction(const V d1, const V d2){
+    if (std::numeric_limits<V>::is_integer) return (d1 >= 0 && d2 >= 0) || (d1 <= 0 && d2 <= 0);
+    return d1 * d2 >= 0;
+  }
+
+  /** Computes the LBP bit string (before applying the look up table) of the given neighbors for the given LBP type, see lbp_code */
+  template <int P, ELBPType E, typename V>
+  static inline unsigned _lbp_bits(const V* pixels, const V center){
+    unsigned code = 0;
+    switch (E){
+      case ELBP_REGULAR:
+        for (int p = 0; p < P; ++p)
+          code |= static_cast<unsigned>(_lbp_compare(pixels[p], center)) << (P - p - 1);
+        break;
+      case ELBP_TRANSITIONAL:
+        for (int p = 0; p < P; ++p)
+          code |= static_cast<unsigned>(_lbp_compare(pixels[p], pixels[(p+1)%P])) << (P - p - 1);
+        break;
+      case ELBP_DIRECTION_CODED:
+        for (int p = 0; p < P/2; ++p){
+          code <<= 2;
+          const V d1 = pixels[p] - center, d2 = pixels[p+P/2] - center;
+          if (_lbp_same_direction(d1, d2)) code += 1;
+          if (_lbp_compare(std::abs(d1), std::abs(d2))) code += 2;
+        }
+        break;
+    }
+    return code;
+  }
+
+  template <typename T, int P>
+    inline void LBP::applySpecialized(const blitz::Array<T,2>& src, blitz::Array<uint16_t,2>& dst, const int y_begin, const int y_end) const
+  {
+    switch (m_eLBP_type){
+      case ELBP_REGULAR: applyKernel<T,P,ELBP_REGULAR>(src, dst, y_begin, y_end); break;
+      case ELBP_TRANSITIONAL: applyKernel<T,P,ELBP_TRANSITIONAL>(src, dst, y_begin, y_end); break;
+      case ELBP_DIRECTION_CODED: applyKernel<T,P,ELBP_DIRECTION_CODED>(src, dst, y_begin, y_end); break;
+    }
+  }
+
+  template <typename T, int P, ELBPType E>
+    inline void LBP::applyKernel(const blitz::Array<T,2>& src, blitz::Array<uint16_t,2>& dst, const int y_begin, const int y_end) const
+  {
+    if (isMultiBlockLBP()) applyMultiBlock<T,P,E>(src, dst, y_begin, y_end);
+    else if (m_circular) applyCircular<T,P,E>(src, dst, y_begin, y_end);
+    else applyRectangular<T,P,E>(src, dst, y_begin, y_end);
+  }
+
+  template <typename T, int P, ELBPType E>
+    inline void LBP::applyMultiBlock(const blitz::Array<T,2>& src, blitz::Array<uint16_t,2>& dst, const int y_begin, const int y_end) const
+  {
+    if (!dst.size()) return;
+    typedef typename std::conditional<std::numeric_limits<T>::is_integer, int64_t, double>::type V;
+    // offset in the integral image
+    const blitz::TinyVector<int,2> offset = getOffset();
+    const int stride_y = src.stride(0), stride_x = src.stride(1);
+    const int dst_stride_x = dst.stride(1);
+    // the offsets of the four corners of all blocks relative to the center pixel; the last block is the central one
+    int corners[P+1][4];
+    for (int p = 0; p <= P; ++p){
+      corners[p][0] = m_int_positions(p,0) * stride_y + m_int_positions(p,2) * stride_x;
+      corners[p][1] = m_int_positions(p,1) * stride_y + m_int_positions(p,3) * stride_x;
+      corners[p][2] = m_int_positions(p,0) * stride_y + m_int_positions(p,3) * stride_x;
+      corners[p][3] = m_int_positions(p,1) * stride_y + m_int_positions(p,2) * stride_x;
+    }
+    const uint16_t* lut = m_lut.data();
+
+    V sums[P+1];
+    for (int y = y_begin; y < y_end; ++y){
+      const T* center = &src(y + offset[0], offset[1]);
+      uint16_t* target = &dst(y,0);
+      for (int x = 0; x < dst.extent(1); ++x, center += stride_x, target += dst_stride_x){
+        for (int p = 0; p <= P; ++p)
+          sums[p] = static_cast<V>(center[corners[p][0]]) + static_cast<V>(center[corners[p][1]]) - static_cast<V>(center[corners[p][2]]) - static_cast<V>(center[corners[p][3]]);
+        *target = lut[_lbp_bits<P,E>(sums, sums[P])];
+      }
+    }
+  }
+
+  template <typename T, int P, ELBPType E>
+    inline void LBP::applyRectangular(const blitz::Array<T,2>& src, blitz::Array<uint16_t,2>& dst, const int y_begin, const int y_end) const
+  {
+    if (!dst.size()) return;
+    // integral pixel values are compared exactly; the differences of direction coded LBP's require a signed type
+    typedef typename std::conditional<std::numeric_limits<T>::is_integer, int64_t, double>::type V;
+    // offset in the source image
+    const blitz::TinyVector<int,2> offset = getOffset();
+    const int stride_y = src.stride(0), stride_x = src.stride(1);
+    const int dst_stride_x = dst.stride(1);
+    // the offsets of the neighbors relative to the center pixel
+    int neighbors[P];
+    for (int p = 0; p < P; ++p)
+      neighbors[p] = m_int_positions(p,0) * stride_y + m_int_positions(p,1) * stride_x;
+    const uint16_t* lut = m_lut.data();
+
+    V pixels[P];
+    for (int y = y_begin; y < y_end; ++y){
+      const T* center = &src(y + offset[0], offset[1]);
+      uint16_t* target = &dst(y,0);
+      for (int x = 0; x < dst.extent(1); ++x, center += stride_x, target += dst_stride_x){
+        for (int p = 0; p < P; ++p)
+          pixels[p] = static_cast<V>(center[neighbors[p]]);
+        *target = lut[_lbp_bits<P,E>(pixels, static_cast<V>(*center))];
+      }
+    }
+  }
+
+  template <typename T, int P, ELBPType E>
+    inline void LBP::applyCircular(const blitz::Array<T,2>& src, blitz::Array<uint16_t,2>& dst, const int y_begin, const int y_end) const
+  {
+    if (!dst.size()) return;
+    // offset in the source image
+    const blitz::TinyVector<int,2> offset = getOffset();
+    const int stride_y = src.stride(0), stride_x = src.stride(1);
+    const int dst_stride_x = dst.stride(1);
+    // the offsets of the four taps of all neighbors relative to the center pixel
+    int taps[P][4];
+    for (int p = 0; p < P; ++p){
+      taps[p][0] = m_int_positions(p,0) * stride_y + m_int_positions(p,2) * stride_x;
+      taps[p][1] = m_int_positions(p,0) * stride_y + m_int_positions(p,3) * stride_x;
+      taps[p][2] = m_int_positions(p,1) * stride_y + m_int_positions(p,2) * stride_x;
+      taps[p][3] = m_int_positions(p,1) * stride_y + m_int_positions(p,3) * stride_x;
+    }
+    const double* weights = m_weights.data();
+    const uint16_t* lut = m_lut.data();
+
+    double pixels[P];
+    for (int y = y_begin; y < y_end; ++y){
+      const T* center = &src(y + offset[0], offset[1]);
+      uint16_t* target = &dst(y,0);
+      for (int x = 0; x < dst.extent(1); ++x, center += stride_x, target += dst_stride_x){
+        for (int p = 0; p < P; ++p){
+          const double* w = weights + 4*p;
+          pixels[p] = w[0] * center[taps[p][0]] + w[1] * center[taps[p][1]] + w[2] * center[taps[p][2]] + w[3] * center[taps[p][3]];
+        }
+        *target = lut[_lbp_bits<P,E>(pixels, static_cast<double>(*center))];
+      }
+    }
+  }
+
+  template <typename T>
+    inline void LBP::applyCircularGeneric(const blitz::Array<T,2>& src, blitz::Array<uint16_t,2>& dst, const int y_begin, const int y_end) const
+  {
+    if (!dst.size()) return;
+    // offset in the source image
+    const blitz::TinyVector<int,2> offset = getOffset();
+    const int stride_y = src.stride(0), stride_x = src.stride(1);
+    // the offsets of the four taps of all neighbors relative to the center pixel
+    int taps[16][4];
+    for (int p = 0; p < m_P; ++p){
+      taps[p][0] = m_int_positions(p,0) * stride_y + m_int_positions(p,2) * stride_x;
+      taps[p][1] = m_int_positions(p,0) * stride_y + m_int_positions(p,3) * stride_x;
+      taps[p][2] = m_int_positions(p,1) * stride_y + m_int_positions(p,2) * stride_x;
+      taps[p][3] = m_int_positions(p,1) * stride_y + m_int_positions(p,3) * stride_x;
+    }
+    const double* weights = m_weights.data();
+
+    double pixels[16];
+    for (int y = y_begin; y < y_end; ++y){
+      const T* center = &src(y + offset[0], offset[1]);
+      for (int x = 0; x < dst.extent(1); ++x, center += stride_x){
+        for (int p = 0; p < m_P; ++p){
+          const double* w = weights + 4*p;
+          pixels[p] = w[0] * center[taps[p][0]] + w[1] * center[taps[p][1]] + w[2] * center[taps[p][2]] + w[3] * center[taps[p][3]];
+        }
+        dst(y,x) = lbp_code(pixels, static_cast<double>(*center));
+      }
+    }
+  }
+
   template <typename T>
   inline uint16_t LBP::extract(const blitz::Array<T,2>& src, int y, int x, bool is_integral_image) const{
     // perform some checks
@@ -402,12 +900,10 @@ namespace bob { namespace ip { namespace base {
   template <typename T>
   inline uint16_t LBP::extract_(const blitz::Array<T,2>& src, int y, int x, bool is_integral_image) const{
     if (isMultiBlockLBP() && !is_integral_image){
-      // apply integral image
-      _integral_image.resize(src.extent(0)+1, src.extent(1)+1);
-      // compute integral image; adds one line of zeros in the front
-      bob::ip::base::integral(src, _integral_image, true);
-      // return LBP code from integral image
-      return lbp_code<double>(_integral_image, y, x);
+      // apply integral image; adds one line of zeros in the front
+      uint16_t code;
+      _withIntegralImage(src, CodeIntegral{*this, y, x, code});
+      return code;
     } else {
       // return LBP code from source image
       return lbp_code<T>(src, y, x);
@@ -415,63 +911,112 @@ namespace bob { namespace ip { namespace base {
   }
 
 
+  inline void LBP::extract(const PreparedImage& src, blitz::Array<uint16_t,2>& dst, const int n_threads) const
+  {
+    bob::core::array::assertZeroBase(dst);
+    bob::core::array::assertSameShape(dst, getLBPShape(src.getShape()));
+    if (isMultiBlockLBP() && src.isIntegerImage()){
+      const blitz::Array<int64_t,2>& integral_image = src.getIntegerIntegral();
+      parallelFor(dst.extent(0), n_threads, [&](int begin, int end){ apply<int64_t>(integral_image, dst, begin, end); });
+    } else if (isMultiBlockLBP()){
+      const blitz::Array<double,2>& integral_image = src.getIntegral();
+      parallelFor(dst.extent(0), n_threads, [&](int begin, int end){ apply<double>(integral_image, dst, begin, end); });
+    } else {
+      const blitz::Array<double,2>& image = src.getSource();
+      parallelFor(dst.extent(0), n_threads, [&](int begin, int end){ apply<double>(image, dst, begin, end); });
+    }
+  }
+
+  inline uint16_t LBP::extract(const PreparedImage& src, int y, int x) const
+  {
+    if (isMultiBlockLBP() && src.isIntegerImage())
+      return extract(src.getIntegerIntegral(), y, x, true);
+    if (isMultiBlockLBP())
+      return extract(src.getIntegral(), y, x, true);
+    return extract(src.getSource(), y, x, false);
+  }
+
   // implementation of the LBP code extraction
   template <typename T>
   inline uint16_t LBP::lbp_code(const blitz::Array<T,2>& src, int y, int x) const{
-    double center;
     if (isMultiBlockLBP()){
-      // extract the pixels from the INTEGRAL image
+      // extract the block sums from the INTEGRAL image; block sums of integer integral images are compared exactly
       // only shrinking border handling is supported, so we don't need to care about borders here
-      for (int p = 0; p < m_P; ++p){
+      typedef typename std::conditional<std::numeric_limits<T>::is_integer, int64_t, double>::type V;
+      V sums[16];
+      for (int p = 0; p <= m_P; ++p){
         const int y0 = y + m_int_positions(p,0),
                   y1 = y + m_int_positions(p,1),
                   x0 = x + m_int_positions(p,2),
                   x1 = x + m_int_positions(p,3);
-        _pixels[p] = static_cast<double>(src(y0, x0)) + static_cast<double>(src(y1, x1)) - static_cast<double>(src(y0, x1)) - static_cast<double>(src(y1, x0));
+        sums[p] = static_cast<V>(src(y0, x0)) + static_cast<V>(src(y1, x1)) - static_cast<V>(src(y0, x1)) - static_cast<V>(src(y1, x0));
+      }
+      // the last block is the central one
+      return lbp_code(sums, sums[m_P]);
+    }
+
+    // the pixels are stored on the stack, so that the same LBP object can be used by several threads
+    double pixels[16];
+    double center;
+    if (m_circular){
+      // extract the pixels from the image by interpolating the image with the pre-computed taps, wrapping around
+      for (int p = 0; p < m_P; ++p){
+        const int y0 = (y + m_int_positions(p,0) + src.extent(0)) % src.extent(0),
+                  y1 = (y + m_int_positions(p,1) + src.extent(0)) % src.extent(0),
+                  x0 = (x + m_int_positions(p,2) + src.extent(1)) % src.extent(1),
+                  x1 = (x + m_int_positions(p,3) + src.extent(1)) % src.extent(1);
+        pixels[p] = m_weights(p,0) * src(y0, x0) + m_weights(p,1) * src(y0, x1) + m_weights(p,2) * src(y1, x0) + m_weights(p,3) * src(y1, x1);
       }
-      const int y0 = y + m_int_positions(m_P,0),
-                y1 = y + m_int_positions(m_P,1),
-                x0 = x + m_int_positions(m_P,2),
-                x1 = x + m_int_positions(m_P,3);
-      center = static_cast<double>(src(y0, x0)) + static_cast<double>(src(y1, x1)) - static_cast<double>(src(y0, x1)) - static_cast<double>(src(y1, x0));
-    }else if (m_circular){
-      // extract the pixels from the image by interpolating the image
-      for (int p = 0; p < m_P; ++p)
-        _pixels[p] = bob::sp::detail::bilinearInterpolationWrapNoCheck(src, y + m_positions(p,0), x + m_positions(p,1));
       center = static_cast<double>(src(y, x));
     }else{
       // extract the pixels from the image by wrapping around (also works for shrinking since these positions will never be used)
       for (int p = 0; p < m_P; ++p){
         const int cy = (y + m_int_positions(p,0) + src.extent(0)) % src.extent(0);
         const int cx = (x + m_int_positions(p,1) + src.extent(1)) % src.extent(1);
-        _pixels[p] = static_cast<double>(src(cy, cx));
+        pixels[p] = static_cast<double>(src(cy, cx));
       }
       center = static_cast<double>(src(y, x));
     }
 
+    return lbp_code(pixels, center);
+  }
 
-    double cmp_point = center;
-    if (m_to_average)
-      cmp_point = std::accumulate(_pixels.begin(), _pixels.end(), center) / (m_P + 1); // /(P+1) since (averaged over P+1 points)
+  template <typename V>
+  inline uint16_t LBP::lbp_code(const V* neighbors, const V center_pixel) const{
+    const V* pixels = neighbors;
+    V center = center_pixel, cmp_point = center_pixel;
+    V scaled[16];
+    if (m_to_average){
+      if (std::numeric_limits<V>::is_integer){
+        // compare the pixels multiplied by (P+1) with the sum of all pixels, so that integral values are compared exactly
+        for (int p = 0; p < m_P; ++p)
+          scaled[p] = neighbors[p] * (m_P + 1);
+        pixels = scaled;
+        center = center_pixel * (m_P + 1);
+        cmp_point = std::accumulate(neighbors, neighbors + m_P, center_pixel);
+      } else {
+        cmp_point = std::accumulate(neighbors, neighbors + m_P, center_pixel) / (m_P + 1); // /(P+1) since (averaged over P+1 points)
+      }
+    }
 
     // the formulas are implemented from Cosmin's thesis
     uint16_t lbp_code = 0;
     switch (m_eLBP_type){
       case ELBP_REGULAR:{
         for (int p = 0; p < m_P; ++p){
-          lbp_code |= (_pixels[p] > cmp_point || bob::core::isClose(_pixels[p], cmp_point)) << (m_P - p - 1);
+          lbp_code |= _lbp_compare(pixels[p], cmp_point) << (m_P - p - 1);
         }
         if (m_add_average_bit && !m_rotation_invariant && !m_uniform)
         {
           lbp_code <<= 1;
-          if (center > cmp_point || bob::core::isClose(center, cmp_point)) ++lbp_code;
+          if (_lbp_compare(center, cmp_point)) ++lbp_code;
         }
         break;
       }
 
       case ELBP_TRANSITIONAL:{
         for (int p = 0; p < m_P; ++p){
-          lbp_code |= (_pixels[p] > _pixels[(p+1)%m_P] || bob::core::isClose(_pixels[p], _pixels[(p+1)%m_P])) << (m_P - p - 1);
+          lbp_code |= _lbp_compare(pixels[p], pixels[(p+1)%m_P]) << (m_P - p - 1);
         }
         break;
       }
@@ -480,9 +1025,9 @@ namespace bob { namespace ip { namespace base {
         int p_half = m_P/2;
         for (int p = 0; p < p_half; ++p){
           lbp_code <<= 2;
-          if ((_pixels[p] - cmp_point) * (_pixels[p+p_half] - cmp_point) >= 0.) lbp_code += 1;
-          double p1 = std::abs(_pixels[p] - cmp_point), p2 = std::abs(_pixels[p+p_half] - cmp_point);
-          if ( p1 > p2 || bob::core::isClose(p1, p2) ) lbp_code += 2;
+          if (_lbp_same_direction(pixels[p] - cmp_point, pixels[p+p_half] - cmp_point)) lbp_code += 1;
+          const V p1 = std::abs(pixels[p] - cmp_point), p2 = std::abs(pixels[p+p_half] - cmp_point);
+          if (_lbp_compare(p1, p2)) lbp_code += 2;
         }
         break;
       }
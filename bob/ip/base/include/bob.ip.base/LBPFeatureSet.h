@@ -0,0 +1,148 @@
+/**
+ * @date Sat Oct 17 16:21:03 CEST 2026
+ *
+ * This file defines a class that evaluates a fixed list of LBP features in many windows of an image
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#ifndef BOB_IP_BASE_LBP_FEATURE_SET_H
+#define BOB_IP_BASE_LBP_FEATURE_SET_H
+
+#include <vector>
+#include <stdexcept>
+#include <boost/shared_ptr.hpp>
+#include <boost/format.hpp>
+#include <blitz/array.h>
+
+#include <bob.core/assert.h>
+#include <bob.ip.base/LBP.h>
+#include <bob.ip.base/Parallel.h>
+#include <bob.ip.base/PreparedImage.h>
+
+namespace bob { namespace ip { namespace base {
+
+  /**
+   * @brief This class evaluates a fixed list of LBP features, each given by
+   * an LBP extractor and a position, in many windows of an image, e.g., to
+   * apply boosted classifiers that use LBP features to all candidate windows
+   * of a sliding-window detector.
+   *
+   * The feature f in the window with origin (oy, ox) is the code that
+   * lbp_f.extract(image, oy + y_f, ox + x_f) would return. The integral
+   * image, which is required by multi-block LBP's, is computed only once.
+   * All windows are checked before any feature is evaluated.
+   */
+  class LBPFeatureSet {
+
+    public:
+
+      /**
+       * @brief Constructs the feature set from the LBP extractors and the positions of all features;
+       * the same LBP extractor might be used by several features
+       */
+      LBPFeatureSet(const std::vector<boost::shared_ptr<LBP> >& lbps, const std::vector<blitz::TinyVector<int,2> >& positions);
+
+      /**
+       * @brief Copy constructor; the LBP's are shared
+       */
+      LBPFeatureSet(const LBPFeatureSet& other);
+
+      /**
+       * @brief Destructor
+       */
+      virtual ~LBPFeatureSet();
+
+      /**
+       * @brief Assignment; the LBP's are shared
+       */
+      LBPFeatureSet& operator=(const LBPFeatureSet& other);
+
+      /**
+       * @brief Accessors
+       */
+      const std::vector<boost::shared_ptr<LBP> >& getLBPs() const { return m_lbps; }
+      const std::vector<blitz::TinyVector<int,2> >& getPositions() const { return m_positions; }
+      int getNumberOfFeatures() const { return m_lbps.size(); }
+
+      /**
+       * @brief Evaluates all features in all windows, whose origins are given as (n_windows, 2) array,
+       * and writes the codes into the (n_windows, n_features) dst array.
+       * The windows are processed by n_threads threads; if n_threads is 0 or negative, all hardware threads are used.
+       */
+      template <typename T>
+        void extract(const blitz::Array<T,2>& src, const blitz::Array<int,2>& windows, blitz::Array<uint16_t,2>& dst, const int n_threads = 1) const;
+
+      /**
+       * @brief Evaluates all features in all windows of the given prepared image, re-using its integral image
+       */
+      void extract(const PreparedImage& src, const blitz::Array<int,2>& windows, blitz::Array<uint16_t,2>& dst, const int n_threads = 1) const;
+
+    private:
+
+      /**
+       * @brief Checks the shapes of windows and dst, and that all features of all windows lie inside the image of the given shape
+       */
+      void check(const blitz::TinyVector<int,2>& shape, const blitz::Array<int,2>& windows, const blitz::Array<uint16_t,2>& dst) const;
+
+      /**
+       * @brief Evaluates all features; multi-block LBP's use the integral_image, all others the src image
+       */
+      template <typename T, typename U>
+        void extract_(const blitz::Array<T,2>& src, const blitz::Array<U,2>& integral_image, const blitz::Array<int,2>& windows, blitz::Array<uint16_t,2>& dst, const int n_threads) const;
+
+      // calls extract_ with the integral image computed by _withIntegralImage
+      template <typename T>
+        struct ExtractIntegral;
+
+      bool hasMultiBlockLBP() const;
+
+      std::vector<boost::shared_ptr<LBP> > m_lbps;
+      std::vector<blitz::TinyVector<int,2> > m_positions;
+  };
+
+  template <typename T, typename U>
+    inline void LBPFeatureSet::extract_(const blitz::Array<T,2>& src, const blitz::Array<U,2>& integral_image, const blitz::Array<int,2>& windows, blitz::Array<uint16_t,2>& dst, const int n_threads) const
+  {
+    const int n_features = getNumberOfFeatures();
+    parallelFor(windows.extent(0), n_threads, [&](int begin, int end){
+      for (int w = begin; w < end; ++w){
+        const int oy = windows(w,0), ox = windows(w,1);
+        for (int f = 0; f < n_features; ++f){
+          const LBP& lbp = *m_lbps[f];
+          const int y = oy + m_positions[f][0], x = ox + m_positions[f][1];
+          dst(w,f) = lbp.isMultiBlockLBP() ? lbp.lbp_code(integral_image, y, x) : lbp.lbp_code(src, y, x);
+        }
+      }
+    });
+  }
+
+  template <typename T>
+    struct LBPFeatureSet::ExtractIntegral{
+      const LBPFeatureSet& feature_set;
+      const blitz::Array<T,2>& src;
+      const blitz::Array<int,2>& windows;
+      blitz::Array<uint16_t,2>& dst;
+      const int n_threads;
+      template <typename U>
+        void operator()(const blitz::Array<U,2>& integral_image) const {
+          feature_set.extract_(src, integral_image, windows, dst, n_threads);
+        }
+    };
+
+  template <typename T>
+    inline void LBPFeatureSet::extract(const blitz::Array<T,2>& src, const blitz::Array<int,2>& windows, blitz::Array<uint16_t,2>& dst, const int n_threads) const
+  {
+    bob::core::array::assertZeroBase(src);
+    check(src.shape(), windows, dst);
+    if (!hasMultiBlockLBP()){
+      extract_(src, blitz::Array<double,2>(), windows, dst, n_threads);
+      return;
+    }
+    // compute the integral image once; images of integral type are integrated exactly
+    _withIntegralImage(src, ExtractIntegral<T>{*this, src, windows, dst, n_threads});
+  }
+
+} } } // namespaces
+
+#endif // BOB_IP_BASE_LBP_FEATURE_SET_H
@@ -15,15 +15,18 @@
 
 #include <bob.ip.base/LBP.h>
 #include <bob.ip.base/Block.h>
-#include <bob.ip.base/Histogram.h>
 
 namespace bob { namespace ip { namespace base {
 
   /**
     * @brief Process a 2D blitz Array/Image by extracting LBPHS features.
+    *   The LBP codes are directly added to the histograms of all blocks
+    *   (possibly several for overlapping blocks) that contain them,
+    *   without storing the LBP image.
     * @param src The 2D input blitz array
-    * @param dst A container (with a push_back method such as an STL list)
-    *   of 1D uint32_t blitz arrays.
+    * @param dst The 2D histogram array of shape (#blocks, lbp.getMaxLabel())
+    * @param sliding_window If enabled, the histograms are slid along the rows of blocks,
+    *   which is faster for heavily overlapping blocks, see LBP::extractHistograms_
     */
   template <typename T>
   void lbphs(
@@ -31,27 +34,21 @@ namespace bob { namespace ip { namespace base {
     const LBP& lbp,
     const blitz::TinyVector<int,2>& block_size,
     const blitz::TinyVector<int,2>& block_overlap,
-    blitz::Array<uint64_t,2> dst)
+    blitz::Array<uint64_t,2> dst,
+    bool sliding_window = false)
   {
-    // extract LBP features
-    blitz::Array<uint16_t, 2> lbp_image(lbp.getLBPShape(src.shape()));
-    lbp.extract_(src, lbp_image);
+    // check the block decomposition of the LBP image
+    const blitz::TinyVector<int,2> lbp_shape = lbp.getLBPShape(src.shape());
+    _blockCheckInput(lbp_shape[0], lbp_shape[1], block_size[0], block_size[1], block_overlap[0], block_overlap[1]);
+    const int n_blocks = getBlock3DOutputShape(lbp_shape[0], lbp_shape[1], block_size[0], block_size[1], block_overlap[0], block_overlap[1])[0];
 
-    // get all the blocks
-    auto blocks = blockReference(lbp_image, block_size[0], block_size[1], block_overlap[0], block_overlap[1]);
-
-    if (dst.extent(0) != (int)blocks.size() || dst.extent(1) != (int)lbp.getMaxLabel()){
-      throw std::runtime_error((boost::format("The given output image needs to be of size (%d, %d), but has shape (%d, %d)") % blocks.size() % lbp.getMaxLabel() % dst.extent(0) % dst.extent(1)).str());
+    if (dst.extent(0) != n_blocks || dst.extent(1) != (int)lbp.getMaxLabel()){
+      throw std::runtime_error((boost::format("The given output image needs to be of size (%d, %d), but has shape (%d, %d)") % n_blocks % lbp.getMaxLabel() % dst.extent(0) % dst.extent(1)).str());
     }
 
-    // compute an lbp histogram for each block
-    int i = 0;
-    for (auto it = blocks.begin(); it != blocks.end(); ++it, ++i)
-    {
-      // Compute the LBP histogram
-      blitz::Array<uint64_t, 1> block_histogram(dst(i, blitz::Range::all()));
-      bob::ip::base::histogram<uint16_t>(*it, block_histogram, 0, lbp.getMaxLabel()-1);
-    }
+    // compute the LBP codes row by row and add them to the histograms of all blocks that contain them
+    dst = 0;
+    lbp.extractHistograms_(src, block_size, block_overlap, dst, sliding_window);
   }
 
 } } } // namespaces
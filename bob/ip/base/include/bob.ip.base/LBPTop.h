@@ -16,11 +16,15 @@
 #define BOB_IP_BASE_LBPTOP_H
 
 #include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
 #include <blitz/array.h>
 #include <algorithm>
 #include <limits>
+#include <vector>
 
 #include <bob.ip.base/LBP.h>
+#include <bob.ip.base/Block.h>
+#include <bob.ip.base/Parallel.h>
 
 namespace bob { namespace ip { namespace base {
 
@@ -90,12 +94,52 @@ namespace bob { namespace ip { namespace base {
        * @param yt The result of the LBP operator in the YT plane for the whole
        * image, taking into consideration the size of the width of the input
        * array along the time direction.
+       * @param n_threads The number of threads that process the XY, XT and YT
+       * planes; if 0 or negative, all hardware threads are used.
        */
       template <typename T>
         void process(const blitz::Array<T,3>& src,
             blitz::Array<uint16_t,3>& xy,
             blitz::Array<uint16_t,3>& xt,
-            blitz::Array<uint16_t,3>& yt) const;
+            blitz::Array<uint16_t,3>& yt,
+            const int n_threads = 1) const;
+
+      /**
+       * Processes a 3D array like process, but instead of storing the three
+       * LBP volumes, each XY, XT and YT code is directly added to the
+       * histograms of all (time, height, width) blocks of the LBP volume with
+       * the given block size and overlap that contain it. Each row of dst
+       * contains the concatenated XY, XT and YT histograms of one block,
+       * where the blocks are ordered by time, height and width.
+       *
+       * @param src The input 3D array as described in process.
+       * @param block_size The (time, height, width) size of the blocks.
+       * @param block_overlap The (time, height, width) overlap of the blocks.
+       * @param dst The histograms of shape getHistogramShape(src.shape(), block_size, block_overlap).
+       * @param n_threads The number of threads that process the XY, XT and YT
+       * planes; if 0 or negative, all hardware threads are used.
+       */
+      template <typename T>
+        void processHistograms(const blitz::Array<T,3>& src,
+            const blitz::TinyVector<int,3>& block_size,
+            const blitz::TinyVector<int,3>& block_overlap,
+            blitz::Array<uint64_t,2>& dst,
+            const int n_threads = 1) const;
+
+      /**
+       * Returns the shape (#blocks, #labels_xy + #labels_xt + #labels_yt) of
+       * the histograms that processHistograms computes for a 3D array of the
+       * given shape
+       */
+      blitz::TinyVector<int,2> getHistogramShape(const blitz::TinyVector<int,3>& shape,
+          const blitz::TinyVector<int,3>& block_size,
+          const blitz::TinyVector<int,3>& block_overlap) const;
+
+      /**
+       * Returns the number of frames, rows and columns at each border of the
+       * input array, for which no LBP codes are extracted
+       */
+      int getBorder() const;
 
       /**
        * Accessors
@@ -124,48 +168,145 @@ namespace bob { namespace ip { namespace base {
 
     private: //representation and methods
 
+      /**
+       * Checks that LBP codes can be extracted from the given 3D array
+       */
+      template <typename T>
+        void checkInput(const blitz::Array<T,3>& src) const;
+
+      /**
+       * Returns the parts of all XY frames, XT slices and YT slices of src
+       * together with their LBP's, from which the codes are extracted
+       */
+      template <typename T>
+        void getPlanes(const blitz::Array<T,3>& src, std::vector<const LBP*>& lbps, std::vector<blitz::Array<T,2> >& views) const;
+
       boost::shared_ptr<LBP> m_lbp_xy; ///< LBP for the XY calculation
       boost::shared_ptr<LBP> m_lbp_xt; ///< LBP for the XT calculation
       boost::shared_ptr<LBP> m_lbp_yt; ///< LBP for the YT calculation
   };
 
+  /**
+   * Returns the part of the given plane, from which the whole-plane kernels
+   * of the given LBP extract the codes at the positions (border[0] + y,
+   * border[1] + x) for all pixels (y, x) of an LBP image of the given shape.
+   * For wrapping borders, the whole plane is returned, since the codes are
+   * extracted position by position (see _lbpTopExtract).
+   */
+  template <typename T>
+  static inline blitz::Array<T,2> _lbpTopView(const LBP& lbp, const blitz::Array<T,2>& plane, const blitz::TinyVector<int,2>& border, const blitz::TinyVector<int,2>& shape){
+    if (lbp.getBorderHandling() == LBP_BORDER_WRAP) return plane;
+    const blitz::TinyVector<int,2> offset = lbp.getOffset();
+    const blitz::TinyVector<int,2> extra = plane.shape() - lbp.getLBPShape(plane.shape());
+    const int y = border[0] - offset[0], x = border[1] - offset[1];
+    if (y < 0 || x < 0 || y + shape[0] + extra[0] > plane.extent(0) || x + shape[1] + extra[1] > plane.extent(1)){
+      boost::format m("the LBP with offset (%d, %d) cannot be extracted from the plane of shape (%d, %d) with a border of (%d, %d)");
+      m % offset[0] % offset[1] % plane.extent(0) % plane.extent(1) % border[0] % border[1];
+      throw std::runtime_error(m.str());
+    }
+    return plane(blitz::Range(y, y + shape[0] + extra[0] - 1), blitz::Range(x, x + shape[1] + extra[1] - 1));
+  }
+
+  /**
+   * Extracts the LBP codes of the given view (see _lbpTopView) into dst
+   */
+  template <typename T>
+  static inline void _lbpTopExtract(const LBP& lbp, const blitz::Array<T,2>& view, const blitz::TinyVector<int,2>& border, blitz::Array<uint16_t,2>& dst){
+    if (lbp.getBorderHandling() == LBP_BORDER_WRAP){
+      // the positions are at least border pixels away from the plane borders, so they are never wrapped
+      for (int y = 0; y < dst.extent(0); ++y)
+        for (int x = 0; x < dst.extent(1); ++x)
+          dst(y,x) = lbp.extract_(view, y + border[0], x + border[1]);
+    } else {
+      lbp.extract_(view, dst);
+    }
+  }
+
+  /**
+   * Adds the given plane of codes to the histograms of all blocks that contain them.
+   * The blocks along the axis perpendicular to the plane are given by the range [first, last],
+   * the block ranges of the rows and columns of the plane by the vectors.
+   * The strides convert the block indices of the three axes to the row of the histograms.
+   */
+  static inline void _lbpTopAccumulate(const blitz::Array<uint16_t,2>& codes, const int offset,
+      const int first, const int last, const int stride,
+      const std::vector<int>& first_y, const std::vector<int>& last_y, const int stride_y,
+      const std::vector<int>& first_x, const std::vector<int>& last_x, const int stride_x,
+      blitz::Array<uint64_t,2>& histograms)
+  {
+    for (int y = 0; y < codes.extent(0); ++y){
+      for (int x = 0; x < codes.extent(1); ++x){
+        const int code = offset + codes(y,x);
+        for (int i = first; i <= last; ++i)
+          for (int j = first_y[y]; j <= last_y[y]; ++j)
+            for (int k = first_x[x]; k <= last_x[x]; ++k)
+              ++histograms(i * stride + j * stride_y + k * stride_x, code);
+      }
+    }
+  }
+
   /**
    * Implementation of certain template methods.
    */
 
   template <typename T>
-    void LBPTop::process(
-        const blitz::Array<T,3>& src,
-        blitz::Array<uint16_t,3>& xy,
-        blitz::Array<uint16_t,3>& xt,
-        blitz::Array<uint16_t,3>& yt
-    ) const
+    void LBPTop::checkInput(const blitz::Array<T,3>& src) const
     {
       int radius_x = m_lbp_xy->getRadii()[1];  ///< The LBPu2,i radius in X direction
       int radius_y = m_lbp_xy->getRadii()[0];  ///< The LBPu2,i radius in Y direction
       int radius_t = m_lbp_yt->getRadii()[0];  ///< The LBPu2,i radius in T direction
 
-      int Tlength = src.extent(0);
-      int height = src.extent(1);
-      int width = src.extent(2);
-
-      /***** Checking the inputs *****/
       /**** Get XY plane (the first is enough) ****/
-
       const blitz::Array<T,2> checkXY = src( 0, blitz::Range::all(), blitz::Range::all());
-      m_lbp_xy->extract(checkXY, radius_x, radius_y);
+      m_lbp_xy->extract(checkXY, radius_y, radius_x);
 
       /**** Get XT plane (Intersect in one point is enough) ****/
       int limitT = ceil(2*radius_t + 1);
-      if( Tlength < limitT ) {
+      if( src.extent(0) < limitT ) {
         boost::format m("t_radius (%d) cannot be smaller than %d");
-        m % Tlength % limitT;
+        m % src.extent(0) % limitT;
         throw std::runtime_error(m.str());
       }
+    }
+
+  template <typename T>
+    void LBPTop::getPlanes(const blitz::Array<T,3>& src, std::vector<const LBP*>& lbps, std::vector<blitz::Array<T,2> >& views) const
+    {
+      const int border = getBorder();
+      const blitz::TinyVector<int,2> borders(border, border);
+      const int Tlength = src.extent(0), height = src.extent(1), width = src.extent(2);
+      for (int t = border; t < Tlength - border; ++t){
+        lbps.push_back(m_lbp_xy.get());
+        views.push_back(_lbpTopView(*m_lbp_xy, blitz::Array<T,2>(src(t, blitz::Range::all(), blitz::Range::all())), borders, blitz::TinyVector<int,2>(height - 2*border, width - 2*border)));
+      }
+      for (int y = border; y < height - border; ++y){
+        lbps.push_back(m_lbp_xt.get());
+        views.push_back(_lbpTopView(*m_lbp_xt, blitz::Array<T,2>(src(blitz::Range::all(), y, blitz::Range::all())), borders, blitz::TinyVector<int,2>(Tlength - 2*border, width - 2*border)));
+      }
+      for (int x = border; x < width - border; ++x){
+        lbps.push_back(m_lbp_yt.get());
+        views.push_back(_lbpTopView(*m_lbp_yt, blitz::Array<T,2>(src(blitz::Range::all(), blitz::Range::all(), x)), borders, blitz::TinyVector<int,2>(Tlength - 2*border, height - 2*border)));
+      }
+    }
+
+  template <typename T>
+    void LBPTop::process(
+        const blitz::Array<T,3>& src,
+        blitz::Array<uint16_t,3>& xy,
+        blitz::Array<uint16_t,3>& xt,
+        blitz::Array<uint16_t,3>& yt,
+        const int n_threads
+    ) const
+    {
+      int Tlength = src.extent(0);
+      int height = src.extent(1);
+      int width = src.extent(2);
+
+      /***** Checking the inputs *****/
+      checkInput(src);
 
       /***** Checking the outputs *****/
-      int max_radius = radius_x > radius_y ? radius_x : radius_y;
-      max_radius = max_radius > radius_t ? max_radius : radius_t;
+      int max_radius = getBorder();
       int limitWidth  = width-2*max_radius;
       int limitHeight = height-2*max_radius;
       int limitTime   = Tlength-2*max_radius;
@@ -221,28 +362,93 @@ namespace bob { namespace ip { namespace base {
         throw std::runtime_error(m.str());
       }
 
-      //for each element in time domain (the simplest way to see what is happening)
-      for(int i=max_radius;i<(Tlength-max_radius);i++){
-        for (int j=max_radius; j < (height-max_radius); j++) {
-          for (int k=max_radius; k < (width-max_radius); k++) {
-            /*Getting the "micro-plane" for XY calculus*/
-            const blitz::Array<T,2> kxy =
-               src( i, blitz::Range(j-max_radius,j+max_radius), blitz::Range(k-max_radius,k+max_radius));
-            xy(i-max_radius,j-max_radius,k-max_radius) = m_lbp_xy->extract(kxy, max_radius, max_radius);
-
-            /*Getting the "micro-plane" for XT calculus*/
-            const blitz::Array<T,2> kxt =
-               src(blitz::Range(i-max_radius,i+max_radius),j,blitz::Range(k-max_radius,k+max_radius));
-            xt(i-max_radius,j-max_radius,k-max_radius) = m_lbp_xt->extract(kxt, max_radius, max_radius);
-
-            /*Getting the "micro-plane" for YT calculus*/
-            const blitz::Array<T,2> kyt =
-               src(blitz::Range(i-max_radius,i+max_radius),blitz::Range(j-max_radius,j+max_radius),k);
-            yt(i-max_radius,j-max_radius,k-max_radius) = m_lbp_yt->extract(kyt, max_radius, max_radius);
+      // collect the XY frames, XT slices and YT slices together with their output planes;
+      // all blitz::Array views are created here, since they must not be created in the threads
+      const blitz::TinyVector<int,2> border(max_radius, max_radius);
+      std::vector<const LBP*> lbps;
+      std::vector<blitz::Array<T,2> > views;
+      getPlanes(src, lbps, views);
+      std::vector<blitz::Array<uint16_t,2> > planes;
+      for (int t = 0; t < limitTime; ++t)
+        planes.push_back(xy(t, blitz::Range::all(), blitz::Range::all()));
+      for (int y = 0; y < limitHeight; ++y)
+        planes.push_back(xt(blitz::Range::all(), y, blitz::Range::all()));
+      for (int x = 0; x < limitWidth; ++x)
+        planes.push_back(yt(blitz::Range::all(), blitz::Range::all(), x));
+
+      // extract the whole planes in parallel
+      parallelFor((int)planes.size(), n_threads, [&](int begin, int end){
+        for (int p = begin; p < end; ++p)
+          _lbpTopExtract(*lbps[p], views[p], border, planes[p]);
+      });
+    }
+
+  template <typename T>
+    void LBPTop::processHistograms(
+        const blitz::Array<T,3>& src,
+        const blitz::TinyVector<int,3>& block_size,
+        const blitz::TinyVector<int,3>& block_overlap,
+        blitz::Array<uint64_t,2>& dst,
+        const int n_threads
+    ) const
+    {
+      checkInput(src);
+      bob::core::array::assertSameShape(dst, getHistogramShape(src.shape(), block_size, block_overlap));
+
+      // the blocks that contain each frame, row and column of the LBP volumes
+      const int border = getBorder();
+      const blitz::TinyVector<int,3> shape = src.shape() - 2 * border;
+      std::vector<int> first[3], last[3];
+      blitz::TinyVector<int,3> n_blocks;
+      for (int a = 0; a < 3; ++a){
+        n_blocks[a] = (shape[a] - block_overlap[a]) / (block_size[a] - block_overlap[a]);
+        _blockRange(shape[a], block_size[a], block_size[a] - block_overlap[a], n_blocks[a], first[a], last[a]);
+      }
+      const blitz::TinyVector<int,3> stride(n_blocks[1] * n_blocks[2], n_blocks[2], 1);
+      const int offset_xt = m_lbp_xy->getMaxLabel(), offset_yt = offset_xt + m_lbp_xt->getMaxLabel();
+
+      // all blitz::Array views are created here, since they must not be created in the threads
+      const blitz::TinyVector<int,2> borders(border, border);
+      std::vector<const LBP*> lbps;
+      std::vector<blitz::Array<T,2> > views;
+      getPlanes(src, lbps, views);
+
+      // each thread extracts the codes of its planes into its own buffers, and adds them to its own histograms
+      dst = 0;
+      boost::mutex mutex;
+      parallelFor((int)views.size(), n_threads, [&](int begin, int end){
+        blitz::Array<uint64_t,2> histograms(dst.shape());
+        histograms = 0;
+        blitz::Array<uint16_t,2> xy(shape[1], shape[2]), xt(shape[0], shape[2]), yt(shape[0], shape[1]);
+        for (int p = begin; p < end; ++p){
+          if (p < shape[0]){
+            // the XY frame p
+            const int t = p;
+            if (first[0][t] > last[0][t]) continue;
+            _lbpTopExtract(*lbps[p], views[p], borders, xy);
+            _lbpTopAccumulate(xy, 0, first[0][t], last[0][t], stride[0], first[1], last[1], stride[1], first[2], last[2], stride[2], histograms);
+          } else if (p < shape[0] + shape[1]){
+            // the XT slice through row y
+            const int y = p - shape[0];
+            if (first[1][y] > last[1][y]) continue;
+            _lbpTopExtract(*lbps[p], views[p], borders, xt);
+            _lbpTopAccumulate(xt, offset_xt, first[1][y], last[1][y], stride[1], first[0], last[0], stride[0], first[2], last[2], stride[2], histograms);
+          } else {
+            // the YT slice through column x
+            const int x = p - shape[0] - shape[1];
+            if (first[2][x] > last[2][x]) continue;
+            _lbpTopExtract(*lbps[p], views[p], borders, yt);
+            _lbpTopAccumulate(yt, offset_yt, first[2][x], last[2][x], stride[2], first[0], last[0], stride[0], first[1], last[1], stride[1], histograms);
           }
         }
-      }
+
+        boost::mutex::scoped_lock lock(mutex);
+        for (int i = 0; i < dst.extent(0); ++i)
+          for (int j = 0; j < dst.extent(1); ++j)
+            dst(i,j) += histograms(i,j);
+      });
     }
+
 } } } // namespaces
 
 #endif /* BOB_IP_BASE_LBPTOP_H */
@@ -0,0 +1,197 @@
+/**
+ * @date Sun Oct 18 10:07:44 CEST 2026
+ *
+ * This class extracts LBP-TOP codes from a stream of frames, keeping only
+ * the frames that are required for the temporal radius.
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#ifndef BOB_IP_BASE_LBPTOP_STREAM_H
+#define BOB_IP_BASE_LBPTOP_STREAM_H
+
+#include <stdexcept>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/format.hpp>
+#include <blitz/array.h>
+
+#include <bob.core/assert.h>
+#include <bob.ip.base/LBPTop.h>
+#include <bob.ip.base/Block.h>
+
+namespace bob { namespace ip { namespace base {
+
+  /**
+   * The LBPTopStream class extracts the LBP-TOP codes of a video, which is
+   * given frame by frame, e.g., from a camera.
+   *
+   * The last 2*R_t+1 frames are kept in a ring buffer, where R_t is the
+   * temporal radius of the LBPTop. After each pushed frame, the XY, XT and YT
+   * codes of the central frame of the buffer are extracted, i.e., the codes
+   * are delayed by R_t frames. The codes are identical to the codes that
+   * LBPTop::process extracts for this frame from the whole video. Hence,
+   * memory and latency are bounded by the temporal radius, and not by the
+   * length of the video.
+   *
+   * Instead of the codes, the LBP histograms of the blocks of the central
+   * frame can be extracted, see push.
+   *
+   * Frames can be pushed to the same stream from several threads, where the
+   * pushes are serialized.
+   */
+  class LBPTopStream {
+
+    public:
+
+      /**
+       * Creates a stream for frames of the given shape (height, width)
+       */
+      LBPTopStream(boost::shared_ptr<LBPTop> lbp_top, const blitz::TinyVector<int,2>& frame_shape);
+
+      /**
+       * Copy constructor; the LBPTop is shared, the buffered frames are copied
+       */
+      LBPTopStream(const LBPTopStream& other);
+
+      /**
+       * Destructor
+       */
+      virtual ~LBPTopStream();
+
+      /**
+       * Assignment; the LBPTop is shared, the buffered frames are copied
+       */
+      LBPTopStream& operator=(const LBPTopStream& other);
+
+      /**
+       * Accessors
+       */
+      const boost::shared_ptr<LBPTop> getLBPTop() const { return m_lbp_top; }
+      blitz::TinyVector<int,2> getFrameShape() const { return blitz::TinyVector<int,2>(m_frames.extent(1), m_frames.extent(2)); }
+      int getTemporalRadius() const { return m_radius_t; }
+      int getNumberOfFrames() const { return m_n_frames; }
+
+      /**
+       * Returns true, if enough frames have been pushed to extract the codes of the central frame
+       */
+      bool isReady() const { return m_n_frames >= 2 * m_radius_t + 1; }
+
+      /**
+       * Returns the shape of the XY, XT and YT code images of one frame
+       */
+      blitz::TinyVector<int,2> getOutputShape() const;
+
+      /**
+       * Returns the shape (#blocks, #labels_xy + #labels_xt + #labels_yt) of the block histograms of one frame
+       */
+      blitz::TinyVector<int,2> getHistogramShape(const blitz::TinyVector<int,2>& block_size, const blitz::TinyVector<int,2>& block_overlap) const;
+
+      /**
+       * Removes all buffered frames
+       */
+      void reset();
+
+      /**
+       * Adds the given frame to the buffer. If enough frames are buffered (see
+       * isReady), the XY, XT and YT codes of the central frame of the buffer,
+       * i.e., of the frame that was pushed getTemporalRadius() frames before
+       * the given one, are written to xy, xt and yt, and true is returned.
+       * Otherwise, the output is not touched, and false is returned.
+       * The XY frame, the XT slices and the YT slices are processed by n_threads threads.
+       */
+      template <typename T>
+        bool push(const blitz::Array<T,2>& frame, blitz::Array<uint16_t,2>& xy, blitz::Array<uint16_t,2>& xt, blitz::Array<uint16_t,2>& yt, const int n_threads = 1);
+
+      /**
+       * Adds the given frame to the buffer. If enough frames are buffered, the
+       * XY, XT and YT codes of the central frame are split into blocks, and
+       * the concatenated XY, XT and YT histograms of each block are written
+       * to the rows of histograms (see getHistogramShape), and true is returned.
+       */
+      template <typename T>
+        bool push(const blitz::Array<T,2>& frame, const blitz::TinyVector<int,2>& block_size, const blitz::TinyVector<int,2>& block_overlap, blitz::Array<uint64_t,2>& histograms, const int n_threads = 1);
+
+    private:
+
+      /**
+       * Copies the given frame into the ring buffer
+       */
+      template <typename T>
+        void addFrame(const blitz::Array<T,2>& frame);
+
+      /**
+       * Extracts the codes of the central frame of the buffer
+       */
+      void extract(blitz::Array<uint16_t,2>& xy, blitz::Array<uint16_t,2>& xt, blitz::Array<uint16_t,2>& yt, const int n_threads) const;
+
+      boost::shared_ptr<LBPTop> m_lbp_top;
+      int m_radius_t;
+      int m_border;
+
+      // the ring buffer stores each frame twice, so that the last 2*R_t+1 frames are always contiguous
+      blitz::Array<double,3> m_frames;
+      int m_n_frames;
+
+      // the code images, from which the histograms are computed
+      blitz::Array<uint16_t,2> m_xy, m_xt, m_yt;
+
+      // serializes the modifications of the ring buffer and the code images
+      mutable boost::mutex m_mutex;
+  };
+
+  template <typename T>
+    inline void LBPTopStream::addFrame(const blitz::Array<T,2>& frame)
+  {
+    bob::core::array::assertSameShape(frame, getFrameShape());
+    const int length = 2 * m_radius_t + 1;
+    const int slot = m_n_frames % length;
+    m_frames(slot, blitz::Range::all(), blitz::Range::all()) = blitz::cast<double>(frame);
+    m_frames(slot + length, blitz::Range::all(), blitz::Range::all()) = blitz::cast<double>(frame);
+    ++m_n_frames;
+  }
+
+  template <typename T>
+    inline bool LBPTopStream::push(const blitz::Array<T,2>& frame, blitz::Array<uint16_t,2>& xy, blitz::Array<uint16_t,2>& xt, blitz::Array<uint16_t,2>& yt, const int n_threads)
+  {
+    const blitz::TinyVector<int,2> shape = getOutputShape();
+    bob::core::array::assertSameShape(xy, shape);
+    bob::core::array::assertSameShape(xt, shape);
+    bob::core::array::assertSameShape(yt, shape);
+    boost::mutex::scoped_lock lock(m_mutex);
+    addFrame(frame);
+    if (!isReady()) return false;
+    extract(xy, xt, yt, n_threads);
+    return true;
+  }
+
+  template <typename T>
+    inline bool LBPTopStream::push(const blitz::Array<T,2>& frame, const blitz::TinyVector<int,2>& block_size, const blitz::TinyVector<int,2>& block_overlap, blitz::Array<uint64_t,2>& histograms, const int n_threads)
+  {
+    bob::core::array::assertSameShape(histograms, getHistogramShape(block_size, block_overlap));
+    boost::mutex::scoped_lock lock(m_mutex);
+    addFrame(frame);
+    if (!isReady()) return false;
+    extract(m_xy, m_xt, m_yt, n_threads);
+
+    // histogram the codes of all blocks, see bob::ip::base::blockReference
+    const int label_xt = m_lbp_top->getXY()->getMaxLabel(), label_yt = label_xt + m_lbp_top->getXT()->getMaxLabel();
+    const blitz::TinyVector<int,2> step = block_size - block_overlap;
+    const int n_blocks_h = (m_xy.extent(0) - block_overlap[0]) / step[0];
+    const int n_blocks_w = (m_xy.extent(1) - block_overlap[1]) / step[1];
+    std::vector<int> first_h, last_h, first_w, last_w;
+    _blockRange(m_xy.extent(0), block_size[0], step[0], n_blocks_h, first_h, last_h);
+    _blockRange(m_xy.extent(1), block_size[1], step[1], n_blocks_w, first_w, last_w);
+    histograms = 0;
+    for (int y = 0; y < m_xy.extent(0); ++y){
+      _accumulateBlockHistograms(&m_xy(y,0), 0, first_h[y], last_h[y], first_w, last_w, n_blocks_w, histograms);
+      _accumulateBlockHistograms(&m_xt(y,0), label_xt, first_h[y], last_h[y], first_w, last_w, n_blocks_w, histograms);
+      _accumulateBlockHistograms(&m_yt(y,0), label_yt, first_h[y], last_h[y], first_w, last_w, n_blocks_w, histograms);
+    }
+    return true;
+  }
+
+} } } // namespaces
+
+#endif /* BOB_IP_BASE_LBPTOP_STREAM_H */
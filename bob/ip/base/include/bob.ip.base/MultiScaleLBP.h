@@ -0,0 +1,151 @@
+/**
+ * @date Sat Oct 17 14:05:48 CEST 2026
+ *
+ * This file defines a class that extracts multi-block LBP codes of several block sizes from the same integral image
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#ifndef BOB_IP_BASE_MULTI_SCALE_LBP_H
+#define BOB_IP_BASE_MULTI_SCALE_LBP_H
+
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <boost/shared_ptr.hpp>
+#include <blitz/array.h>
+
+#include <bob.core/assert.h>
+#include <bob.ip.base/LBP.h>
+#include <bob.ip.base/Parallel.h>
+#include <bob.ip.base/PreparedImage.h>
+
+namespace bob { namespace ip { namespace base {
+
+  /**
+   * @brief This class extracts the codes of several multi-block LBP's
+   * (usually with different block sizes) from one image. The integral image
+   * of the input is computed only once and shared by all scales.
+   *
+   * The codes of all scales are written into one (n_scales, height, width)
+   * stack, where the code stack(s,y,x) of all scales s is computed for the
+   * same central pixel (y,x) + getOffset() of the image. Hence, the stack is
+   * restricted to the pixels, for which the LBP codes of all scales exist.
+   */
+  class MultiScaleLBP {
+
+    public:
+
+      /**
+       * @brief Constructs the extractor from copies of the given multi-block LBP's
+       */
+      MultiScaleLBP(const std::vector<boost::shared_ptr<LBP> >& lbps);
+
+      /**
+       * @brief Copy constructor; the LBP's, which are never modified, are shared
+       */
+      MultiScaleLBP(const MultiScaleLBP& other);
+
+      /**
+       * @brief Destructor
+       */
+      virtual ~MultiScaleLBP();
+
+      /**
+       * @brief Assignment; the LBP's, which are never modified, are shared
+       */
+      MultiScaleLBP& operator=(const MultiScaleLBP& other);
+
+      /**
+       * @brief Accessors
+       */
+      const std::vector<boost::shared_ptr<LBP> >& getLBPs() const { return m_lbps; }
+      int getNumberOfScales() const { return m_lbps.size(); }
+
+      /**
+       * @brief The position in the image, where the codes stack(:,0,0) are extracted
+       */
+      blitz::TinyVector<int,2> getOffset() const;
+
+      /**
+       * @brief Get the required shape of the dst output blitz array
+       */
+      blitz::TinyVector<int,3> getLBPShape(const blitz::TinyVector<int,2>& resolution, bool is_integral_image = false) const;
+
+      /**
+       * @brief Extracts the LBP codes of all scales from the given image or integral image.
+       * The integral image is computed only once; the rows of all scales are processed by n_threads threads.
+       * If n_threads is 0 or negative, all hardware threads are used.
+       */
+      template <typename T>
+        void extract(const blitz::Array<T,2>& src, blitz::Array<uint16_t,3>& dst, bool is_integral_image = false, const int n_threads = 1) const;
+
+      /**
+       * @brief Extracts the LBP codes of all scales from the integral image of the given prepared image
+       */
+      void extract(const PreparedImage& src, blitz::Array<uint16_t,3>& dst, const int n_threads = 1) const;
+
+    private:
+
+      template <typename T>
+        void extractFromIntegral(const blitz::Array<T,2>& integral_image, blitz::Array<uint16_t,3>& dst, const int n_threads) const;
+
+      // calls extractFromIntegral with the integral image computed by _withIntegralImage
+      struct ExtractIntegral;
+
+      std::vector<boost::shared_ptr<LBP> > m_lbps;
+  };
+
+  template <typename T>
+    inline void MultiScaleLBP::extractFromIntegral(const blitz::Array<T,2>& integral_image, blitz::Array<uint16_t,3>& dst, const int n_threads) const
+  {
+    bob::core::array::assertZeroBase(integral_image);
+    bob::core::array::assertZeroBase(dst);
+    bob::core::array::assertSameShape(dst, getLBPShape(integral_image.shape(), true));
+
+    // shift the integral image for each scale, so that the LBP images of all scales start at the same central pixel
+    // (the slices are created here, since blitz::Array's must not be copied in the threads)
+    const blitz::TinyVector<int,2> offset = getOffset();
+    std::vector<blitz::Array<T,2> > sources;
+    std::vector<blitz::Array<uint16_t,2> > targets;
+    for (int s = 0; s < getNumberOfScales(); ++s){
+      const blitz::TinyVector<int,2> shift = offset - m_lbps[s]->getOffset();
+      sources.push_back(integral_image(blitz::Range(shift[0], blitz::toEnd), blitz::Range(shift[1], blitz::toEnd)));
+      targets.push_back(dst(s, blitz::Range::all(), blitz::Range::all()));
+    }
+
+    // the rows of all scales are distributed over the threads
+    const int rows = dst.extent(1);
+    parallelFor(getNumberOfScales() * rows, n_threads, [&](int begin, int end){
+      for (int i = begin; i < end;){
+        const int s = i / rows, y_begin = i % rows, y_end = std::min(rows, y_begin + end - i);
+        m_lbps[s]->apply(sources[s], targets[s], y_begin, y_end);
+        i += y_end - y_begin;
+      }
+    });
+  }
+
+  struct MultiScaleLBP::ExtractIntegral{
+    const MultiScaleLBP& multi_scale_lbp;
+    blitz::Array<uint16_t,3>& dst;
+    const int n_threads;
+    template <typename U>
+      void operator()(const blitz::Array<U,2>& integral_image) const {
+        multi_scale_lbp.extractFromIntegral(integral_image, dst, n_threads);
+      }
+  };
+
+  template <typename T>
+    inline void MultiScaleLBP::extract(const blitz::Array<T,2>& src, blitz::Array<uint16_t,3>& dst, bool is_integral_image, const int n_threads) const
+  {
+    if (is_integral_image){
+      extractFromIntegral(src, dst, n_threads);
+      return;
+    }
+    // compute the integral image once; images of integral type are integrated exactly
+    _withIntegralImage(src, ExtractIntegral{*this, dst, n_threads});
+  }
+
+} } } // namespaces
+
+#endif // BOB_IP_BASE_MULTI_SCALE_LBP_H
@@ -0,0 +1,84 @@
+/**
+ * @date Fri Oct 16 10:12:31 CEST 2026
+ *
+ * @brief Helper functions to distribute independent work items over several threads
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#ifndef BOB_IP_BASE_PARALLEL_H
+#define BOB_IP_BASE_PARALLEL_H
+
+#include <vector>
+#include <algorithm>
+#include <exception>
+#include <boost/cstdint.hpp>
+#include <boost/thread.hpp>
+
+namespace bob { namespace ip { namespace base {
+
+  /**
+   * @brief Returns the number of threads that will be used to process the
+   * given number of items. When n_threads is 0 or negative, the number of
+   * hardware threads is used. Never returns more threads than items.
+   */
+  inline int getNumberOfThreads(const int n_threads, const int n_items){
+    int threads = n_threads > 0 ? n_threads : static_cast<int>(boost::thread::hardware_concurrency());
+    return std::max(std::min(threads, n_items), 1);
+  }
+
+  /**
+   * @brief Calls function(begin, end) on disjoint, contiguous ranges that
+   * cover [0, n_items), using getNumberOfThreads(n_threads, n_items) threads.
+   * The first range is processed by the calling thread.
+   *
+   * An exception raised in any of the threads is re-thrown in the calling
+   * thread, after all threads have finished.
+   *
+   * @warning The function must not create or copy blitz::Array's that share
+   * memory with arrays used by other threads, since the reference counting of
+   * blitz::Array's is not thread-safe. Create such slices beforehand.
+   */
+  template <typename F>
+  void parallelFor(const int n_items, const int n_threads, F function){
+    if (n_items <= 0) return;
+    const int threads = getNumberOfThreads(n_threads, n_items);
+    if (threads == 1){
+      function(0, n_items);
+      return;
+    }
+
+    std::vector<std::exception_ptr> exceptions(threads);
+    boost::thread_group group;
+    for (int t = threads; t--;){
+      const int begin = static_cast<int>(static_cast<int64_t>(n_items) * t / threads);
+      const int end = static_cast<int>(static_cast<int64_t>(n_items) * (t+1) / threads);
+      auto chunk = [&function, &exceptions, t, begin, end](){
+        try {
+          function(begin, end);
+        } catch (...) {
+          exceptions[t] = std::current_exception();
+        }
+      };
+      if (t){
+        try {
+          group.create_thread(chunk);
+        } catch (...) {
+          // the threads that are already running still reference our locals
+          group.join_all();
+          throw;
+        }
+      } else {
+        chunk();
+      }
+    }
+    group.join_all();
+
+    for (int t = 0; t < threads; ++t){
+      if (exceptions[t]) std::rethrow_exception(exceptions[t]);
+    }
+  }
+
+} } } // namespaces
+
+#endif // BOB_IP_BASE_PARALLEL_H
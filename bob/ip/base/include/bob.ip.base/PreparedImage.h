@@ -0,0 +1,110 @@
+/**
+ * @date Sat Oct 17 09:41:27 CEST 2026
+ *
+ * This file defines a class that holds an image together with its lazily computed integral images
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#ifndef BOB_IP_BASE_PREPARED_IMAGE_H
+#define BOB_IP_BASE_PREPARED_IMAGE_H
+
+#include <limits>
+#include <stdexcept>
+#include <boost/cstdint.hpp>
+#include <boost/format.hpp>
+#include <boost/thread/mutex.hpp>
+#include <blitz/array.h>
+
+#include <bob.core/assert.h>
+#include <bob.ip.base/IntegralImage.h>
+
+namespace bob { namespace ip { namespace base {
+
+  /**
+   * @brief This class stores a 2D image and computes its integral images
+   * only when they are requested for the first time. Hence, several
+   * consumers of integral images (e.g., multi-block LBP extraction and box
+   * statistics) can share the same integral images, and each image is
+   * integrated at most once.
+   *
+   * All integral images have an additional row and column of zeros in the
+   * front (see bob::ip::base::integral with addZeroBorder=true), i.e., the
+   * sum of the pixels src(y:y+h, x:x+w) is
+   *   I(y+h,x+w) + I(y,x) - I(y,x+w) - I(y+h,x)
+   *
+   * The integral images are computed in a thread-safe way, so that a
+   * PreparedImage can be shared between threads.
+   */
+  class PreparedImage
+  {
+    public:
+
+      /**
+        * @brief Copies the given image; images of integral type can
+        * additionally provide an exact integer integral image
+        */
+      template <typename T>
+      PreparedImage(const blitz::Array<T,2>& src);
+
+      /**
+        * @brief Accessors
+        */
+      blitz::TinyVector<int,2> getShape() const { return m_source.shape(); }
+      const blitz::Array<double,2>& getSource() const { return m_source; }
+      bool isIntegerImage() const { return m_isInteger; }
+
+      /**
+        * @brief Returns the integral image of the source, which is computed at the first call
+        */
+      const blitz::Array<double,2>& getIntegral() const;
+
+      /**
+        * @brief Returns the integral image of the squared source, which is computed at the first call
+        */
+      const blitz::Array<double,2>& getSquaredIntegral() const;
+
+      /**
+        * @brief Returns the exact integral image of an image of integral type, which is computed at the first call
+        */
+      const blitz::Array<int64_t,2>& getIntegerIntegral() const;
+
+      /**
+        * @brief Box statistics of the pixels src(y:y+h, x:x+w)
+        */
+      double boxSum(const int y, const int x, const int h, const int w) const;
+      double boxMean(const int y, const int x, const int h, const int w) const;
+      double boxVariance(const int y, const int x, const int h, const int w) const;
+
+    private:
+
+      // the prepared image should not be copied, but shared
+      PreparedImage(const PreparedImage&);
+      PreparedImage& operator=(const PreparedImage&);
+
+      void checkBox(const int y, const int x, const int h, const int w) const;
+
+      /**
+        * Attributes
+        */
+      blitz::Array<double,2> m_source;
+      bool m_isInteger;
+
+      // the lazily computed integral images
+      mutable blitz::Array<double,2> m_integral;
+      mutable blitz::Array<double,2> m_squaredIntegral;
+      mutable blitz::Array<int64_t,2> m_integerIntegral;
+      mutable boost::mutex m_mutex;
+  };
+
+  template <typename T>
+  PreparedImage::PreparedImage(const blitz::Array<T,2>& src)
+  : m_source(src.shape()),
+    m_isInteger(std::numeric_limits<T>::is_integer)
+  {
+    m_source = blitz::cast<double>(src);
+  }
+
+} } } // namespaces
+
+#endif // BOB_IP_BASE_PREPARED_IMAGE_H
@@ -0,0 +1,171 @@
+/**
+ * @date Fri Oct 16 15:04:12 CEST 2026
+ *
+ * This file defines a class to apply the same affine transformation to many images using a pre-computed coordinate map
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#ifndef BOB_IP_BASE_REMAP_H
+#define BOB_IP_BASE_REMAP_H
+
+#include <vector>
+#include <boost/cstdint.hpp>
+#include <bob.core/assert.h>
+#include <bob.core/check.h>
+
+#include <bob.ip.base/Affine.h>
+#include <bob.ip.base/GeomNorm.h>
+
+namespace bob { namespace ip { namespace base {
+
+  /**
+   * @brief This class pre-computes, for a fixed affine transformation and
+   * fixed source and target image shapes, the source offsets and the
+   * bi-linear interpolation weights of all target pixels.
+   * The transformation can then be applied to any number of images without
+   * re-computing any coordinates.
+   *
+   * The target pixel (y,x) is interpolated from the source image at position
+   *   source_y = matrix(0,0) * y + matrix(0,1) * x + matrix(0,2)
+   *   source_x = matrix(1,0) * y + matrix(1,1) * x + matrix(1,2)
+   * Source pixels outside the source image are treated as 0, as in
+   * bob::ip::base::transform. The interpolation weights are quantized to 15
+   * bits, so that the results might differ slightly from
+   * bob::ip::base::transform.
+   */
+  class Remap
+  {
+    public:
+
+      /**
+        * @brief Constructor for a general affine transformation, given as 2x3 matrix
+        */
+      Remap(
+        const blitz::Array<double,2>& matrix,
+        const blitz::TinyVector<int,2>& src_shape,
+        const blitz::TinyVector<int,2>& dst_shape
+      );
+
+      /**
+        * @brief Constructor for the transformation that the given GeomNorm
+        * applies to source images of the given shape with the given center
+        */
+      Remap(
+        const GeomNorm& geomNorm,
+        const blitz::TinyVector<double,2>& center,
+        const blitz::TinyVector<int,2>& src_shape
+      );
+
+      /**
+        * @brief Accessors
+        */
+      const blitz::TinyVector<int,2>& getSourceShape() const { return m_srcShape; }
+      const blitz::TinyVector<int,2>& getTargetShape() const { return m_dstShape; }
+      const blitz::Array<double,2>& getMatrix() const { return m_matrix; }
+
+      /**
+        * @brief Applies the transformation to the given 2D image; the output
+        * can be of any arithmetic type (see bob::ip::base::transform)
+        */
+      template <typename T, typename U>
+      void process(const blitz::Array<T,2>& src, blitz::Array<U,2>& dst) const;
+
+      /**
+        * @brief Applies the transformation to each plane of the given 3D image
+        */
+      template <typename T, typename U>
+      void process(const blitz::Array<T,3>& src, blitz::Array<U,3>& dst) const;
+
+    private:
+
+      /** The number of bits of the quantized interpolation weights */
+      static const int s_bits = 15;
+
+      /** A target pixel, for which all four source pixels lie inside the source image */
+      struct Entry {
+        int32_t offset; // offset of the upper left source pixel
+        uint16_t wy, wx; // quantized interpolation weights of the lower and the right source pixels
+      };
+
+      /** A target pixel close to the border, where the weights of source pixels outside the source image are set to 0 */
+      struct BorderEntry {
+        int32_t offset[4];
+        double weight[4];
+      };
+
+      void init();
+
+      template <typename T, typename U>
+      void processBorder(const T* src, blitz::Array<U,2>& dst, const int y, const int x, const BorderEntry& entry) const{
+        dst(y,x) = _convert<U>(entry.weight[0] * src[entry.offset[0]] + entry.weight[1] * src[entry.offset[1]] + entry.weight[2] * src[entry.offset[2]] + entry.weight[3] * src[entry.offset[3]]);
+      }
+
+      /**
+        * Attributes
+        */
+      blitz::Array<double,2> m_matrix;
+      blitz::TinyVector<int,2> m_srcShape;
+      blitz::TinyVector<int,2> m_dstShape;
+
+      // for each target row, the range [begin, end) of interior pixels
+      std::vector<int> m_rowBegin;
+      std::vector<int> m_rowEnd;
+      std::vector<Entry> m_interior;
+      std::vector<BorderEntry> m_border;
+  };
+
+  template <typename T, typename U>
+  void Remap::process(const blitz::Array<T,2>& src, blitz::Array<U,2>& dst) const
+  {
+    // Check input and output
+    bob::core::array::assertZeroBase(src);
+    bob::core::array::assertSameShape(src, m_srcShape);
+    bob::core::array::assertZeroBase(dst);
+    bob::core::array::assertSameShape(dst, m_dstShape);
+
+    if (!src.size()){
+      dst = U(0);
+      return;
+    }
+    // the offsets are computed for row-major contiguous source images
+    if (src.stride(1) != 1 || src.stride(0) != src.extent(1)){
+      blitz::Array<T,2> contiguous(src.shape());
+      contiguous = src;
+      process(contiguous, dst);
+      return;
+    }
+
+    const T* s = src.data();
+    const int width = m_srcShape[1];
+    const double scale = 1. / (1 << s_bits);
+    std::vector<Entry>::const_iterator interior = m_interior.begin();
+    std::vector<BorderEntry>::const_iterator border = m_border.begin();
+    for (int y = 0; y < m_dstShape[0]; ++y){
+      const int x_begin = m_rowBegin[y], x_end = m_rowEnd[y];
+      int x = 0;
+      for (; x < x_begin; ++x, ++border)
+        processBorder(s, dst, y, x, *border);
+      for (; x < x_end; ++x, ++interior)
+        dst(y,x) = _bilinear<T,U>::interpolate(s + interior->offset, width, 1, interior->wy * scale, interior->wx * scale);
+      for (; x < m_dstShape[1]; ++x, ++border)
+        processBorder(s, dst, y, x, *border);
+    }
+  }
+
+  template <typename T, typename U>
+  void Remap::process(const blitz::Array<T,3>& src, blitz::Array<U,3>& dst) const
+  {
+    bob::core::array::assertSameDimensionLength(src.extent(0), dst.extent(0));
+    for (int p = 0; p < dst.extent(0); ++p){
+      const blitz::Array<T,2> src_slice = src(p, blitz::Range::all(), blitz::Range::all());
+      blitz::Array<U,2> dst_slice = dst(p, blitz::Range::all(), blitz::Range::all());
+
+      // Process one plane
+      process(src_slice, dst_slice);
+    }
+  }
+
+} } } // namespaces
+
+#endif // BOB_IP_BASE_REMAP_H
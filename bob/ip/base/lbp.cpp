@@ -818,18 +818,26 @@ static auto extract = bob::extension::FunctionDoc(
   "This function extracts the LBP features from an image",
   "LBP features can be extracted either for the whole image, or at a single location in the image. "
   "When MB-LBP features will be extracted, an integral image will be computed to speed up the calculation. "
+  "For images of type uint8 and uint16, the integral image is computed with unsigned integers, so that the block sums are compared exactly. "
   "The integral image calculation can be done **before** this function is called, and the integral image can be passed to this function directly. "
-  "In this case, please set the ``is_integral_image`` parameter to ``True``.\n\n"
+  "In this case, please set the ``is_integral_image`` parameter to ``True``. "
+  "Alternatively, a :py:class:`PreparedImage` can be given as ``input``, which computes its integral image only once, however often it is used.\n\n"
+  "When extracting the features of the whole image, the rows of the output image can be split into bands, which are processed by ``n_threads`` threads. "
+  "The ``n_threads`` parameter can only be given as keyword argument. "
+  "The global interpreter lock is released during the extraction.\n\n"
   ".. note::\n\n  The :py:func:`__call__` function is an alias for this method.",
   true
 )
 .add_prototype("input, [is_integral_image]", "output")
 .add_prototype("input, position, [is_integral_image]", "code")
 .add_prototype("input, output, [is_integral_image]")
-.add_parameter("input", "array_like (2D)", "The input image for which LBP features should be extracted")
+.add_prototype("input, [is_integral_image], [n_threads]", "output")
+.add_prototype("input, output, [is_integral_image], [n_threads]")
+.add_parameter("input", "array_like (2D) or :py:class:`PreparedImage`", "The input image for which LBP features should be extracted")
 .add_parameter("position", "(int, int)", "The position in the ``input`` image, where the LBP code should be extracted; assure that you don't try to provide positions outside of the :py:attr:`offset`")
 .add_parameter("output", "array_like (2D, uint16)", "The output image that need to be of shape :py:func:`lbp_shape`")
 .add_parameter("is_integral_image", "bool", "[default: ``False``] Is the given ``input`` image an integral image?")
+.add_parameter("n_threads", "int", "[default: 1] The number of threads to use; if 0 or negative, all hardware threads are used")
 .add_return("output", "array_like (2D, uint16)", "The resulting image of LBP codes")
 .add_return("code", "uint16", "The resulting LBP code at the given position in the image")
 ;
@@ -840,8 +848,31 @@ static PyObject* extract_inner(PyBobIpBaseLBPObject* self, PyBlitzArrayObject* i
   return Py_BuildValue("H", v);
 }
 template <typename T>
-static PyObject* extract_inner(PyBobIpBaseLBPObject* self, PyBlitzArrayObject* input, PyBlitzArrayObject* output, bool iii, bool ret_img){
-  self->cxx->extract(*PyBlitzArrayCxx_AsBlitz<T,2>(input), *PyBlitzArrayCxx_AsBlitz<uint16_t,2>(output), iii);
+static PyObject* extract_inner(PyBobIpBaseLBPObject* self, PyBlitzArrayObject* input, PyBlitzArrayObject* output, bool iii, bool ret_img, int n_threads){
+  {
+    const blitz::Array<T,2>& src = *PyBlitzArrayCxx_AsBlitz<T,2>(input);
+    blitz::Array<uint16_t,2>& dst = *PyBlitzArrayCxx_AsBlitz<uint16_t,2>(output);
+    ReleaseGIL gil;
+    self->cxx->extract(src, dst, iii, n_threads);
+  }
+  if (ret_img){
+    return PyBlitzArray_AsNumpyArray(output, 0);
+  } else {
+    Py_RETURN_NONE;
+  }
+}
+
+static PyObject* extract_inner(PyBobIpBaseLBPObject* self, PyBobIpBasePreparedImageObject* input, const blitz::TinyVector<int,2>& position){
+  uint16_t v = self->cxx->extract(*input->cxx, position[0], position[1]);
+  return Py_BuildValue("H", v);
+}
+static PyObject* extract_inner(PyBobIpBaseLBPObject* self, PyBobIpBasePreparedImageObject* input, PyBlitzArrayObject* output, bool ret_img, int n_threads){
+  {
+    const bob::ip::base::PreparedImage& src = *input->cxx;
+    blitz::Array<uint16_t,2>& dst = *PyBlitzArrayCxx_AsBlitz<uint16_t,2>(output);
+    ReleaseGIL gil;
+    self->cxx->extract(src, dst, n_threads);
+  }
   if (ret_img){
     return PyBlitzArray_AsNumpyArray(output, 0);
   } else {
@@ -855,6 +886,18 @@ static PyObject* PyBobIpBaseLBP_extract(PyBobIpBaseLBPObject* self, PyObject* ar
   char** kwlist2 = extract.kwlist(1);
   char** kwlist3 = extract.kwlist(2);
 
+  // the number of threads can only be selected by keyword; remove it from a copy of the keyword arguments
+  int n_threads = 1;
+  boost::shared_ptr<PyObject> kwargs_;
+  PyObject* n_threads_object = kwargs ? PyDict_GetItemString(kwargs, "n_threads") : 0;
+  if (n_threads_object){
+    n_threads = PyLong_AsLong(n_threads_object);
+    if (PyErr_Occurred()) return 0;
+    kwargs = PyDict_Copy(kwargs);
+    kwargs_ = make_safe(kwargs);
+    if (PyDict_DelItemString(kwargs, "n_threads") < 0) return 0;
+  }
+
   // get the number of command line arguments
   Py_ssize_t nargs = (args?PyTuple_Size(args):0) + (kwargs?PyDict_Size(kwargs):0);
 
@@ -884,7 +927,12 @@ static PyObject* PyBobIpBaseLBP_extract(PyBobIpBaseLBPObject* self, PyObject* ar
     return 0;
   }
 
+  // the input might be a prepared image instead of an array
+  PyObject* first = (args && PyTuple_Size(args)) ? PyTuple_GET_ITEM(args,0) : (kwargs ? PyDict_GetItemString(kwargs, kwlist1[0]) : 0);
+  bool is_prepared = first && PyBobIpBasePreparedImage_Check(first);
+
   PyBlitzArrayObject* input = 0,* output = 0;
+  PyBobIpBasePreparedImageObject* prepared = 0;
   PyObject* iii = 0; // is_integral_image
   auto input_ = make_xsafe(input);
   auto output_ = make_xsafe(output);
@@ -894,35 +942,56 @@ static PyObject* PyBobIpBaseLBP_extract(PyBobIpBaseLBPObject* self, PyObject* ar
   switch (how){
     case 1:
       // input image only
-      if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&|O!", kwlist1, &PyBlitzArray_Converter, &input, &PyBool_Type, &iii)){
+      if (!(is_prepared ?
+        PyArg_ParseTupleAndKeywords(args, kwargs, "O!|O!", kwlist1, &PyBobIpBasePreparedImage_Type, &prepared, &PyBool_Type, &iii) :
+        PyArg_ParseTupleAndKeywords(args, kwargs, "O&|O!", kwlist1, &PyBlitzArray_Converter, &input, &PyBool_Type, &iii)
+      )){
         extract.print_usage();
         return 0;
       }
       break;
     case 2:
       // with position
-      if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&(ii)|O!", kwlist2, &PyBlitzArray_Converter, &input, &position[0], &position[1], &PyBool_Type, &iii)){
+      if (!(is_prepared ?
+        PyArg_ParseTupleAndKeywords(args, kwargs, "O!(ii)|O!", kwlist2, &PyBobIpBasePreparedImage_Type, &prepared, &position[0], &position[1], &PyBool_Type, &iii) :
+        PyArg_ParseTupleAndKeywords(args, kwargs, "O&(ii)|O!", kwlist2, &PyBlitzArray_Converter, &input, &position[0], &position[1], &PyBool_Type, &iii)
+      )){
         extract.print_usage();
         return 0;
       }
       break;
     case 3:
       // with input and output image
-      if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&O&|O!", kwlist3, &PyBlitzArray_Converter, &input, &PyBlitzArray_OutputConverter, &output, &PyBool_Type, &iii)){
+      if (!(is_prepared ?
+        PyArg_ParseTupleAndKeywords(args, kwargs, "O!O&|O!", kwlist3, &PyBobIpBasePreparedImage_Type, &prepared, &PyBlitzArray_OutputConverter, &output, &PyBool_Type, &iii) :
+        PyArg_ParseTupleAndKeywords(args, kwargs, "O&O&|O!", kwlist3, &PyBlitzArray_Converter, &input, &PyBlitzArray_OutputConverter, &output, &PyBool_Type, &iii)
+      )){
         extract.print_usage();
         return 0;
       }
       output_ = make_safe(output);
       break;
   }
-  input_ = make_safe(input);
-  // perform checks on input and output image
-  if (input->ndim != 2){
-    PyErr_Format(PyExc_TypeError, "`%s' only extracts from 2D arrays", Py_TYPE(self)->tp_name);
-    extract.print_usage();
-    return 0;
+  blitz::TinyVector<int,2> input_shape;
+  if (prepared){
+    // prepared images provide their integral images themselves
+    if (f(iii)){
+      PyErr_Format(PyExc_TypeError, "`%s' cannot extract from prepared images with is_integral_image=True", Py_TYPE(self)->tp_name);
+      extract.print_usage();
+      return 0;
+    }
+    input_shape = prepared->cxx->getShape();
+  } else {
+    input_ = make_safe(input);
+    // perform checks on input and output image
+    if (input->ndim != 2){
+      PyErr_Format(PyExc_TypeError, "`%s' only extracts from 2D arrays", Py_TYPE(self)->tp_name);
+      extract.print_usage();
+      return 0;
+    }
+    input_shape = blitz::TinyVector<int,2>(input->shape[0], input->shape[1]);
   }
-  auto shape = self->cxx->getLBPShape(blitz::TinyVector<int,2>(input->shape[0], input->shape[1]), f(iii));
+  auto shape = self->cxx->getLBPShape(input_shape, f(iii));
   if (output){
     if (output->ndim != 2){
       PyErr_Format(PyExc_TypeError, "`%s' only extracts to 2D arrays", Py_TYPE(self)->tp_name);
@@ -941,13 +1010,17 @@ static PyObject* PyBobIpBaseLBP_extract(PyBobIpBaseLBPObject* self, PyObject* ar
   }
 
   // finally, extract the features
+  if (prepared){
+    return how == 2 ? extract_inner(self, prepared, position) : extract_inner(self, prepared, output, how == 1, n_threads);
+  }
   switch (input->type_num){
-    case NPY_UINT8:   return how == 2 ? extract_inner<uint8_t>(self, input, position, f(iii))  : extract_inner<uint8_t>(self, input, output, f(iii), how == 1);
-    case NPY_UINT16:  return how == 2 ? extract_inner<uint16_t>(self, input, position, f(iii)) : extract_inner<uint16_t>(self, input, output, f(iii), how == 1);
-    case NPY_FLOAT64: return how == 2 ? extract_inner<double>(self, input, position, f(iii))   : extract_inner<double>(self, input, output, f(iii), how == 1);
+    case NPY_UINT8:   return how == 2 ? extract_inner<uint8_t>(self, input, position, f(iii))  : extract_inner<uint8_t>(self, input, output, f(iii), how == 1, n_threads);
+    case NPY_UINT16:  return how == 2 ? extract_inner<uint16_t>(self, input, position, f(iii)) : extract_inner<uint16_t>(self, input, output, f(iii), how == 1, n_threads);
+    case NPY_FLOAT32: return how == 2 ? extract_inner<float>(self, input, position, f(iii))    : extract_inner<float>(self, input, output, f(iii), how == 1, n_threads);
+    case NPY_FLOAT64: return how == 2 ? extract_inner<double>(self, input, position, f(iii))   : extract_inner<double>(self, input, output, f(iii), how == 1, n_threads);
     default:
       extract.print_usage();
-      PyErr_Format(PyExc_TypeError, "`%s' extracts only from images of types uint8, uint16 or float, and not from %s", Py_TYPE(self)->tp_name, PyBlitzArray_TypenumAsString(input->type_num));
+      PyErr_Format(PyExc_TypeError, "`%s' extracts only from images of types uint8, uint16, float32 or float64, and not from %s", Py_TYPE(self)->tp_name, PyBlitzArray_TypenumAsString(input->type_num));
       return 0;
   }
   BOB_CATCH_MEMBER("cannot extract LBP from image", 0)
@@ -0,0 +1,331 @@
+/**
+ * @date Sat Oct 17 16:21:03 CEST 2026
+ *
+ * @brief Binds the LBPFeatureSet class to python
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include "main.h"
+
+/******************************************************************/
+/************ Constructor Section *********************************/
+/******************************************************************/
+
+static auto LBPFeatureSet_doc = bob::extension::ClassDoc(
+  BOB_EXT_MODULE_PREFIX ".LBPFeatureSet",
+  "Evaluates a fixed list of LBP features in many windows of an image",
+  "Each feature is defined by an :py:class:`LBP` extractor and a position ``(y, x)`` relative to the origin of a window. "
+  "The feature ``f`` in the window with origin ``(oy, ox)`` is the code that ``lbps[f].extract(image, (oy + y_f, ox + x_f))`` returns. "
+  "This is typically used to evaluate the LBP features selected by a boosted classifier in all candidate windows of a sliding-window detector.\n\n"
+  "All features of all windows are computed in one call, where the integral image required by multi-block LBP's is computed only once, and the windows are processed in parallel."
+).add_constructor(
+  bob::extension::FunctionDoc(
+    "__init__",
+    "Creates a feature set from the given LBP extractors and positions",
+    "The same :py:class:`LBP` extractor might be used by several features. "
+    "The :py:class:`LBP` extractors are shared with this object.",
+    true
+  )
+  .add_prototype("lbps, positions", "")
+  .add_parameter("lbps", "[:py:class:`LBP`]", "The LBP extractors of all features")
+  .add_parameter("positions", "[(int, int)]", "The positions of all features, relative to the window origin")
+);
+
+
+static int PyBobIpBaseLBPFeatureSet_init(PyBobIpBaseLBPFeatureSetObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  char** kwlist = LBPFeatureSet_doc.kwlist(0);
+
+  PyObject* lbp_list,* position_list;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OO", kwlist, &lbp_list, &position_list)){
+    LBPFeatureSet_doc.print_usage();
+    return -1;
+  }
+
+  std::vector<boost::shared_ptr<bob::ip::base::LBP> > lbps;
+  PyObject* seq = PySequence_Fast(lbp_list, "expected a sequence of LBP objects");
+  if (!seq) return -1;
+  auto seq_ = make_safe(seq);
+  for (Py_ssize_t i = 0; i < PySequence_Fast_GET_SIZE(seq); ++i){
+    PyObject* lbp = PySequence_Fast_GET_ITEM(seq, i);
+    if (!PyBobIpBaseLBP_Check(lbp)){
+      PyErr_Format(PyExc_TypeError, "`%s' requires a sequence of %s objects, but element %" PY_FORMAT_SIZE_T "d is a %s", Py_TYPE(self)->tp_name, PyBobIpBaseLBP_Type.tp_name, i, Py_TYPE(lbp)->tp_name);
+      LBPFeatureSet_doc.print_usage();
+      return -1;
+    }
+    lbps.push_back(reinterpret_cast<PyBobIpBaseLBPObject*>(lbp)->cxx);
+  }
+
+  std::vector<blitz::TinyVector<int,2> > positions;
+  PyObject* pos = PySequence_Fast(position_list, "expected a sequence of (int, int) positions");
+  if (!pos) return -1;
+  auto pos_ = make_safe(pos);
+  for (Py_ssize_t i = 0; i < PySequence_Fast_GET_SIZE(pos); ++i){
+    blitz::TinyVector<int,2> position;
+    if (!PyArg_Parse(PySequence_Fast_GET_ITEM(pos, i), "(ii)", &position[0], &position[1])){
+      LBPFeatureSet_doc.print_usage();
+      return -1;
+    }
+    positions.push_back(position);
+  }
+
+  self->cxx.reset(new bob::ip::base::LBPFeatureSet(lbps, positions));
+  return 0;
+
+  BOB_CATCH_MEMBER("cannot create LBPFeatureSet", -1)
+}
+
+static void PyBobIpBaseLBPFeatureSet_delete(PyBobIpBaseLBPFeatureSetObject* self) {
+  self->cxx.reset();
+  Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+int PyBobIpBaseLBPFeatureSet_Check(PyObject* o) {
+  return PyObject_IsInstance(o, reinterpret_cast<PyObject*>(&PyBobIpBaseLBPFeatureSet_Type));
+}
+
+static Py_ssize_t PyBobIpBaseLBPFeatureSet_len(PyBobIpBaseLBPFeatureSetObject* self) {
+  return self->cxx->getNumberOfFeatures();
+}
+
+
+/******************************************************************/
+/************ Variables Section ***********************************/
+/******************************************************************/
+
+static auto lbps = bob::extension::VariableDoc(
+  "lbps",
+  "(:py:class:`LBP`, ...)",
+  "The LBP extractors of all features, which are shared with this object, read access only"
+);
+PyObject* PyBobIpBaseLBPFeatureSet_getLBPs(PyBobIpBaseLBPFeatureSetObject* self, void*){
+  BOB_TRY
+  const std::vector<boost::shared_ptr<bob::ip::base::LBP> >& l = self->cxx->getLBPs();
+  PyObject* tuple = PyTuple_New(l.size());
+  if (!tuple) return 0;
+  auto tuple_ = make_safe(tuple);
+  for (size_t f = 0; f < l.size(); ++f){
+    PyBobIpBaseLBPObject* lbp = (PyBobIpBaseLBPObject*)PyBobIpBaseLBP_Type.tp_alloc(&PyBobIpBaseLBP_Type, 0);
+    if (!lbp) return 0;
+    lbp->cxx = l[f];
+    PyTuple_SET_ITEM(tuple, f, (PyObject*)lbp);
+  }
+  return Py_BuildValue("O", tuple);
+  BOB_CATCH_MEMBER("lbps could not be read", 0)
+}
+
+static auto positions = bob::extension::VariableDoc(
+  "positions",
+  "((int, int), ...)",
+  "The positions of all features relative to the window origin, read access only"
+);
+PyObject* PyBobIpBaseLBPFeatureSet_getPositions(PyBobIpBaseLBPFeatureSetObject* self, void*){
+  BOB_TRY
+  const std::vector<blitz::TinyVector<int,2> >& p = self->cxx->getPositions();
+  PyObject* tuple = PyTuple_New(p.size());
+  if (!tuple) return 0;
+  auto tuple_ = make_safe(tuple);
+  for (size_t f = 0; f < p.size(); ++f){
+    PyObject* position = Py_BuildValue("(ii)", p[f][0], p[f][1]);
+    if (!position) return 0;
+    PyTuple_SET_ITEM(tuple, f, position);
+  }
+  return Py_BuildValue("O", tuple);
+  BOB_CATCH_MEMBER("positions could not be read", 0)
+}
+
+static PyGetSetDef PyBobIpBaseLBPFeatureSet_getseters[] = {
+    {
+      lbps.name(),
+      (getter)PyBobIpBaseLBPFeatureSet_getLBPs,
+      0,
+      lbps.doc(),
+      0
+    },
+    {
+      positions.name(),
+      (getter)PyBobIpBaseLBPFeatureSet_getPositions,
+      0,
+      positions.doc(),
+      0
+    },
+    {0}  /* Sentinel */
+};
+
+
+/******************************************************************/
+/************ Functions Section ***********************************/
+/******************************************************************/
+
+static auto extract = bob::extension::FunctionDoc(
+  "extract",
+  "This function evaluates all features in all given windows of an image",
+  "The window origins are given as a 2D array of shape ``(n_windows, 2)``, where each row contains the ``(y, x)`` origin of a window. "
+  "All windows are checked before the features are evaluated, i.e., a ``RuntimeError`` is raised when any feature of any window cannot be extracted from the ``input``. "
+  "Alternatively to an image, a :py:class:`PreparedImage` can be given as ``input``, whose integral image is re-used.\n\n"
+  "The windows are processed by ``n_threads`` threads, and the global interpreter lock is released during the evaluation.\n\n"
+  ".. note::\n\n  The :py:func:`__call__` function is an alias for this method.",
+  true
+)
+.add_prototype("input, windows, [output], [n_threads]", "output")
+.add_parameter("input", "array_like (2D) or :py:class:`PreparedImage`", "The input image from which the features should be extracted")
+.add_parameter("windows", "array_like (2D, int32 or int64)", "The ``(y, x)`` origins of all windows")
+.add_parameter("output", "array_like (2D, uint16)", "[default: ``None``] If given, the output features, which needs to be of shape ``(n_windows, len(self))``")
+.add_parameter("n_threads", "int", "[default: 1] The number of threads to use; if 0 or negative, all hardware threads are used")
+.add_return("output", "array_like (2D, uint16)", "The LBP codes of all features (columns) in all windows (rows)")
+;
+
+template <typename T>
+static void extract_inner(PyBobIpBaseLBPFeatureSetObject* self, PyBlitzArrayObject* input, const blitz::Array<int,2>& windows, PyBlitzArrayObject* output, int n_threads){
+  const blitz::Array<T,2>& src = *PyBlitzArrayCxx_AsBlitz<T,2>(input);
+  blitz::Array<uint16_t,2>& dst = *PyBlitzArrayCxx_AsBlitz<uint16_t,2>(output);
+  ReleaseGIL gil;
+  self->cxx->extract(src, windows, dst, n_threads);
+}
+
+static PyObject* PyBobIpBaseLBPFeatureSet_extract(PyBobIpBaseLBPFeatureSetObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+  char** kwlist = extract.kwlist(0);
+
+  PyObject* input_object;
+  PyBlitzArrayObject* window_array,* output = 0;
+  int n_threads = 1;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OO&|O&i", kwlist, &input_object, &PyBlitzArray_Converter, &window_array, &PyBlitzArray_OutputConverter, &output, &n_threads)){
+    extract.print_usage();
+    return 0;
+  }
+  auto window_array_ = make_safe(window_array);
+  auto output_ = make_xsafe(output);
+
+  // the window origins are evaluated as 32 bit integers
+  if (window_array->ndim != 2 || (window_array->type_num != NPY_INT32 && window_array->type_num != NPY_INT64)){
+    PyErr_Format(PyExc_TypeError, "`%s' requires the windows to be a 2D array of type int32 or int64", Py_TYPE(self)->tp_name);
+    extract.print_usage();
+    return 0;
+  }
+  blitz::Array<int,2> windows;
+  if (window_array->type_num == NPY_INT32)
+    windows.reference(*PyBlitzArrayCxx_AsBlitz<int32_t,2>(window_array));
+  else {
+    const blitz::Array<int64_t,2>& windows64 = *PyBlitzArrayCxx_AsBlitz<int64_t,2>(window_array);
+    if (windows64.size() && (blitz::min(windows64) < std::numeric_limits<int>::min() || blitz::max(windows64) > std::numeric_limits<int>::max())){
+      PyErr_Format(PyExc_ValueError, "`%s' requires the window origins to be in the range of 32 bit integers", Py_TYPE(self)->tp_name);
+      extract.print_usage();
+      return 0;
+    }
+    windows.reference(blitz::Array<int,2>(blitz::cast<int>(windows64)));
+  }
+
+  // the input might be a prepared image instead of an array
+  PyBobIpBasePreparedImageObject* prepared = 0;
+  PyBlitzArrayObject* input = 0;
+  auto input_ = make_xsafe(input);
+  if (PyBobIpBasePreparedImage_Check(input_object)){
+    prepared = reinterpret_cast<PyBobIpBasePreparedImageObject*>(input_object);
+  } else {
+    if (!PyBlitzArray_Converter(input_object, &input)){
+      extract.print_usage();
+      return 0;
+    }
+    input_ = make_safe(input);
+    if (input->ndim != 2){
+      PyErr_Format(PyExc_TypeError, "`%s' only extracts from 2D arrays", Py_TYPE(self)->tp_name);
+      extract.print_usage();
+      return 0;
+    }
+  }
+
+  const Py_ssize_t n_windows = window_array->shape[0], n_features = self->cxx->getNumberOfFeatures();
+  if (output){
+    if (output->ndim != 2 || output->type_num != NPY_UINT16){
+      PyErr_Format(PyExc_TypeError, "`%s' only extracts to 2D arrays of type uint16", Py_TYPE(self)->tp_name);
+      extract.print_usage();
+      return 0;
+    }
+    if (output->shape[0] != n_windows || output->shape[1] != n_features){
+      PyErr_Format(PyExc_TypeError, "`%s' requires the shape of the output to be (%" PY_FORMAT_SIZE_T "d, %" PY_FORMAT_SIZE_T "d), but it is (%" PY_FORMAT_SIZE_T "d, %" PY_FORMAT_SIZE_T "d)", Py_TYPE(self)->tp_name, n_windows, n_features, output->shape[0], output->shape[1]);
+      extract.print_usage();
+      return 0;
+    }
+  } else {
+    Py_ssize_t osize[] = {n_windows, n_features};
+    output = (PyBlitzArrayObject*)PyBlitzArray_SimpleNew(NPY_UINT16, 2, osize);
+    output_ = make_safe(output);
+  }
+
+  // finally, extract the features
+  if (prepared){
+    const bob::ip::base::PreparedImage& src = *prepared->cxx;
+    blitz::Array<uint16_t,2>& dst = *PyBlitzArrayCxx_AsBlitz<uint16_t,2>(output);
+    ReleaseGIL gil;
+    self->cxx->extract(src, windows, dst, n_threads);
+  } else {
+    switch (input->type_num){
+      case NPY_UINT8:   extract_inner<uint8_t>(self, input, windows, output, n_threads); break;
+      case NPY_UINT16:  extract_inner<uint16_t>(self, input, windows, output, n_threads); break;
+      case NPY_UINT32:  extract_inner<uint32_t>(self, input, windows, output, n_threads); break;
+      case NPY_FLOAT32: extract_inner<float>(self, input, windows, output, n_threads); break;
+      case NPY_FLOAT64: extract_inner<double>(self, input, windows, output, n_threads); break;
+      default:
+        extract.print_usage();
+        PyErr_Format(PyExc_TypeError, "`%s' extracts only from images of types uint8, uint16, uint32, float32 or float64, and not from %s", Py_TYPE(self)->tp_name, PyBlitzArray_TypenumAsString(input->type_num));
+        return 0;
+    }
+  }
+
+  return PyBlitzArray_AsNumpyArray(output, 0);
+
+  BOB_CATCH_MEMBER("cannot extract LBP features", 0)
+}
+
+static PyMethodDef PyBobIpBaseLBPFeatureSet_methods[] = {
+  {
+    extract.name(),
+    (PyCFunction)PyBobIpBaseLBPFeatureSet_extract,
+    METH_VARARGS|METH_KEYWORDS,
+    extract.doc()
+  },
+  {0} /* Sentinel */
+};
+
+
+/******************************************************************/
+/************ Module Section **************************************/
+/******************************************************************/
+
+static PySequenceMethods PyBobIpBaseLBPFeatureSet_sequence = {
+  (lenfunc)PyBobIpBaseLBPFeatureSet_len
+};
+
+// Define the LBPFeatureSet type struct; will be initialized later
+PyTypeObject PyBobIpBaseLBPFeatureSet_Type = {
+  PyVarObject_HEAD_INIT(0,0)
+  0
+};
+
+bool init_BobIpBaseLBPFeatureSet(PyObject* module)
+{
+  // initialize the type struct
+  PyBobIpBaseLBPFeatureSet_Type.tp_name = LBPFeatureSet_doc.name();
+  PyBobIpBaseLBPFeatureSet_Type.tp_basicsize = sizeof(PyBobIpBaseLBPFeatureSetObject);
+  PyBobIpBaseLBPFeatureSet_Type.tp_flags = Py_TPFLAGS_DEFAULT;
+  PyBobIpBaseLBPFeatureSet_Type.tp_doc = LBPFeatureSet_doc.doc();
+
+  // set the functions
+  PyBobIpBaseLBPFeatureSet_Type.tp_new = PyType_GenericNew;
+  PyBobIpBaseLBPFeatureSet_Type.tp_init = reinterpret_cast<initproc>(PyBobIpBaseLBPFeatureSet_init);
+  PyBobIpBaseLBPFeatureSet_Type.tp_dealloc = reinterpret_cast<destructor>(PyBobIpBaseLBPFeatureSet_delete);
+  PyBobIpBaseLBPFeatureSet_Type.tp_methods = PyBobIpBaseLBPFeatureSet_methods;
+  PyBobIpBaseLBPFeatureSet_Type.tp_getset = PyBobIpBaseLBPFeatureSet_getseters;
+  PyBobIpBaseLBPFeatureSet_Type.tp_as_sequence = &PyBobIpBaseLBPFeatureSet_sequence;
+  PyBobIpBaseLBPFeatureSet_Type.tp_call = reinterpret_cast<ternaryfunc>(PyBobIpBaseLBPFeatureSet_extract);
+
+  // check that everything is fine
+  if (PyType_Ready(&PyBobIpBaseLBPFeatureSet_Type) < 0) return false;
+
+  // add the type to the module
+  Py_INCREF(&PyBobIpBaseLBPFeatureSet_Type);
+  return PyModule_AddObject(module, "LBPFeatureSet", (PyObject*)&PyBobIpBaseLBPFeatureSet_Type) >= 0;
+}
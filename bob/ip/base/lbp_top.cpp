@@ -173,17 +173,26 @@ static auto process = bob::extension::FunctionDoc(
   "1. First dimension: time\n"
   "2. Second dimension: frame height\n"
   "3. Third dimension: frame width\n\n"
-  "The central pixel is the point where the LBP planes intersect/have to be calculated from.",
+  "The central pixel is the point where the LBP planes intersect/have to be calculated from.\n\n"
+  "Each XY frame, XT slice and YT slice is extracted as a whole; the planes are processed by ``n_threads`` threads, and the global interpreter lock is released during the extraction.",
   true
 )
-.add_prototype("input, xy, xt, yt")
+.add_prototype("input, xy, xt, yt, [n_threads]")
 .add_parameter("input", "array_like (3D)", "The input set of gray-scale images for which LBPTop features should be extracted")
 .add_parameter("xy, xt, yt", "array_like (3D, uint16)", "The result of the LBP operator in the XY, XT and YT plane (frame), for the central frame of the input array")
+.add_parameter("n_threads", "int", "[default: 1] The number of threads to use; if 0 or negative, all hardware threads are used")
 ;
 
 template <typename T>
-static PyObject* process_inner(PyBobIpBaseLBPTopObject* self, PyBlitzArrayObject* input, PyBlitzArrayObject* xy, PyBlitzArrayObject* xt, PyBlitzArrayObject* yt){
-  self->cxx->process(*PyBlitzArrayCxx_AsBlitz<T,3>(input), *PyBlitzArrayCxx_AsBlitz<uint16_t,3>(xy), *PyBlitzArrayCxx_AsBlitz<uint16_t,3>(xt), *PyBlitzArrayCxx_AsBlitz<uint16_t,3>(yt));
+static PyObject* process_inner(PyBobIpBaseLBPTopObject* self, PyBlitzArrayObject* input, PyBlitzArrayObject* xy, PyBlitzArrayObject* xt, PyBlitzArrayObject* yt, int n_threads){
+  const blitz::Array<T,3>& src = *PyBlitzArrayCxx_AsBlitz<T,3>(input);
+  blitz::Array<uint16_t,3>& xy_ = *PyBlitzArrayCxx_AsBlitz<uint16_t,3>(xy);
+  blitz::Array<uint16_t,3>& xt_ = *PyBlitzArrayCxx_AsBlitz<uint16_t,3>(xt);
+  blitz::Array<uint16_t,3>& yt_ = *PyBlitzArrayCxx_AsBlitz<uint16_t,3>(yt);
+  {
+    ReleaseGIL gil;
+    self->cxx->process(src, xy_, xt_, yt_, n_threads);
+  }
   Py_RETURN_NONE;
 }
 
@@ -192,7 +201,8 @@ static PyObject* PyBobIpBaseLBPTop_process(PyBobIpBaseLBPTopObject* self, PyObje
   char** kwlist = process.kwlist();
 
   PyBlitzArrayObject* input,* xy,* xt,* yt;
-  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&O&O&O&", kwlist, &PyBlitzArray_Converter, &input, &PyBlitzArray_OutputConverter, &xy, &PyBlitzArray_OutputConverter, &xt, &PyBlitzArray_OutputConverter, &yt)){
+  int n_threads = 1;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&O&O&O&|i", kwlist, &PyBlitzArray_Converter, &input, &PyBlitzArray_OutputConverter, &xy, &PyBlitzArray_OutputConverter, &xt, &PyBlitzArray_OutputConverter, &yt, &n_threads)){
     process.print_usage();
     return 0;
   }
@@ -209,9 +219,9 @@ static PyObject* PyBobIpBaseLBPTop_process(PyBobIpBaseLBPTopObject* self, PyObje
   }
 
   switch (input->type_num){
-    case NPY_UINT8: return process_inner<uint8_t>(self, input, xy, xt, yt);
-    case NPY_UINT16: return process_inner<uint16_t>(self, input, xy, xt, yt);
-    case NPY_FLOAT64: return process_inner<double>(self, input, xy, xt, yt);
+    case NPY_UINT8: return process_inner<uint8_t>(self, input, xy, xt, yt, n_threads);
+    case NPY_UINT16: return process_inner<uint16_t>(self, input, xy, xt, yt, n_threads);
+    case NPY_FLOAT64: return process_inner<double>(self, input, xy, xt, yt, n_threads);
     default:
       process.print_usage();
       PyErr_Format(PyExc_TypeError, "`%s' processes only images of types uint8, uint16 or float, and not from %s", Py_TYPE(self)->tp_name, PyBlitzArray_TypenumAsString(input->type_num));
@@ -221,6 +231,132 @@ static PyObject* PyBobIpBaseLBPTop_process(PyBobIpBaseLBPTopObject* self, PyObje
   BOB_CATCH_MEMBER("cannot process LBPTop", 0)
 }
 
+static auto histogramShape = bob::extension::FunctionDoc(
+  "histogram_shape",
+  "Returns the shape of the block histograms that :py:func:`process_histograms` computes",
+  0,
+  true
+)
+.add_prototype("input, block_size, [block_overlap]", "shape")
+.add_prototype("shape, block_size, [block_overlap]", "shape")
+.add_parameter("input", "array_like (3D)", "The input set of gray-scale images for which LBPTop histograms should be computed")
+.add_parameter("shape", "(int, int, int)", "The shape of the input set of images")
+.add_parameter("block_size", "(int, int, int)", "The ``(time, height, width)`` size of the blocks")
+.add_parameter("block_overlap", "(int, int, int)", "[default: ``(0, 0, 0)``] The ``(time, height, width)`` overlap of the blocks")
+.add_return("shape", "(int, int)", "The shape ``(#blocks, xy.max_label + xt.max_label + yt.max_label)`` of the histograms")
+;
+
+static PyObject* PyBobIpBaseLBPTop_histogramShape(PyBobIpBaseLBPTopObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+  char** kwlist1 = histogramShape.kwlist(0);
+  char** kwlist2 = histogramShape.kwlist(1);
+
+  blitz::TinyVector<int,3> shape, size, overlap(0,0,0);
+  PyObject* k = Py_BuildValue("s", kwlist2[0]);
+  auto k_ = make_safe(k);
+  if (
+    (kwargs && PyDict_Contains(kwargs, k)) ||
+    (args && PyTuple_Size(args) && (PyTuple_Check(PyTuple_GetItem(args, 0)) || PyList_Check(PyTuple_GetItem(args, 0))))
+  ){
+    // by shape
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "(iii)(iii)|(iii)", kwlist2, &shape[0], &shape[1], &shape[2], &size[0], &size[1], &size[2], &overlap[0], &overlap[1], &overlap[2])){
+      histogramShape.print_usage();
+      return 0;
+    }
+  } else {
+    // by input
+    PyBlitzArrayObject* input;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&(iii)|(iii)", kwlist1, &PyBlitzArray_Converter, &input, &size[0], &size[1], &size[2], &overlap[0], &overlap[1], &overlap[2])){
+      histogramShape.print_usage();
+      return 0;
+    }
+    auto input_ = make_safe(input);
+    if (input->ndim != 3){
+      PyErr_Format(PyExc_TypeError, "`%s' only processes 3D arrays", Py_TYPE(self)->tp_name);
+      return 0;
+    }
+    shape = blitz::TinyVector<int,3>(input->shape[0], input->shape[1], input->shape[2]);
+  }
+  auto r = self->cxx->getHistogramShape(shape, size, overlap);
+  return Py_BuildValue("(ii)", r[0], r[1]);
+
+  BOB_CATCH_MEMBER("cannot compute histogram shape", 0)
+}
+
+static auto processHistograms = bob::extension::FunctionDoc(
+  "process_histograms",
+  "This function computes the LBP-TOP histograms of spatio-temporal blocks of the given set of images",
+  "The LBP codes are extracted in the same way as in :py:func:`process`, but the three code volumes are not stored. "
+  "Instead, each XY, XT and YT code is directly added to the histograms of all ``(time, height, width)`` blocks of the code volume that contain it, where blocks are defined by their size and overlap similarly to :py:func:`bob.ip.base.lbphs`. "
+  "Each row of the output contains the concatenated XY, XT and YT histograms of one block, where the blocks are ordered by time, height and width.\n\n"
+  "The planes are processed by ``n_threads`` threads, and the global interpreter lock is released during the computation.",
+  true
+)
+.add_prototype("input, block_size, [block_overlap], [output], [n_threads]", "output")
+.add_parameter("input", "array_like (3D)", "The input set of gray-scale images for which LBPTop histograms should be computed")
+.add_parameter("block_size", "(int, int, int)", "The ``(time, height, width)`` size of the blocks")
+.add_parameter("block_overlap", "(int, int, int)", "[default: ``(0, 0, 0)``] The ``(time, height, width)`` overlap of the blocks")
+.add_parameter("output", "array_like (2D, uint64)", "[default: ``None``] If given, the output histograms, which need to be of shape :py:func:`histogram_shape`")
+.add_parameter("n_threads", "int", "[default: 1] The number of threads to use; if 0 or negative, all hardware threads are used")
+.add_return("output", "array_like (2D, uint64)", "The concatenated XY, XT and YT histograms of all blocks")
+;
+
+template <typename T>
+static void process_histograms_inner(PyBobIpBaseLBPTopObject* self, PyBlitzArrayObject* input, const blitz::TinyVector<int,3>& size, const blitz::TinyVector<int,3>& overlap, PyBlitzArrayObject* output, int n_threads){
+  const blitz::Array<T,3>& src = *PyBlitzArrayCxx_AsBlitz<T,3>(input);
+  blitz::Array<uint64_t,2>& dst = *PyBlitzArrayCxx_AsBlitz<uint64_t,2>(output);
+  ReleaseGIL gil;
+  self->cxx->processHistograms(src, size, overlap, dst, n_threads);
+}
+
+static PyObject* PyBobIpBaseLBPTop_processHistograms(PyBobIpBaseLBPTopObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+  char** kwlist = processHistograms.kwlist();
+
+  PyBlitzArrayObject* input,* output = 0;
+  blitz::TinyVector<int,3> size, overlap(0,0,0);
+  int n_threads = 1;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&(iii)|(iii)O&i", kwlist, &PyBlitzArray_Converter, &input, &size[0], &size[1], &size[2], &overlap[0], &overlap[1], &overlap[2], &PyBlitzArray_OutputConverter, &output, &n_threads)){
+    processHistograms.print_usage();
+    return 0;
+  }
+  auto input_ = make_safe(input), output_ = make_xsafe(output);
+
+  if (input->ndim != 3){
+    PyErr_Format(PyExc_TypeError, "`%s' only processes 3D arrays", Py_TYPE(self)->tp_name);
+    return 0;
+  }
+  auto shape = self->cxx->getHistogramShape(blitz::TinyVector<int,3>(input->shape[0], input->shape[1], input->shape[2]), size, overlap);
+  if (output){
+    if (output->ndim != 2 || output->type_num != NPY_UINT64){
+      PyErr_Format(PyExc_TypeError, "`%s' only computes histograms into 2D arrays of type uint64", Py_TYPE(self)->tp_name);
+      return 0;
+    }
+    if (output->shape[0] != shape[0] || output->shape[1] != shape[1]){
+      PyErr_Format(PyExc_TypeError, "`%s' requires the shape of the output to be (%d, %d), but it is (%" PY_FORMAT_SIZE_T "d, %" PY_FORMAT_SIZE_T "d)", Py_TYPE(self)->tp_name, shape[0], shape[1], output->shape[0], output->shape[1]);
+      return 0;
+    }
+  } else {
+    Py_ssize_t osize[] = {shape[0], shape[1]};
+    output = (PyBlitzArrayObject*)PyBlitzArray_SimpleNew(NPY_UINT64, 2, osize);
+    output_ = make_safe(output);
+  }
+
+  switch (input->type_num){
+    case NPY_UINT8: process_histograms_inner<uint8_t>(self, input, size, overlap, output, n_threads); break;
+    case NPY_UINT16: process_histograms_inner<uint16_t>(self, input, size, overlap, output, n_threads); break;
+    case NPY_FLOAT64: process_histograms_inner<double>(self, input, size, overlap, output, n_threads); break;
+    default:
+      processHistograms.print_usage();
+      PyErr_Format(PyExc_TypeError, "`%s' processes only images of types uint8, uint16 or float, and not from %s", Py_TYPE(self)->tp_name, PyBlitzArray_TypenumAsString(input->type_num));
+      return 0;
+  }
+
+  return PyBlitzArray_AsNumpyArray(output, 0);
+
+  BOB_CATCH_MEMBER("cannot process LBPTop histograms", 0)
+}
+
 static PyMethodDef PyBobIpBaseLBPTop_methods[] = {
   {
     process.name(),
@@ -228,6 +364,18 @@ static PyMethodDef PyBobIpBaseLBPTop_methods[] = {
     METH_VARARGS|METH_KEYWORDS,
     process.doc()
   },
+  {
+    histogramShape.name(),
+    (PyCFunction)PyBobIpBaseLBPTop_histogramShape,
+    METH_VARARGS|METH_KEYWORDS,
+    histogramShape.doc()
+  },
+  {
+    processHistograms.name(),
+    (PyCFunction)PyBobIpBaseLBPTop_processHistograms,
+    METH_VARARGS|METH_KEYWORDS,
+    processHistograms.doc()
+  },
   {0} /* Sentinel */
 };
 
@@ -0,0 +1,447 @@
+/**
+ * @date Sun Oct 18 10:07:44 CEST 2026
+ *
+ * @brief Binds the LBPTopStream class to python
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include "main.h"
+
+/******************************************************************/
+/************ Constructor Section *********************************/
+/******************************************************************/
+
+static auto LBPTopStream_doc = bob::extension::ClassDoc(
+  BOB_EXT_MODULE_PREFIX ".LBPTopStream",
+  "Extracts LBP-TOP codes from a video that is given frame by frame",
+  "The frames of a video, e.g., from a camera, are pushed one by one. "
+  "The last ``2 * temporal_radius + 1`` frames are kept in a ring buffer, where the :py:attr:`temporal_radius` is the radius of the :py:class:`LBPTop` in T direction. "
+  "When enough frames have been pushed, each push extracts the XY, XT and YT codes of the central frame of the buffer, i.e., of the frame that was pushed :py:attr:`temporal_radius` frames before. "
+  "These codes are identical to the codes that :py:meth:`LBPTop.process` extracts for this frame from the whole video. "
+  "Hence, memory and latency are bounded by the temporal radius, and not by the length of the video.\n\n"
+  "Instead of the codes, the concatenated XY, XT and YT histograms of the blocks of the central frame can be extracted, see :py:func:`push_histograms`."
+).add_constructor(
+  bob::extension::FunctionDoc(
+    "__init__",
+    "Creates a stream for frames of the given shape",
+    "The :py:class:`LBPTop` is shared with this object.",
+    true
+  )
+  .add_prototype("lbp_top, frame_shape", "")
+  .add_parameter("lbp_top", ":py:class:`bob.ip.base.LBPTop`", "The LBP-TOP configuration")
+  .add_parameter("frame_shape", "(int, int)", "The shape ``(height, width)`` of the frames that will be pushed")
+);
+
+
+static int PyBobIpBaseLBPTopStream_init(PyBobIpBaseLBPTopStreamObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  char** kwlist = LBPTopStream_doc.kwlist();
+
+  PyBobIpBaseLBPTopObject* lbp_top;
+  blitz::TinyVector<int,2> shape;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!(ii)", kwlist, &PyBobIpBaseLBPTop_Type, &lbp_top, &shape[0], &shape[1])){
+    LBPTopStream_doc.print_usage();
+    return -1;
+  }
+  self->cxx.reset(new bob::ip::base::LBPTopStream(lbp_top->cxx, shape));
+  return 0;
+
+  BOB_CATCH_MEMBER("cannot create LBPTopStream", -1)
+}
+
+static void PyBobIpBaseLBPTopStream_delete(PyBobIpBaseLBPTopStreamObject* self) {
+  self->cxx.reset();
+  Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+int PyBobIpBaseLBPTopStream_Check(PyObject* o) {
+  return PyObject_IsInstance(o, reinterpret_cast<PyObject*>(&PyBobIpBaseLBPTopStream_Type));
+}
+
+
+/******************************************************************/
+/************ Variables Section ***********************************/
+/******************************************************************/
+
+static auto lbpTop = bob::extension::VariableDoc(
+  "lbp_top",
+  ":py:class:`bob.ip.base.LBPTop`",
+  "The LBP-TOP configuration, which is shared with this object, read access only"
+);
+PyObject* PyBobIpBaseLBPTopStream_getLBPTop(PyBobIpBaseLBPTopStreamObject* self, void*){
+  BOB_TRY
+  PyBobIpBaseLBPTopObject* lbp_top = (PyBobIpBaseLBPTopObject*)PyBobIpBaseLBPTop_Type.tp_alloc(&PyBobIpBaseLBPTop_Type, 0);
+  if (!lbp_top) return 0;
+  lbp_top->cxx = self->cxx->getLBPTop();
+  return Py_BuildValue("N", lbp_top);
+  BOB_CATCH_MEMBER("lbp_top could not be read", 0)
+}
+
+static auto frameShape = bob::extension::VariableDoc(
+  "frame_shape",
+  "(int, int)",
+  "The shape of the frames that can be pushed, read access only"
+);
+PyObject* PyBobIpBaseLBPTopStream_getFrameShape(PyBobIpBaseLBPTopStreamObject* self, void*){
+  BOB_TRY
+  auto r = self->cxx->getFrameShape();
+  return Py_BuildValue("(ii)", r[0], r[1]);
+  BOB_CATCH_MEMBER("frame_shape could not be read", 0)
+}
+
+static auto outputShape = bob::extension::VariableDoc(
+  "output_shape",
+  "(int, int)",
+  "The shape of the XY, XT and YT code images of one frame, read access only"
+);
+PyObject* PyBobIpBaseLBPTopStream_getOutputShape(PyBobIpBaseLBPTopStreamObject* self, void*){
+  BOB_TRY
+  auto r = self->cxx->getOutputShape();
+  return Py_BuildValue("(ii)", r[0], r[1]);
+  BOB_CATCH_MEMBER("output_shape could not be read", 0)
+}
+
+static auto temporalRadius = bob::extension::VariableDoc(
+  "temporal_radius",
+  "int",
+  "The radius of the LBP-TOP in T direction, i.e., the delay between the pushed frame and the frame whose codes are extracted, read access only"
+);
+PyObject* PyBobIpBaseLBPTopStream_getTemporalRadius(PyBobIpBaseLBPTopStreamObject* self, void*){
+  BOB_TRY
+  return Py_BuildValue("i", self->cxx->getTemporalRadius());
+  BOB_CATCH_MEMBER("temporal_radius could not be read", 0)
+}
+
+static auto numberOfFrames = bob::extension::VariableDoc(
+  "number_of_frames",
+  "int",
+  "The number of frames that have been pushed since the creation or the last :py:func:`reset`, read access only"
+);
+PyObject* PyBobIpBaseLBPTopStream_getNumberOfFrames(PyBobIpBaseLBPTopStreamObject* self, void*){
+  BOB_TRY
+  return Py_BuildValue("i", self->cxx->getNumberOfFrames());
+  BOB_CATCH_MEMBER("number_of_frames could not be read", 0)
+}
+
+static auto isReady = bob::extension::VariableDoc(
+  "is_ready",
+  "bool",
+  "Have enough frames been pushed to extract the codes of the central frame? Read access only"
+);
+PyObject* PyBobIpBaseLBPTopStream_getIsReady(PyBobIpBaseLBPTopStreamObject* self, void*){
+  BOB_TRY
+  if (self->cxx->isReady()) Py_RETURN_TRUE;
+  Py_RETURN_FALSE;
+  BOB_CATCH_MEMBER("is_ready could not be read", 0)
+}
+
+static PyGetSetDef PyBobIpBaseLBPTopStream_getseters[] = {
+    {
+      lbpTop.name(),
+      (getter)PyBobIpBaseLBPTopStream_getLBPTop,
+      0,
+      lbpTop.doc(),
+      0
+    },
+    {
+      frameShape.name(),
+      (getter)PyBobIpBaseLBPTopStream_getFrameShape,
+      0,
+      frameShape.doc(),
+      0
+    },
+    {
+      outputShape.name(),
+      (getter)PyBobIpBaseLBPTopStream_getOutputShape,
+      0,
+      outputShape.doc(),
+      0
+    },
+    {
+      temporalRadius.name(),
+      (getter)PyBobIpBaseLBPTopStream_getTemporalRadius,
+      0,
+      temporalRadius.doc(),
+      0
+    },
+    {
+      numberOfFrames.name(),
+      (getter)PyBobIpBaseLBPTopStream_getNumberOfFrames,
+      0,
+      numberOfFrames.doc(),
+      0
+    },
+    {
+      isReady.name(),
+      (getter)PyBobIpBaseLBPTopStream_getIsReady,
+      0,
+      isReady.doc(),
+      0
+    },
+    {0}  /* Sentinel */
+};
+
+
+/******************************************************************/
+/************ Functions Section ***********************************/
+/******************************************************************/
+
+static auto histogramShape = bob::extension::FunctionDoc(
+  "histogram_shape",
+  "Returns the shape of the block histograms that :py:func:`push_histograms` extracts",
+  0,
+  true
+)
+.add_prototype("block_size, [block_overlap]", "shape")
+.add_parameter("block_size", "(int, int)", "The size of the blocks in which the code images are split")
+.add_parameter("block_overlap", "(int, int)", "[default: ``(0, 0)``] The overlap of the blocks")
+.add_return("shape", "(int, int)", "The shape ``(#blocks, xy.max_label + xt.max_label + yt.max_label)`` of the histograms")
+;
+
+static PyObject* PyBobIpBaseLBPTopStream_histogramShape(PyBobIpBaseLBPTopStreamObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+  char** kwlist = histogramShape.kwlist();
+
+  blitz::TinyVector<int,2> size, overlap(0,0);
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "(ii)|(ii)", kwlist, &size[0], &size[1], &overlap[0], &overlap[1])){
+    histogramShape.print_usage();
+    return 0;
+  }
+  auto shape = self->cxx->getHistogramShape(size, overlap);
+  return Py_BuildValue("(ii)", shape[0], shape[1]);
+
+  BOB_CATCH_MEMBER("cannot compute histogram shape", 0)
+}
+
+/** Checks the given frame and returns false, if it cannot be pushed */
+static bool _checkFrame(PyBobIpBaseLBPTopStreamObject* self, PyBlitzArrayObject* frame){
+  if (frame->ndim != 2){
+    PyErr_Format(PyExc_TypeError, "`%s' only pushes 2D frames", Py_TYPE(self)->tp_name);
+    return false;
+  }
+  if (frame->type_num != NPY_UINT8 && frame->type_num != NPY_UINT16 && frame->type_num != NPY_FLOAT64){
+    PyErr_Format(PyExc_TypeError, "`%s' pushes only frames of types uint8, uint16 or float, and not of %s", Py_TYPE(self)->tp_name, PyBlitzArray_TypenumAsString(frame->type_num));
+    return false;
+  }
+  return true;
+}
+
+/** Checks the given output array, or creates a new one when not given */
+static bool _checkOutput(PyBobIpBaseLBPTopStreamObject* self, PyBlitzArrayObject*& output, boost::shared_ptr<PyBlitzArrayObject>& output_, int type_num, const blitz::TinyVector<int,2>& shape){
+  if (output){
+    if (output->ndim != 2 || output->type_num != type_num){
+      PyErr_Format(PyExc_TypeError, "`%s' only extracts to 2D arrays of type %s", Py_TYPE(self)->tp_name, PyBlitzArray_TypenumAsString(type_num));
+      return false;
+    }
+    if (output->shape[0] != shape[0] || output->shape[1] != shape[1]){
+      PyErr_Format(PyExc_TypeError, "`%s' requires the shape of the output to be (%d, %d), but it is (%" PY_FORMAT_SIZE_T "d, %" PY_FORMAT_SIZE_T "d)", Py_TYPE(self)->tp_name, shape[0], shape[1], output->shape[0], output->shape[1]);
+      return false;
+    }
+  } else {
+    Py_ssize_t osize[] = {shape[0], shape[1]};
+    output = (PyBlitzArrayObject*)PyBlitzArray_SimpleNew(type_num, 2, osize);
+    if (!output) return false;
+    output_ = make_safe(output);
+  }
+  return true;
+}
+
+static auto push = bob::extension::FunctionDoc(
+  "push",
+  "Pushes the next frame and extracts the XY, XT and YT codes of the central frame",
+  "When less than ``2 * temporal_radius + 1`` frames have been pushed (see :py:attr:`is_ready`), no codes are extracted, and ``None`` is returned. "
+  "The XY frame, the XT slices and the YT slices are processed by ``n_threads`` threads, and the global interpreter lock is released during the extraction; concurrent pushes to the same stream are serialized.\n\n"
+  ".. note::\n\n  The :py:func:`__call__` function is an alias for this method.",
+  true
+)
+.add_prototype("frame, [xy], [xt], [yt], [n_threads]", "codes")
+.add_parameter("frame", "array_like (2D)", "The next frame of the video, of shape :py:attr:`frame_shape`")
+.add_parameter("xy, xt, yt", "array_like (2D, uint16)", "[default: ``None``] If given, the output code images, which need to be of shape :py:attr:`output_shape`")
+.add_parameter("n_threads", "int", "[default: 1] The number of threads to use; if 0 or negative, all hardware threads are used")
+.add_return("codes", "(array_like (2D, uint16), array_like (2D, uint16), array_like (2D, uint16)) or None", "The XY, XT and YT codes of the central frame, or ``None``")
+;
+
+template <typename T>
+static bool push_inner(PyBobIpBaseLBPTopStreamObject* self, PyBlitzArrayObject* frame, PyBlitzArrayObject* xy, PyBlitzArrayObject* xt, PyBlitzArrayObject* yt, int n_threads){
+  const blitz::Array<T,2>& src = *PyBlitzArrayCxx_AsBlitz<T,2>(frame);
+  blitz::Array<uint16_t,2>& xy_ = *PyBlitzArrayCxx_AsBlitz<uint16_t,2>(xy);
+  blitz::Array<uint16_t,2>& xt_ = *PyBlitzArrayCxx_AsBlitz<uint16_t,2>(xt);
+  blitz::Array<uint16_t,2>& yt_ = *PyBlitzArrayCxx_AsBlitz<uint16_t,2>(yt);
+  ReleaseGIL gil;
+  return self->cxx->push(src, xy_, xt_, yt_, n_threads);
+}
+
+static PyObject* PyBobIpBaseLBPTopStream_push(PyBobIpBaseLBPTopStreamObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+  char** kwlist = push.kwlist();
+
+  PyBlitzArrayObject* frame,* xy = 0,* xt = 0,* yt = 0;
+  int n_threads = 1;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&|O&O&O&i", kwlist, &PyBlitzArray_Converter, &frame, &PyBlitzArray_OutputConverter, &xy, &PyBlitzArray_OutputConverter, &xt, &PyBlitzArray_OutputConverter, &yt, &n_threads)){
+    push.print_usage();
+    return 0;
+  }
+  auto frame_ = make_safe(frame);
+  auto xy_ = make_xsafe(xy), xt_ = make_xsafe(xt), yt_ = make_xsafe(yt);
+
+  auto shape = self->cxx->getOutputShape();
+  if (!_checkFrame(self, frame) || !_checkOutput(self, xy, xy_, NPY_UINT16, shape) || !_checkOutput(self, xt, xt_, NPY_UINT16, shape) || !_checkOutput(self, yt, yt_, NPY_UINT16, shape)){
+    push.print_usage();
+    return 0;
+  }
+
+  bool ready;
+  switch (frame->type_num){
+    case NPY_UINT8: ready = push_inner<uint8_t>(self, frame, xy, xt, yt, n_threads); break;
+    case NPY_UINT16: ready = push_inner<uint16_t>(self, frame, xy, xt, yt, n_threads); break;
+    default: ready = push_inner<double>(self, frame, xy, xt, yt, n_threads);
+  }
+  if (!ready) Py_RETURN_NONE;
+
+  return Py_BuildValue("(NNN)", PyBlitzArray_AsNumpyArray(xy, 0), PyBlitzArray_AsNumpyArray(xt, 0), PyBlitzArray_AsNumpyArray(yt, 0));
+
+  BOB_CATCH_MEMBER("cannot push frame", 0)
+}
+
+static auto pushHistograms = bob::extension::FunctionDoc(
+  "push_histograms",
+  "Pushes the next frame and extracts the XY, XT and YT block histograms of the central frame",
+  "The XY, XT and YT code images of the central frame are split into blocks of the given size and overlap, in the same way as :py:func:`bob.ip.base.lbphs` does. "
+  "Each row of the output contains the concatenated XY, XT and YT histograms of one block. "
+  "When less than ``2 * temporal_radius + 1`` frames have been pushed (see :py:attr:`is_ready`), no histograms are extracted, and ``None`` is returned.",
+  true
+)
+.add_prototype("frame, block_size, [block_overlap], [output], [n_threads]", "histograms")
+.add_parameter("frame", "array_like (2D)", "The next frame of the video, of shape :py:attr:`frame_shape`")
+.add_parameter("block_size", "(int, int)", "The size of the blocks in which the code images are split")
+.add_parameter("block_overlap", "(int, int)", "[default: ``(0, 0)``] The overlap of the blocks")
+.add_parameter("output", "array_like (2D, uint64)", "[default: ``None``] If given, the output histograms, which need to be of shape :py:func:`histogram_shape`")
+.add_parameter("n_threads", "int", "[default: 1] The number of threads to use; if 0 or negative, all hardware threads are used")
+.add_return("histograms", "array_like (2D, uint64) or None", "The block histograms of the central frame, or ``None``")
+;
+
+template <typename T>
+static bool push_histograms_inner(PyBobIpBaseLBPTopStreamObject* self, PyBlitzArrayObject* frame, const blitz::TinyVector<int,2>& size, const blitz::TinyVector<int,2>& overlap, PyBlitzArrayObject* output, int n_threads){
+  const blitz::Array<T,2>& src = *PyBlitzArrayCxx_AsBlitz<T,2>(frame);
+  blitz::Array<uint64_t,2>& dst = *PyBlitzArrayCxx_AsBlitz<uint64_t,2>(output);
+  ReleaseGIL gil;
+  return self->cxx->push(src, size, overlap, dst, n_threads);
+}
+
+static PyObject* PyBobIpBaseLBPTopStream_pushHistograms(PyBobIpBaseLBPTopStreamObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+  char** kwlist = pushHistograms.kwlist();
+
+  PyBlitzArrayObject* frame,* output = 0;
+  blitz::TinyVector<int,2> size, overlap(0,0);
+  int n_threads = 1;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&(ii)|(ii)O&i", kwlist, &PyBlitzArray_Converter, &frame, &size[0], &size[1], &overlap[0], &overlap[1], &PyBlitzArray_OutputConverter, &output, &n_threads)){
+    pushHistograms.print_usage();
+    return 0;
+  }
+  auto frame_ = make_safe(frame);
+  auto output_ = make_xsafe(output);
+
+  auto shape = self->cxx->getHistogramShape(size, overlap);
+  if (!_checkFrame(self, frame) || !_checkOutput(self, output, output_, NPY_UINT64, shape)){
+    pushHistograms.print_usage();
+    return 0;
+  }
+
+  bool ready;
+  switch (frame->type_num){
+    case NPY_UINT8: ready = push_histograms_inner<uint8_t>(self, frame, size, overlap, output, n_threads); break;
+    case NPY_UINT16: ready = push_histograms_inner<uint16_t>(self, frame, size, overlap, output, n_threads); break;
+    default: ready = push_histograms_inner<double>(self, frame, size, overlap, output, n_threads);
+  }
+  if (!ready) Py_RETURN_NONE;
+
+  return PyBlitzArray_AsNumpyArray(output, 0);
+
+  BOB_CATCH_MEMBER("cannot push frame", 0)
+}
+
+static auto reset = bob::extension::FunctionDoc(
+  "reset",
+  "Removes all buffered frames, e.g., to start a new video",
+  0,
+  true
+)
+.add_prototype("")
+;
+
+static PyObject* PyBobIpBaseLBPTopStream_reset(PyBobIpBaseLBPTopStreamObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+  char** kwlist = reset.kwlist();
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "", kwlist)) return 0;
+
+  self->cxx->reset();
+  Py_RETURN_NONE;
+
+  BOB_CATCH_MEMBER("cannot reset stream", 0)
+}
+
+static PyMethodDef PyBobIpBaseLBPTopStream_methods[] = {
+  {
+    histogramShape.name(),
+    (PyCFunction)PyBobIpBaseLBPTopStream_histogramShape,
+    METH_VARARGS|METH_KEYWORDS,
+    histogramShape.doc()
+  },
+  {
+    push.name(),
+    (PyCFunction)PyBobIpBaseLBPTopStream_push,
+    METH_VARARGS|METH_KEYWORDS,
+    push.doc()
+  },
+  {
+    pushHistograms.name(),
+    (PyCFunction)PyBobIpBaseLBPTopStream_pushHistograms,
+    METH_VARARGS|METH_KEYWORDS,
+    pushHistograms.doc()
+  },
+  {
+    reset.name(),
+    (PyCFunction)PyBobIpBaseLBPTopStream_reset,
+    METH_VARARGS|METH_KEYWORDS,
+    reset.doc()
+  },
+  {0} /* Sentinel */
+};
+
+
+/******************************************************************/
+/************ Module Section **************************************/
+/******************************************************************/
+
+// Define the LBPTopStream type struct; will be initialized later
+PyTypeObject PyBobIpBaseLBPTopStream_Type = {
+  PyVarObject_HEAD_INIT(0,0)
+  0
+};
+
+bool init_BobIpBaseLBPTopStream(PyObject* module)
+{
+  // initialize the type struct
+  PyBobIpBaseLBPTopStream_Type.tp_name = LBPTopStream_doc.name();
+  PyBobIpBaseLBPTopStream_Type.tp_basicsize = sizeof(PyBobIpBaseLBPTopStreamObject);
+  PyBobIpBaseLBPTopStream_Type.tp_flags = Py_TPFLAGS_DEFAULT;
+  PyBobIpBaseLBPTopStream_Type.tp_doc = LBPTopStream_doc.doc();
+
+  // set the functions
+  PyBobIpBaseLBPTopStream_Type.tp_new = PyType_GenericNew;
+  PyBobIpBaseLBPTopStream_Type.tp_init = reinterpret_cast<initproc>(PyBobIpBaseLBPTopStream_init);
+  PyBobIpBaseLBPTopStream_Type.tp_dealloc = reinterpret_cast<destructor>(PyBobIpBaseLBPTopStream_delete);
+  PyBobIpBaseLBPTopStream_Type.tp_methods = PyBobIpBaseLBPTopStream_methods;
+  PyBobIpBaseLBPTopStream_Type.tp_getset = PyBobIpBaseLBPTopStream_getseters;
+  PyBobIpBaseLBPTopStream_Type.tp_call = reinterpret_cast<ternaryfunc>(PyBobIpBaseLBPTopStream_push);
+
+  // check that everything is fine
+  if (PyType_Ready(&PyBobIpBaseLBPTopStream_Type) < 0) return false;
+
+  // add the type to the module
+  Py_INCREF(&PyBobIpBaseLBPTopStream_Type);
+  return PyModule_AddObject(module, "LBPTopStream", (PyObject*)&PyBobIpBaseLBPTopStream_Type) >= 0;
+}
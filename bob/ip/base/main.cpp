@@ -148,8 +148,14 @@ static PyObject* create_module (void) {
   if (PyModule_AddStringConstant(module, "__version__", BOB_EXT_MODULE_VERSION) < 0) return 0;
   if (!init_BobIpBaseGeomNorm(module)) return 0;
   if (!init_BobIpBaseFaceEyesNorm(module)) return 0;
+  if (!init_BobIpBaseRemap(module)) return 0;
+  if (!init_BobIpBasePreparedImage(module)) return 0;
   if (!init_BobIpBaseLBP(module)) return 0;
+  if (!init_BobIpBaseMultiScaleLBP(module)) return 0;
+  if (!init_BobIpBaseLBPFeatureSet(module)) return 0;
   if (!init_BobIpBaseLBPTop(module)) return 0;
+  if (!init_BobIpBaseLBPTopStream(module)) return 0;
+  if (!init_BobIpBaseHistogramScorer(module)) return 0;
   if (!init_BobIpBaseDCTFeatures(module)) return 0;
   if (!init_BobIpBaseTanTriggs(module)) return 0;
   if (!init_BobIpBaseGaussian(module)) return 0;
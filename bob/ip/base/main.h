@@ -20,6 +20,7 @@
 #include <bob.ip.base/api.h>
 
 #include <bob.ip.base/LBPTop.h>
+#include <bob.ip.base/LBPTopStream.h>
 #include <bob.ip.base/DCTFeatures.h>
 #include <bob.ip.base/TanTriggs.h>
 #include <bob.ip.base/Gaussian.h>
@@ -31,6 +32,11 @@
 #include <bob.ip.base/HOG.h>
 #include <bob.ip.base/GeomNorm.h>
 #include <bob.ip.base/FaceEyesNorm.h>
+#include <bob.ip.base/Remap.h>
+#include <bob.ip.base/PreparedImage.h>
+#include <bob.ip.base/MultiScaleLBP.h>
+#include <bob.ip.base/LBPFeatureSet.h>
+#include <bob.ip.base/HistogramScorer.h>
 #include <bob.ip.base/GLCM.h>
 #include <bob.ip.base/Wiener.h>
 
@@ -42,6 +48,19 @@ static inline int insert_item_string(PyObject* dict, PyObject* entries, const ch
   return PyDict_SetItemString(entries, key, v.get());
 }
 
+/// releases the global interpreter lock for the lifetime of this object,
+/// e.g., while running multi-threaded C++ code; the lock is re-acquired
+/// even if the C++ code throws an exception
+class ReleaseGIL {
+  public:
+    ReleaseGIL() : m_state(PyEval_SaveThread()) {}
+    ~ReleaseGIL() { PyEval_RestoreThread(m_state); }
+  private:
+    ReleaseGIL(const ReleaseGIL&);
+    ReleaseGIL& operator=(const ReleaseGIL&);
+    PyThreadState* m_state;
+};
+
 
 // GeomNorm
 typedef struct {
@@ -63,6 +82,16 @@ extern PyTypeObject PyBobIpBaseFaceEyesNorm_Type;
 bool init_BobIpBaseFaceEyesNorm(PyObject* module);
 int PyBobIpBaseFaceEyesNorm_Check(PyObject* o);
 
+// Remap
+typedef struct {
+  PyObject_HEAD
+  boost::shared_ptr<bob::ip::base::Remap> cxx;
+} PyBobIpBaseRemapObject;
+
+extern PyTypeObject PyBobIpBaseRemap_Type;
+bool init_BobIpBaseRemap(PyObject* module);
+int PyBobIpBaseRemap_Check(PyObject* o);
+
 // .. scaling
 PyObject* PyBobIpBase_scale(PyObject*, PyObject*, PyObject*);
 extern bob::extension::FunctionDoc s_scale;
@@ -81,10 +110,42 @@ PyObject* PyBobIpBase_extrapolateMask(PyObject*, PyObject*, PyObject*);
 extern bob::extension::FunctionDoc s_extrapolateMask;
 
 
+// PreparedImage
+typedef struct {
+  PyObject_HEAD
+  boost::shared_ptr<bob::ip::base::PreparedImage> cxx;
+} PyBobIpBasePreparedImageObject;
+
+extern PyTypeObject PyBobIpBasePreparedImage_Type;
+bool init_BobIpBasePreparedImage(PyObject* module);
+int PyBobIpBasePreparedImage_Check(PyObject* o);
+
 // LBP
 bool init_BobIpBaseLBP(PyObject* module);
 
 
+// MultiScaleLBP
+typedef struct {
+  PyObject_HEAD
+  boost::shared_ptr<bob::ip::base::MultiScaleLBP> cxx;
+} PyBobIpBaseMultiScaleLBPObject;
+
+extern PyTypeObject PyBobIpBaseMultiScaleLBP_Type;
+bool init_BobIpBaseMultiScaleLBP(PyObject* module);
+int PyBobIpBaseMultiScaleLBP_Check(PyObject* o);
+
+
+// LBPFeatureSet
+typedef struct {
+  PyObject_HEAD
+  boost::shared_ptr<bob::ip::base::LBPFeatureSet> cxx;
+} PyBobIpBaseLBPFeatureSetObject;
+
+extern PyTypeObject PyBobIpBaseLBPFeatureSet_Type;
+bool init_BobIpBaseLBPFeatureSet(PyObject* module);
+int PyBobIpBaseLBPFeatureSet_Check(PyObject* o);
+
+
 // LBP-Top
 typedef struct {
   PyObject_HEAD
@@ -96,6 +157,28 @@ bool init_BobIpBaseLBPTop(PyObject* module);
 int PyBobIpBaseLBPTop_Check(PyObject* o);
 
 
+// LBP-Top stream
+typedef struct {
+  PyObject_HEAD
+  boost::shared_ptr<bob::ip::base::LBPTopStream> cxx;
+} PyBobIpBaseLBPTopStreamObject;
+
+extern PyTypeObject PyBobIpBaseLBPTopStream_Type;
+bool init_BobIpBaseLBPTopStream(PyObject* module);
+int PyBobIpBaseLBPTopStream_Check(PyObject* o);
+
+
+// HistogramScorer
+typedef struct {
+  PyObject_HEAD
+  boost::shared_ptr<bob::ip::base::HistogramScorer> cxx;
+} PyBobIpBaseHistogramScorerObject;
+
+extern PyTypeObject PyBobIpBaseHistogramScorer_Type;
+bool init_BobIpBaseHistogramScorer(PyObject* module);
+int PyBobIpBaseHistogramScorer_Check(PyObject* o);
+
+
 // DCTFeatures
 typedef struct {
   PyObject_HEAD
@@ -0,0 +1,400 @@
+/**
+ * @date Sat Oct 17 14:42:19 CEST 2026
+ *
+ * @brief Binds the MultiScaleLBP class to python
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include "main.h"
+
+static inline bool f(PyObject* o){return o != 0 && PyObject_IsTrue(o) > 0;}  /* converts PyObject to bool and returns false if object is NULL */
+
+/** Converts the given sequence of pairs of integers */
+static bool _pairs(PyObject* o, std::vector<blitz::TinyVector<int,2> >& pairs){
+  PyObject* seq = PySequence_Fast(o, "expected a sequence of (int, int) pairs");
+  if (!seq) return false;
+  auto seq_ = make_safe(seq);
+  for (Py_ssize_t i = 0; i < PySequence_Fast_GET_SIZE(seq); ++i){
+    blitz::TinyVector<int,2> pair;
+    if (!PyArg_Parse(PySequence_Fast_GET_ITEM(seq, i), "(ii)", &pair[0], &pair[1])) return false;
+    pairs.push_back(pair);
+  }
+  return true;
+}
+
+/******************************************************************/
+/************ Constructor Section *********************************/
+/******************************************************************/
+
+static auto MultiScaleLBP_doc = bob::extension::ClassDoc(
+  BOB_EXT_MODULE_PREFIX ".MultiScaleLBP",
+  "Extracts the codes of several multi-block LBP's from the same integral image",
+  "The integral image of an input image is computed only once and shared by all scales, i.e., all :py:class:`LBP` extractors. "
+  "The rows of all scales are processed in parallel.\n\n"
+  "The codes of all scales are written into one ``(n_scales, height, width)`` stack, where the codes ``stack[:,y,x]`` of all scales are extracted for the same central pixel ``(y,x) +`` :py:attr:`offset` of the image. "
+  "Hence, the stack only contains the pixels, for which the codes of all scales exist."
+).add_constructor(
+  bob::extension::FunctionDoc(
+    "__init__",
+    "Creates a multi-scale LBP extractor",
+    "The first version uses copies of the given multi-block :py:class:`LBP` extractors. "
+    "The second version creates multi-block :py:class:`LBP` extractors with the given block sizes and block overlaps.",
+    true
+  )
+  .add_prototype("lbps", "")
+  .add_prototype("neighbors, block_sizes, [block_overlaps], [uniform], [rotation_invariant]", "")
+  .add_parameter("lbps", "[:py:class:`LBP`]", "The multi-block LBP extractors, one for each scale")
+  .add_parameter("neighbors", "int", "The number of neighboring blocks, 4 or 8")
+  .add_parameter("block_sizes", "[(int, int)]", "The block sizes of all scales")
+  .add_parameter("block_overlaps", "[(int, int)]", "[default: no overlap] The block overlaps of all scales")
+  .add_parameter("uniform", "bool", "[default: ``False``] Extract uniform LBP features?")
+  .add_parameter("rotation_invariant", "bool", "[default: ``False``] Extract rotation invariant LBP features?")
+);
+
+
+static int PyBobIpBaseMultiScaleLBP_init(PyBobIpBaseMultiScaleLBPObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  char** kwlist1 = MultiScaleLBP_doc.kwlist(0);
+  char** kwlist2 = MultiScaleLBP_doc.kwlist(1);
+
+  std::vector<boost::shared_ptr<bob::ip::base::LBP> > lbps;
+
+  PyObject* k = Py_BuildValue("s", kwlist2[0]);
+  auto k_ = make_safe(k);
+  if (
+    (kwargs && PyDict_Contains(kwargs, k)) ||
+    (args && PyTuple_Size(args) && PyInt_Check(PyTuple_GetItem(args, 0)))
+  ){
+    // create the LBP's from the block sizes
+    int neighbors;
+    PyObject* sizes,* overlaps = 0,* uniform = 0,* rotation_invariant = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "iO|OO!O!", kwlist2, &neighbors, &sizes, &overlaps, &PyBool_Type, &uniform, &PyBool_Type, &rotation_invariant)){
+      MultiScaleLBP_doc.print_usage();
+      return -1;
+    }
+    std::vector<blitz::TinyVector<int,2> > block_sizes, block_overlaps;
+    if (!_pairs(sizes, block_sizes) || (overlaps && !_pairs(overlaps, block_overlaps))){
+      MultiScaleLBP_doc.print_usage();
+      return -1;
+    }
+    if (overlaps && block_overlaps.size() != block_sizes.size()){
+      PyErr_Format(PyExc_ValueError, "`%s' requires the same number of block sizes (%" PY_FORMAT_SIZE_T "d) and block overlaps (%" PY_FORMAT_SIZE_T "d)", Py_TYPE(self)->tp_name, block_sizes.size(), block_overlaps.size());
+      return -1;
+    }
+    for (size_t s = 0; s < block_sizes.size(); ++s){
+      blitz::TinyVector<int,2> overlap = overlaps ? block_overlaps[s] : blitz::TinyVector<int,2>(0,0);
+      lbps.push_back(boost::shared_ptr<bob::ip::base::LBP>(new bob::ip::base::LBP(neighbors, block_sizes[s], overlap, false, false, f(uniform), f(rotation_invariant))));
+    }
+  } else {
+    // use the given LBP's
+    PyObject* list;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O", kwlist1, &list)){
+      MultiScaleLBP_doc.print_usage();
+      return -1;
+    }
+    PyObject* seq = PySequence_Fast(list, "expected a sequence of LBP objects");
+    if (!seq) return -1;
+    auto seq_ = make_safe(seq);
+    for (Py_ssize_t i = 0; i < PySequence_Fast_GET_SIZE(seq); ++i){
+      PyObject* lbp = PySequence_Fast_GET_ITEM(seq, i);
+      if (!PyBobIpBaseLBP_Check(lbp)){
+        PyErr_Format(PyExc_TypeError, "`%s' requires a sequence of %s objects, but element %" PY_FORMAT_SIZE_T "d is a %s", Py_TYPE(self)->tp_name, PyBobIpBaseLBP_Type.tp_name, i, Py_TYPE(lbp)->tp_name);
+        MultiScaleLBP_doc.print_usage();
+        return -1;
+      }
+      lbps.push_back(reinterpret_cast<PyBobIpBaseLBPObject*>(lbp)->cxx);
+    }
+  }
+
+  self->cxx.reset(new bob::ip::base::MultiScaleLBP(lbps));
+  return 0;
+
+  BOB_CATCH_MEMBER("cannot create MultiScaleLBP extractor", -1)
+}
+
+static void PyBobIpBaseMultiScaleLBP_delete(PyBobIpBaseMultiScaleLBPObject* self) {
+  self->cxx.reset();
+  Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+int PyBobIpBaseMultiScaleLBP_Check(PyObject* o) {
+  return PyObject_IsInstance(o, reinterpret_cast<PyObject*>(&PyBobIpBaseMultiScaleLBP_Type));
+}
+
+
+/******************************************************************/
+/************ Variables Section ***********************************/
+/******************************************************************/
+
+static auto lbps = bob::extension::VariableDoc(
+  "lbps",
+  "(:py:class:`LBP`, ...)",
+  "Copies of the multi-block LBP extractors of all scales, read access only"
+);
+PyObject* PyBobIpBaseMultiScaleLBP_getLBPs(PyBobIpBaseMultiScaleLBPObject* self, void*){
+  BOB_TRY
+  const std::vector<boost::shared_ptr<bob::ip::base::LBP> >& l = self->cxx->getLBPs();
+  PyObject* tuple = PyTuple_New(l.size());
+  if (!tuple) return 0;
+  auto tuple_ = make_safe(tuple);
+  for (size_t s = 0; s < l.size(); ++s){
+    PyBobIpBaseLBPObject* lbp = (PyBobIpBaseLBPObject*)PyBobIpBaseLBP_Type.tp_alloc(&PyBobIpBaseLBP_Type, 0);
+    if (!lbp) return 0;
+    lbp->cxx.reset(new bob::ip::base::LBP(*l[s]));
+    PyTuple_SET_ITEM(tuple, s, (PyObject*)lbp);
+  }
+  return Py_BuildValue("O", tuple);
+  BOB_CATCH_MEMBER("lbps could not be read", 0)
+}
+
+static auto offset = bob::extension::VariableDoc(
+  "offset",
+  "(int, int)",
+  "The position in the image, where the codes ``stack[:,0,0]`` are extracted, read access only"
+);
+PyObject* PyBobIpBaseMultiScaleLBP_getOffset(PyBobIpBaseMultiScaleLBPObject* self, void*){
+  BOB_TRY
+  auto r = self->cxx->getOffset();
+  return Py_BuildValue("(ii)", r[0], r[1]);
+  BOB_CATCH_MEMBER("offset could not be read", 0)
+}
+
+static PyGetSetDef PyBobIpBaseMultiScaleLBP_getseters[] = {
+    {
+      lbps.name(),
+      (getter)PyBobIpBaseMultiScaleLBP_getLBPs,
+      0,
+      lbps.doc(),
+      0
+    },
+    {
+      offset.name(),
+      (getter)PyBobIpBaseMultiScaleLBP_getOffset,
+      0,
+      offset.doc(),
+      0
+    },
+    {0}  /* Sentinel */
+};
+
+
+/******************************************************************/
+/************ Functions Section ***********************************/
+/******************************************************************/
+
+static auto getShape = bob::extension::FunctionDoc(
+  "lbp_shape",
+  "This function returns the shape of the LBP code stack for the given image",
+  0,
+  true
+)
+.add_prototype("input, [is_integral_image]", "lbp_shape")
+.add_prototype("shape, [is_integral_image]", "lbp_shape")
+.add_parameter("input", "array_like (2D)", "The input image for which LBP features should be extracted")
+.add_parameter("shape", "(int, int)", "The shape of the input image for which LBP features should be extracted")
+.add_parameter("is_integral_image", "bool", "[default: ``False``] Is the given image (shape) an integral image?")
+.add_return("lbp_shape", "(int, int, int)", "The shape of the LBP code stack that is required in a call to :py:func:`extract`")
+;
+
+static PyObject* PyBobIpBaseMultiScaleLBP_getShape(PyBobIpBaseMultiScaleLBPObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  char** kwlist1 = getShape.kwlist(0);
+  char** kwlist2 = getShape.kwlist(1);
+
+  blitz::TinyVector<int,2> shape;
+  PyObject* iii = 0; // is_integral_image
+  PyObject* k = Py_BuildValue("s", kwlist2[0]);
+  auto k_ = make_safe(k);
+  if (
+    (kwargs && PyDict_Contains(kwargs, k)) ||
+    (args && PyTuple_Size(args) && (PyTuple_Check(PyTuple_GetItem(args, 0)) || PyList_Check(PyTuple_GetItem(args, 0))))
+  ){
+    // by shape
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "(ii)|O!", kwlist2, &shape[0], &shape[1], &PyBool_Type, &iii)){
+      getShape.print_usage();
+      return 0;
+    }
+  } else {
+    // by image
+    PyBlitzArrayObject* image = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&|O!", kwlist1, &PyBlitzArray_Converter, &image, &PyBool_Type, &iii)){
+      getShape.print_usage();
+      return 0;
+    }
+    auto _ = make_safe(image);
+    if (image->ndim != 2) {
+      getShape.print_usage();
+      PyErr_Format(PyExc_TypeError, "`%s' only accepts 2-dimensional arrays (not %" PY_FORMAT_SIZE_T "dD arrays)", Py_TYPE(self)->tp_name, image->ndim);
+      return 0;
+    }
+    shape[0] = image->shape[0];
+    shape[1] = image->shape[1];
+  }
+  auto lbp_shape = self->cxx->getLBPShape(shape, f(iii));
+  return Py_BuildValue("(iii)", lbp_shape[0], lbp_shape[1], lbp_shape[2]);
+
+  BOB_CATCH_MEMBER("cannot get LBP output shape", 0)
+}
+
+static auto extract = bob::extension::FunctionDoc(
+  "extract",
+  "This function extracts the LBP codes of all scales from an image",
+  "The integral image of the ``input`` is computed once, unless ``is_integral_image`` is ``True``. "
+  "Alternatively, a :py:class:`PreparedImage` can be given as ``input``. "
+  "The rows of all scales are processed by ``n_threads`` threads, and the global interpreter lock is released during the extraction.\n\n"
+  ".. note::\n\n  The :py:func:`__call__` function is an alias for this method.",
+  true
+)
+.add_prototype("input, [output], [is_integral_image], [n_threads]", "output")
+.add_parameter("input", "array_like (2D) or :py:class:`PreparedImage`", "The input image for which LBP features should be extracted")
+.add_parameter("output", "array_like (3D, uint16)", "[default: ``None``] If given, the output code stack, which needs to be of shape :py:func:`lbp_shape`")
+.add_parameter("is_integral_image", "bool", "[default: ``False``] Is the given ``input`` image an integral image?")
+.add_parameter("n_threads", "int", "[default: 1] The number of threads to use; if 0 or negative, all hardware threads are used")
+.add_return("output", "array_like (3D, uint16)", "The resulting stack of LBP codes")
+;
+
+template <typename T>
+static void extract_inner(PyBobIpBaseMultiScaleLBPObject* self, PyBlitzArrayObject* input, PyBlitzArrayObject* output, bool iii, int n_threads){
+  const blitz::Array<T,2>& src = *PyBlitzArrayCxx_AsBlitz<T,2>(input);
+  blitz::Array<uint16_t,3>& dst = *PyBlitzArrayCxx_AsBlitz<uint16_t,3>(output);
+  ReleaseGIL gil;
+  self->cxx->extract(src, dst, iii, n_threads);
+}
+
+static PyObject* PyBobIpBaseMultiScaleLBP_extract(PyBobIpBaseMultiScaleLBPObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+  char** kwlist = extract.kwlist(0);
+
+  PyObject* input_object;
+  PyBlitzArrayObject* output = 0;
+  PyObject* iii = 0; // is_integral_image
+  int n_threads = 1;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|O&O!i", kwlist, &input_object, &PyBlitzArray_OutputConverter, &output, &PyBool_Type, &iii, &n_threads)){
+    extract.print_usage();
+    return 0;
+  }
+  auto output_ = make_xsafe(output);
+
+  // the input might be a prepared image instead of an array
+  PyBobIpBasePreparedImageObject* prepared = 0;
+  PyBlitzArrayObject* input = 0;
+  auto input_ = make_xsafe(input);
+  blitz::TinyVector<int,2> input_shape;
+  if (PyBobIpBasePreparedImage_Check(input_object)){
+    if (f(iii)){
+      PyErr_Format(PyExc_TypeError, "`%s' cannot extract from prepared images with is_integral_image=True", Py_TYPE(self)->tp_name);
+      extract.print_usage();
+      return 0;
+    }
+    prepared = reinterpret_cast<PyBobIpBasePreparedImageObject*>(input_object);
+    input_shape = prepared->cxx->getShape();
+  } else {
+    if (!PyBlitzArray_Converter(input_object, &input)){
+      extract.print_usage();
+      return 0;
+    }
+    input_ = make_safe(input);
+    if (input->ndim != 2){
+      PyErr_Format(PyExc_TypeError, "`%s' only extracts from 2D arrays", Py_TYPE(self)->tp_name);
+      extract.print_usage();
+      return 0;
+    }
+    input_shape = blitz::TinyVector<int,2>(input->shape[0], input->shape[1]);
+  }
+
+  auto shape = self->cxx->getLBPShape(input_shape, f(iii));
+  if (output){
+    if (output->ndim != 3 || output->type_num != NPY_UINT16){
+      PyErr_Format(PyExc_TypeError, "`%s' only extracts to 3D arrays of type uint16", Py_TYPE(self)->tp_name);
+      extract.print_usage();
+      return 0;
+    }
+    if (output->shape[0] != shape[0] || output->shape[1] != shape[1] || output->shape[2] != shape[2]){
+      PyErr_Format(PyExc_TypeError, "`%s' requires the shape of the output to be (%d, %d, %d), but it is (%" PY_FORMAT_SIZE_T "d, %" PY_FORMAT_SIZE_T "d, %" PY_FORMAT_SIZE_T "d)", Py_TYPE(self)->tp_name, shape[0], shape[1], shape[2], output->shape[0], output->shape[1], output->shape[2]);
+      extract.print_usage();
+      return 0;
+    }
+  } else {
+    Py_ssize_t osize[] = {shape[0], shape[1], shape[2]};
+    output = (PyBlitzArrayObject*)PyBlitzArray_SimpleNew(NPY_UINT16, 3, osize);
+    output_ = make_safe(output);
+  }
+
+  // finally, extract the features
+  if (prepared){
+    const bob::ip::base::PreparedImage& src = *prepared->cxx;
+    blitz::Array<uint16_t,3>& dst = *PyBlitzArrayCxx_AsBlitz<uint16_t,3>(output);
+    ReleaseGIL gil;
+    self->cxx->extract(src, dst, n_threads);
+  } else {
+    switch (input->type_num){
+      case NPY_UINT8:   extract_inner<uint8_t>(self, input, output, f(iii), n_threads); break;
+      case NPY_UINT16:  extract_inner<uint16_t>(self, input, output, f(iii), n_threads); break;
+      case NPY_UINT32:  extract_inner<uint32_t>(self, input, output, f(iii), n_threads); break;
+      case NPY_FLOAT32: extract_inner<float>(self, input, output, f(iii), n_threads); break;
+      case NPY_FLOAT64: extract_inner<double>(self, input, output, f(iii), n_threads); break;
+      default:
+        extract.print_usage();
+        PyErr_Format(PyExc_TypeError, "`%s' extracts only from images of types uint8, uint16, uint32, float32 or float64, and not from %s", Py_TYPE(self)->tp_name, PyBlitzArray_TypenumAsString(input->type_num));
+        return 0;
+    }
+  }
+
+  return PyBlitzArray_AsNumpyArray(output, 0);
+
+  BOB_CATCH_MEMBER("cannot extract LBP codes from image", 0)
+}
+
+static PyMethodDef PyBobIpBaseMultiScaleLBP_methods[] = {
+  {
+    getShape.name(),
+    (PyCFunction)PyBobIpBaseMultiScaleLBP_getShape,
+    METH_VARARGS|METH_KEYWORDS,
+    getShape.doc()
+  },
+  {
+    extract.name(),
+    (PyCFunction)PyBobIpBaseMultiScaleLBP_extract,
+    METH_VARARGS|METH_KEYWORDS,
+    extract.doc()
+  },
+  {0} /* Sentinel */
+};
+
+
+/******************************************************************/
+/************ Module Section **************************************/
+/******************************************************************/
+
+// Define the MultiScaleLBP type struct; will be initialized later
+PyTypeObject PyBobIpBaseMultiScaleLBP_Type = {
+  PyVarObject_HEAD_INIT(0,0)
+  0
+};
+
+bool init_BobIpBaseMultiScaleLBP(PyObject* module)
+{
+  // initialize the type struct
+  PyBobIpBaseMultiScaleLBP_Type.tp_name = MultiScaleLBP_doc.name();
+  PyBobIpBaseMultiScaleLBP_Type.tp_basicsize = sizeof(PyBobIpBaseMultiScaleLBPObject);
+  PyBobIpBaseMultiScaleLBP_Type.tp_flags = Py_TPFLAGS_DEFAULT;
+  PyBobIpBaseMultiScaleLBP_Type.tp_doc = MultiScaleLBP_doc.doc();
+
+  // set the functions
+  PyBobIpBaseMultiScaleLBP_Type.tp_new = PyType_GenericNew;
+  PyBobIpBaseMultiScaleLBP_Type.tp_init = reinterpret_cast<initproc>(PyBobIpBaseMultiScaleLBP_init);
+  PyBobIpBaseMultiScaleLBP_Type.tp_dealloc = reinterpret_cast<destructor>(PyBobIpBaseMultiScaleLBP_delete);
+  PyBobIpBaseMultiScaleLBP_Type.tp_methods = PyBobIpBaseMultiScaleLBP_methods;
+  PyBobIpBaseMultiScaleLBP_Type.tp_getset = PyBobIpBaseMultiScaleLBP_getseters;
+  PyBobIpBaseMultiScaleLBP_Type.tp_call = reinterpret_cast<ternaryfunc>(PyBobIpBaseMultiScaleLBP_extract);
+
+  // check that everything is fine
+  if (PyType_Ready(&PyBobIpBaseMultiScaleLBP_Type) < 0) return false;
+
+  // add the type to the module
+  Py_INCREF(&PyBobIpBaseMultiScaleLBP_Type);
+  return PyModule_AddObject(module, "MultiScaleLBP", (PyObject*)&PyBobIpBaseMultiScaleLBP_Type) >= 0;
+}
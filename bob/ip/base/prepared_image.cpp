@@ -0,0 +1,333 @@
+/**
+ * @date Sat Oct 17 10:12:35 CEST 2026
+ *
+ * @brief Binds the PreparedImage class to python
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include "main.h"
+
+/******************************************************************/
+/************ Constructor Section *********************************/
+/******************************************************************/
+
+static auto PreparedImage_doc = bob::extension::ClassDoc(
+  BOB_EXT_MODULE_PREFIX ".PreparedImage",
+  "Objects of this class hold an image together with its integral images, which are computed only once",
+  "The integral images (see :py:func:`bob.ip.base.integral`) are computed when they are requested for the first time, and they are re-used afterwards. "
+  "Hence, several consumers of integral images, e.g., the extraction of multi-block LBP features with :py:func:`LBP.extract` and the box statistics of this class, share the same integral images. "
+  "All integral images contain an additional row and column of zeros in the front, i.e., they are one pixel larger than the image in each dimension.\n\n"
+  ".. note::\n\n  The image is copied during construction, so that later modifications of the given image do not change the prepared image."
+).add_constructor(
+  bob::extension::FunctionDoc(
+    "__init__",
+    "Prepares the given image",
+    0,
+    true
+  )
+  .add_prototype("src", "")
+  .add_parameter("src", "array_like (2D)", "The image to prepare, of type uint8, uint16 or float")
+);
+
+
+template <typename T>
+static void init_inner(PyBobIpBasePreparedImageObject* self, PyBlitzArrayObject* src){
+  self->cxx.reset(new bob::ip::base::PreparedImage(*PyBlitzArrayCxx_AsBlitz<T,2>(src)));
+}
+
+static int PyBobIpBasePreparedImage_init(PyBobIpBasePreparedImageObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  char** kwlist = PreparedImage_doc.kwlist(0);
+
+  PyBlitzArrayObject* src;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&", kwlist, &PyBlitzArray_Converter, &src)){
+    PreparedImage_doc.print_usage();
+    return -1;
+  }
+  auto src_ = make_safe(src);
+
+  if (src->ndim != 2){
+    PyErr_Format(PyExc_TypeError, "`%s' only prepares 2D arrays", Py_TYPE(self)->tp_name);
+    PreparedImage_doc.print_usage();
+    return -1;
+  }
+
+  switch (src->type_num){
+    case NPY_UINT8:   init_inner<uint8_t>(self, src); break;
+    case NPY_UINT16:  init_inner<uint16_t>(self, src); break;
+    case NPY_FLOAT64: init_inner<double>(self, src); break;
+    default:
+      PyErr_Format(PyExc_TypeError, "`%s' prepares only images of types uint8, uint16 or float, and not from %s", Py_TYPE(self)->tp_name, PyBlitzArray_TypenumAsString(src->type_num));
+      PreparedImage_doc.print_usage();
+      return -1;
+  }
+  return 0;
+
+  BOB_CATCH_MEMBER("cannot create PreparedImage", -1)
+}
+
+static void PyBobIpBasePreparedImage_delete(PyBobIpBasePreparedImageObject* self) {
+  self->cxx.reset();
+  Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+int PyBobIpBasePreparedImage_Check(PyObject* o) {
+  return PyObject_IsInstance(o, reinterpret_cast<PyObject*>(&PyBobIpBasePreparedImage_Type));
+}
+
+
+/******************************************************************/
+/************ Variables Section ***********************************/
+/******************************************************************/
+
+static auto shape = bob::extension::VariableDoc(
+  "shape",
+  "(int, int)",
+  "The shape of the prepared image, read access only"
+);
+PyObject* PyBobIpBasePreparedImage_getShape(PyBobIpBasePreparedImageObject* self, void*){
+  BOB_TRY
+  auto r = self->cxx->getShape();
+  return Py_BuildValue("(ii)", r[0], r[1]);
+  BOB_CATCH_MEMBER("shape could not be read", 0)
+}
+
+static auto source = bob::extension::VariableDoc(
+  "source",
+  "array_like (2D, float)",
+  "The prepared image, converted to float, read access only"
+);
+PyObject* PyBobIpBasePreparedImage_getSource(PyBobIpBasePreparedImageObject* self, void*){
+  BOB_TRY
+  return PyBlitzArrayCxx_AsConstNumpy(self->cxx->getSource());
+  BOB_CATCH_MEMBER("source could not be read", 0)
+}
+
+static auto isIntegerImage = bob::extension::VariableDoc(
+  "is_integer_image",
+  "bool",
+  "Has the prepared image been of an integral type (and can provide an :py:func:`integer_integral`)?, read access only"
+);
+PyObject* PyBobIpBasePreparedImage_getIsIntegerImage(PyBobIpBasePreparedImageObject* self, void*){
+  BOB_TRY
+  if (self->cxx->isIntegerImage()) Py_RETURN_TRUE; else Py_RETURN_FALSE;
+  BOB_CATCH_MEMBER("is_integer_image could not be read", 0)
+}
+
+static PyGetSetDef PyBobIpBasePreparedImage_getseters[] = {
+    {
+      shape.name(),
+      (getter)PyBobIpBasePreparedImage_getShape,
+      0,
+      shape.doc(),
+      0
+    },
+    {
+      source.name(),
+      (getter)PyBobIpBasePreparedImage_getSource,
+      0,
+      source.doc(),
+      0
+    },
+    {
+      isIntegerImage.name(),
+      (getter)PyBobIpBasePreparedImage_getIsIntegerImage,
+      0,
+      isIntegerImage.doc(),
+      0
+    },
+    {0}  /* Sentinel */
+};
+
+
+/******************************************************************/
+/************ Functions Section ***********************************/
+/******************************************************************/
+
+static auto integral = bob::extension::FunctionDoc(
+  "integral",
+  "Returns the integral image of the prepared image",
+  "The integral image is computed at the first call only.",
+  true
+)
+.add_prototype("", "integral")
+.add_return("integral", "array_like (2D, float)", "The integral image, with one additional row and column of zeros in the front")
+;
+static PyObject* PyBobIpBasePreparedImage_integral(PyBobIpBasePreparedImageObject* self) {
+  BOB_TRY
+  return PyBlitzArrayCxx_AsConstNumpy(self->cxx->getIntegral());
+  BOB_CATCH_MEMBER("cannot compute integral image", 0)
+}
+
+static auto squaredIntegral = bob::extension::FunctionDoc(
+  "squared_integral",
+  "Returns the integral image of the squared prepared image",
+  "The integral image is computed at the first call only.",
+  true
+)
+.add_prototype("", "integral")
+.add_return("integral", "array_like (2D, float)", "The integral image of the squared pixels, with one additional row and column of zeros in the front")
+;
+static PyObject* PyBobIpBasePreparedImage_squaredIntegral(PyBobIpBasePreparedImageObject* self) {
+  BOB_TRY
+  return PyBlitzArrayCxx_AsConstNumpy(self->cxx->getSquaredIntegral());
+  BOB_CATCH_MEMBER("cannot compute squared integral image", 0)
+}
+
+static auto integerIntegral = bob::extension::FunctionDoc(
+  "integer_integral",
+  "Returns the exact integral image of a prepared image of integral type",
+  "The integral image is computed at the first call only. "
+  "This function raises a :py:class:`RuntimeError` if the prepared image was not of an integral type, see :py:attr:`is_integer_image`.",
+  true
+)
+.add_prototype("", "integral")
+.add_return("integral", "array_like (2D, int64)", "The integral image, with one additional row and column of zeros in the front")
+;
+static PyObject* PyBobIpBasePreparedImage_integerIntegral(PyBobIpBasePreparedImageObject* self) {
+  BOB_TRY
+  return PyBlitzArrayCxx_AsConstNumpy(self->cxx->getIntegerIntegral());
+  BOB_CATCH_MEMBER("cannot compute integer integral image", 0)
+}
+
+static auto boxSum = bob::extension::FunctionDoc(
+  "box_sum",
+  "Computes the sum of the pixels in the given box of the prepared image",
+  "The sum is computed from the integral image in constant time. "
+  "For prepared images of integral type, the exact :py:func:`integer_integral` is used.",
+  true
+)
+.add_prototype("top_left, size", "sum")
+.add_parameter("top_left", "(int, int)", "The top-left position of the box in the image")
+.add_parameter("size", "(int, int)", "The height and width of the box")
+.add_return("sum", "float", "The sum of the pixels ``src[top_left[0]:top_left[0]+size[0], top_left[1]:top_left[1]+size[1]]``")
+;
+
+static auto boxMean = bob::extension::FunctionDoc(
+  "box_mean",
+  "Computes the mean of the pixels in the given box of the prepared image",
+  "The mean is computed from the integral image in constant time.",
+  true
+)
+.add_prototype("top_left, size", "mean")
+.add_parameter("top_left", "(int, int)", "The top-left position of the box in the image")
+.add_parameter("size", "(int, int)", "The height and width of the box")
+.add_return("mean", "float", "The mean of the pixels in the box")
+;
+
+static auto boxVariance = bob::extension::FunctionDoc(
+  "box_variance",
+  "Computes the variance of the pixels in the given box of the prepared image",
+  "The variance is computed from the integral image and the :py:func:`squared_integral` image in constant time.",
+  true
+)
+.add_prototype("top_left, size", "variance")
+.add_parameter("top_left", "(int, int)", "The top-left position of the box in the image")
+.add_parameter("size", "(int, int)", "The height and width of the box")
+.add_return("variance", "float", "The (biased) variance of the pixels in the box")
+;
+
+static PyObject* box_statistics(PyBobIpBasePreparedImageObject* self, PyObject* args, PyObject* kwargs, bob::extension::FunctionDoc& doc, double (bob::ip::base::PreparedImage::*function)(const int, const int, const int, const int) const) {
+  char** kwlist = doc.kwlist(0);
+
+  blitz::TinyVector<int,2> top_left, size;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "(ii)(ii)", kwlist, &top_left[0], &top_left[1], &size[0], &size[1])){
+    doc.print_usage();
+    return 0;
+  }
+  return Py_BuildValue("d", ((*self->cxx).*function)(top_left[0], top_left[1], size[0], size[1]));
+}
+
+static PyObject* PyBobIpBasePreparedImage_boxSum(PyBobIpBasePreparedImageObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+  return box_statistics(self, args, kwargs, boxSum, &bob::ip::base::PreparedImage::boxSum);
+  BOB_CATCH_MEMBER("cannot compute box sum", 0)
+}
+
+static PyObject* PyBobIpBasePreparedImage_boxMean(PyBobIpBasePreparedImageObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+  return box_statistics(self, args, kwargs, boxMean, &bob::ip::base::PreparedImage::boxMean);
+  BOB_CATCH_MEMBER("cannot compute box mean", 0)
+}
+
+static PyObject* PyBobIpBasePreparedImage_boxVariance(PyBobIpBasePreparedImageObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+  return box_statistics(self, args, kwargs, boxVariance, &bob::ip::base::PreparedImage::boxVariance);
+  BOB_CATCH_MEMBER("cannot compute box variance", 0)
+}
+
+static PyMethodDef PyBobIpBasePreparedImage_methods[] = {
+  {
+    integral.name(),
+    (PyCFunction)PyBobIpBasePreparedImage_integral,
+    METH_NOARGS,
+    integral.doc()
+  },
+  {
+    squaredIntegral.name(),
+    (PyCFunction)PyBobIpBasePreparedImage_squaredIntegral,
+    METH_NOARGS,
+    squaredIntegral.doc()
+  },
+  {
+    integerIntegral.name(),
+    (PyCFunction)PyBobIpBasePreparedImage_integerIntegral,
+    METH_NOARGS,
+    integerIntegral.doc()
+  },
+  {
+    boxSum.name(),
+    (PyCFunction)PyBobIpBasePreparedImage_boxSum,
+    METH_VARARGS|METH_KEYWORDS,
+    boxSum.doc()
+  },
+  {
+    boxMean.name(),
+    (PyCFunction)PyBobIpBasePreparedImage_boxMean,
+    METH_VARARGS|METH_KEYWORDS,
+    boxMean.doc()
+  },
+  {
+    boxVariance.name(),
+    (PyCFunction)PyBobIpBasePreparedImage_boxVariance,
+    METH_VARARGS|METH_KEYWORDS,
+    boxVariance.doc()
+  },
+  {0} /* Sentinel */
+};
+
+
+/******************************************************************/
+/************ Module Section **************************************/
+/******************************************************************/
+
+// Define the PreparedImage type struct; will be initialized later
+PyTypeObject PyBobIpBasePreparedImage_Type = {
+  PyVarObject_HEAD_INIT(0,0)
+  0
+};
+
+bool init_BobIpBasePreparedImage(PyObject* module)
+{
+  // initialize the type struct
+  PyBobIpBasePreparedImage_Type.tp_name = PreparedImage_doc.name();
+  PyBobIpBasePreparedImage_Type.tp_basicsize = sizeof(PyBobIpBasePreparedImageObject);
+  PyBobIpBasePreparedImage_Type.tp_flags = Py_TPFLAGS_DEFAULT;
+  PyBobIpBasePreparedImage_Type.tp_doc = PreparedImage_doc.doc();
+
+  // set the functions
+  PyBobIpBasePreparedImage_Type.tp_new = PyType_GenericNew;
+  PyBobIpBasePreparedImage_Type.tp_init = reinterpret_cast<initproc>(PyBobIpBasePreparedImage_init);
+  PyBobIpBasePreparedImage_Type.tp_dealloc = reinterpret_cast<destructor>(PyBobIpBasePreparedImage_delete);
+  PyBobIpBasePreparedImage_Type.tp_methods = PyBobIpBasePreparedImage_methods;
+  PyBobIpBasePreparedImage_Type.tp_getset = PyBobIpBasePreparedImage_getseters;
+
+  // check that everything is fine
+  if (PyType_Ready(&PyBobIpBasePreparedImage_Type) < 0) return false;
+
+  // add the type to the module
+  Py_INCREF(&PyBobIpBasePreparedImage_Type);
+  return PyModule_AddObject(module, "PreparedImage", (PyObject*)&PyBobIpBasePreparedImage_Type) >= 0;
+}
@@ -0,0 +1,305 @@
+/**
+ * @date Fri Oct 16 15:04:12 CEST 2026
+ *
+ * @brief Binds the Remap class to python
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include "main.h"
+
+/******************************************************************/
+/************ Constructor Section *********************************/
+/******************************************************************/
+
+static auto Remap_doc = bob::extension::ClassDoc(
+  BOB_EXT_MODULE_PREFIX ".Remap",
+  "Objects of this class apply a fixed affine transformation to many images of the same size",
+  "During construction, the source offsets and the bi-linear interpolation weights of all output pixels are computed once, so that applying the transformation to an image only requires to look up the pre-computed coordinate map. "
+  "This is much faster than :py:func:`GeomNorm.process`, when the same transformation is applied to many images, e.g., to all frames of a video.\n\n"
+  "The output pixel ``(y, x)`` is interpolated from the input image at position ``matrix * (y, x, 1)``. "
+  "As in :py:class:`GeomNorm`, pixels outside of the input image are treated as 0. "
+  "The interpolation weights are quantized to 15 bits, so that the results might differ slightly from :py:func:`GeomNorm.process`."
+).add_constructor(
+  bob::extension::FunctionDoc(
+    "__init__",
+    "Constructs a Remap object for the given transformation and image shapes",
+    "The first version pre-computes the transformation that the given :py:class:`GeomNorm` applies to images of shape ``src_shape`` with the given ``center``. "
+    "The second version uses a general affine transformation matrix.",
+    true
+  )
+  .add_prototype("geom_norm, center, src_shape", "")
+  .add_prototype("matrix, src_shape, dst_shape", "")
+  .add_parameter("geom_norm", ":py:class:`GeomNorm`", "The geometric normalization that should be pre-computed")
+  .add_parameter("center", "(float, float)", "The transformation center in the input images")
+  .add_parameter("matrix", "array_like (2D, float)", "The affine transformation of shape ``(2, 3)`` that maps output image coordinates ``(y, x, 1)`` to input image coordinates")
+  .add_parameter("src_shape", "(int, int)", "The shape of the input images")
+  .add_parameter("dst_shape", "(int, int)", "The shape of the output images")
+);
+
+
+static int PyBobIpBaseRemap_init(PyBobIpBaseRemapObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  char** kwlist1 = Remap_doc.kwlist(0);
+  char** kwlist2 = Remap_doc.kwlist(1);
+
+  // get the number of command line arguments
+  Py_ssize_t nargs = (args?PyTuple_Size(args):0) + (kwargs?PyDict_Size(kwargs):0);
+  if (nargs != 3){
+    Remap_doc.print_usage();
+    PyErr_Format(PyExc_TypeError, "`%s' constructor requires exactly three parameters", Py_TYPE(self)->tp_name);
+    return -1;
+  }
+
+  // check the first parameter
+  PyObject* k = Py_BuildValue("s", kwlist1[0]);
+  auto k_ = make_safe(k);
+  if (
+    (kwargs && PyDict_Contains(kwargs, k)) ||
+    (args && PyTuple_Size(args) && PyBobIpBaseGeomNorm_Check(PyTuple_GetItem(args, 0)))
+  ){
+    PyBobIpBaseGeomNormObject* geomNorm;
+    blitz::TinyVector<double,2> center;
+    blitz::TinyVector<int,2> src_shape;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!(dd)(ii)", kwlist1, &PyBobIpBaseGeomNorm_Type, &geomNorm, &center[0], &center[1], &src_shape[0], &src_shape[1])){
+      Remap_doc.print_usage();
+      return -1;
+    }
+    self->cxx.reset(new bob::ip::base::Remap(*geomNorm->cxx, center, src_shape));
+    return 0;
+  }
+
+  PyBlitzArrayObject* matrix;
+  blitz::TinyVector<int,2> src_shape, dst_shape;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&(ii)(ii)", kwlist2, &PyBlitzArray_Converter, &matrix, &src_shape[0], &src_shape[1], &dst_shape[0], &dst_shape[1])){
+    Remap_doc.print_usage();
+    return -1;
+  }
+  auto matrix_ = make_safe(matrix);
+  if (matrix->ndim != 2 || matrix->type_num != NPY_FLOAT64){
+    PyErr_Format(PyExc_TypeError, "`%s' requires the matrix to be a 2D array of type float64", Py_TYPE(self)->tp_name);
+    Remap_doc.print_usage();
+    return -1;
+  }
+  self->cxx.reset(new bob::ip::base::Remap(*PyBlitzArrayCxx_AsBlitz<double,2>(matrix), src_shape, dst_shape));
+  return 0;
+
+  BOB_CATCH_MEMBER("cannot create Remap object", -1)
+}
+
+static void PyBobIpBaseRemap_delete(PyBobIpBaseRemapObject* self) {
+  self->cxx.reset();
+  Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+int PyBobIpBaseRemap_Check(PyObject* o) {
+  return PyObject_IsInstance(o, reinterpret_cast<PyObject*>(&PyBobIpBaseRemap_Type));
+}
+
+
+/******************************************************************/
+/************ Variables Section ***********************************/
+/******************************************************************/
+
+static auto srcShape = bob::extension::VariableDoc(
+  "src_shape",
+  "(int, int)",
+  "The shape of the input images, read access only"
+);
+PyObject* PyBobIpBaseRemap_getSrcShape(PyBobIpBaseRemapObject* self, void*){
+  BOB_TRY
+  auto r = self->cxx->getSourceShape();
+  return Py_BuildValue("(ii)", r[0], r[1]);
+  BOB_CATCH_MEMBER("src_shape could not be read", 0)
+}
+
+static auto dstShape = bob::extension::VariableDoc(
+  "dst_shape",
+  "(int, int)",
+  "The shape of the output images, read access only"
+);
+PyObject* PyBobIpBaseRemap_getDstShape(PyBobIpBaseRemapObject* self, void*){
+  BOB_TRY
+  auto r = self->cxx->getTargetShape();
+  return Py_BuildValue("(ii)", r[0], r[1]);
+  BOB_CATCH_MEMBER("dst_shape could not be read", 0)
+}
+
+static auto matrix = bob::extension::VariableDoc(
+  "matrix",
+  "array_like (2D, float)",
+  "The affine transformation of shape ``(2, 3)`` from output to input image coordinates, read access only"
+);
+PyObject* PyBobIpBaseRemap_getMatrix(PyBobIpBaseRemapObject* self, void*){
+  BOB_TRY
+  return PyBlitzArrayCxx_AsConstNumpy(self->cxx->getMatrix());
+  BOB_CATCH_MEMBER("matrix could not be read", 0)
+}
+
+static PyGetSetDef PyBobIpBaseRemap_getseters[] = {
+    {
+      srcShape.name(),
+      (getter)PyBobIpBaseRemap_getSrcShape,
+      0,
+      srcShape.doc(),
+      0
+    },
+    {
+      dstShape.name(),
+      (getter)PyBobIpBaseRemap_getDstShape,
+      0,
+      dstShape.doc(),
+      0
+    },
+    {
+      matrix.name(),
+      (getter)PyBobIpBaseRemap_getMatrix,
+      0,
+      matrix.doc(),
+      0
+    },
+    {0}  /* Sentinel */
+};
+
+
+/******************************************************************/
+/************ Functions Section ***********************************/
+/******************************************************************/
+
+static auto process = bob::extension::FunctionDoc(
+  "process",
+  "This function applies the pre-computed transformation to the given image",
+  "3D images are transformed plane by plane. "
+  "The global interpreter lock is released while processing.\n\n"
+  ".. note::\n\n  The :py:func:`__call__` function is an alias for this method.",
+  true
+)
+.add_prototype("input, [output]", "output")
+.add_parameter("input", "array_like (2D or 3D)", "The input image, which must be of size :py:attr:`src_shape`")
+.add_parameter("output", "array_like (2D or 3D, float or same type as ``input``)", "[default: ``None``] If given, the output image, which must be of size :py:attr:`dst_shape`; can be of type numpy.float64, numpy.float32 or of the same type as ``input``, in which case the values are rounded")
+.add_return("output", "array_like (2D or 3D)", "The output image, of type numpy.float64 if not given as parameter")
+;
+
+template <typename T, typename U, int D>
+static void process_inner(PyBobIpBaseRemapObject* self, PyBlitzArrayObject* input, PyBlitzArrayObject* output){
+  const blitz::Array<T,D>& src = *PyBlitzArrayCxx_AsBlitz<T,D>(input);
+  blitz::Array<U,D>& dst = *PyBlitzArrayCxx_AsBlitz<U,D>(output);
+  ReleaseGIL gil;
+  self->cxx->process(src, dst);
+}
+
+template <typename T>
+static void process_typed(PyBobIpBaseRemapObject* self, PyBlitzArrayObject* input, PyBlitzArrayObject* output){
+  switch (output->type_num){
+    case NPY_FLOAT64: if (input->ndim == 2) process_inner<T,double,2>(self, input, output); else process_inner<T,double,3>(self, input, output); break;
+    case NPY_FLOAT32: if (input->ndim == 2) process_inner<T,float,2>(self, input, output);  else process_inner<T,float,3>(self, input, output); break;
+    // otherwise, the output is of the same type as the input
+    default:          if (input->ndim == 2) process_inner<T,T,2>(self, input, output);      else process_inner<T,T,3>(self, input, output);
+  }
+}
+
+static PyObject* PyBobIpBaseRemap_process(PyBobIpBaseRemapObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+  char** kwlist = process.kwlist(0);
+
+  PyBlitzArrayObject* input = 0,* output = 0;
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&|O&", kwlist, &PyBlitzArray_Converter, &input, &PyBlitzArray_OutputConverter, &output)){
+    process.print_usage();
+    return 0;
+  }
+
+  auto input_ = make_safe(input), output_ = make_xsafe(output);
+
+  // perform checks on input and output image
+  if (input->ndim != 2 && input->ndim != 3){
+    PyErr_Format(PyExc_TypeError, "`%s' only processes 2D or 3D arrays", Py_TYPE(self)->tp_name);
+    process.print_usage();
+    return 0;
+  }
+
+  if (output){
+    if (output->ndim != input->ndim){
+      PyErr_Format(PyExc_TypeError, "`%s' processes only input and output arrays with the same number of dimensions", Py_TYPE(self)->tp_name);
+      process.print_usage();
+      return 0;
+    }
+    if (output->type_num != NPY_FLOAT64 && output->type_num != NPY_FLOAT32 && output->type_num != input->type_num){
+      PyErr_Format(PyExc_TypeError, "`%s' processes only output arrays of type float64, float32 or of the same type as the input array", Py_TYPE(self)->tp_name);
+      process.print_usage();
+      return 0;
+    }
+  } else {
+    const blitz::TinyVector<int,2>& shape = self->cxx->getTargetShape();
+    if (input->ndim == 2){
+      Py_ssize_t n[] = {shape[0], shape[1]};
+      output = reinterpret_cast<PyBlitzArrayObject*>(PyBlitzArray_SimpleNew(NPY_FLOAT64, 2, n));
+    } else {
+      Py_ssize_t n[] = {input->shape[0], shape[0], shape[1]};
+      output = reinterpret_cast<PyBlitzArrayObject*>(PyBlitzArray_SimpleNew(NPY_FLOAT64, 3, n));
+    }
+    output_ = make_safe(output);
+  }
+
+  // finally, process the data
+  switch (input->type_num){
+    case NPY_UINT8:   process_typed<uint8_t>(self, input, output); break;
+    case NPY_UINT16:  process_typed<uint16_t>(self, input, output); break;
+    case NPY_FLOAT64: process_typed<double>(self, input, output); break;
+    default:
+      PyErr_Format(PyExc_TypeError, "`%s' input array of type %s are currently not supported", Py_TYPE(self)->tp_name, PyBlitzArray_TypenumAsString(input->type_num));
+      process.print_usage();
+      return 0;
+  }
+
+  return PyBlitzArray_AsNumpyArray(output, 0);
+
+  BOB_CATCH_MEMBER("cannot process image", 0)
+}
+
+static PyMethodDef PyBobIpBaseRemap_methods[] = {
+  {
+    process.name(),
+    (PyCFunction)PyBobIpBaseRemap_process,
+    METH_VARARGS|METH_KEYWORDS,
+    process.doc()
+  },
+  {0} /* Sentinel */
+};
+
+
+/******************************************************************/
+/************ Module Section **************************************/
+/******************************************************************/
+
+// Define the Remap type struct; will be initialized later
+PyTypeObject PyBobIpBaseRemap_Type = {
+  PyVarObject_HEAD_INIT(0,0)
+  0
+};
+
+bool init_BobIpBaseRemap(PyObject* module)
+{
+  // initialize the type struct
+  PyBobIpBaseRemap_Type.tp_name = Remap_doc.name();
+  PyBobIpBaseRemap_Type.tp_basicsize = sizeof(PyBobIpBaseRemapObject);
+  PyBobIpBaseRemap_Type.tp_flags = Py_TPFLAGS_DEFAULT;
+  PyBobIpBaseRemap_Type.tp_doc = Remap_doc.doc();
+
+  // set the functions
+  PyBobIpBaseRemap_Type.tp_new = PyType_GenericNew;
+  PyBobIpBaseRemap_Type.tp_init = reinterpret_cast<initproc>(PyBobIpBaseRemap_init);
+  PyBobIpBaseRemap_Type.tp_dealloc = reinterpret_cast<destructor>(PyBobIpBaseRemap_delete);
+  PyBobIpBaseRemap_Type.tp_methods = PyBobIpBaseRemap_methods;
+  PyBobIpBaseRemap_Type.tp_getset = PyBobIpBaseRemap_getseters;
+  PyBobIpBaseRemap_Type.tp_call = reinterpret_cast<ternaryfunc>(PyBobIpBaseRemap_process);
+
+  // check that everything is fine
+  if (PyType_Ready(&PyBobIpBaseRemap_Type) < 0) return false;
+
+  // add the type to the module
+  Py_INCREF(&PyBobIpBaseRemap_Type);
+  return PyModule_AddObject(module, "Remap", (PyObject*)&PyBobIpBaseRemap_Type) >= 0;
+}
+
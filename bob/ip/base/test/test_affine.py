@@ -93,6 +93,46 @@ def test_extrapolate_mask():
   assert numpy.allclose(i2_5_3, s2_5_3)
 
 
+def _max_rect_reference(mask):
+  # exhaustive search, as in the original implementation
+  best, rect = 0, (0, 0, 0, 0)
+  for y0 in range(mask.shape[0]):
+    run = numpy.nonzero(mask[y0])[0]
+    if not len(run): continue
+    i_min = run[0]
+    i_max = i_min + 1
+    while i_max < mask.shape[1] and mask[y0, i_max]: i_max += 1
+    for x0 in range(i_min, i_max):
+      for y1 in range(y0, mask.shape[0]):
+        for x1 in range(x0, i_max):
+          if mask[y0:y1+1, x0:x1+1].all() and (y1-y0+1) * (x1-x0+1) > best:
+            best, rect = (y1-y0+1) * (x1-x0+1), (y0, x0, y1-y0+1, x1-x0+1)
+  return rect
+
+
+def test_max_rect_in_mask():
+  # rotated masks
+  mask = numpy.ones((20, 24), numpy.bool)
+  rotated = numpy.ndarray((20, 24), numpy.bool)
+  bob.ip.base.rotate(numpy.ones((20, 24)), mask, numpy.ndarray((20, 24)), rotated, 30.)
+  masks = [rotated, numpy.zeros((5, 7), numpy.bool), numpy.ones((5, 7), numpy.bool)]
+
+  # random masks, also with several sequences of true values per row
+  rng = numpy.random.RandomState(42)
+  masks += [rng.rand(9, 11) > 0.3 for i in range(20)]
+
+  for m in masks:
+    assert bob.ip.base.max_rect_in_mask(m) == _max_rect_reference(m)
+
+  # stacks of masks
+  stack = numpy.array(masks[3:])
+  for n_threads in (1, 4):
+    rects = bob.ip.base.max_rect_in_mask(stack, n_threads=n_threads)
+    assert rects.shape == (len(stack), 4)
+    for m, r in zip(stack, rects):
+      assert tuple(r) == _max_rect_reference(m)
+
+
 ###############################################
 #### random image extrapolartion with mask ####
 ###############################################
@@ -129,6 +169,41 @@ def test_extrapolate_random():
   assert numpy.allclose(image, fill_ref_image)
 
 
+def test_extrapolate_wavefront():
+  # a non-convex mask with two separate regions
+  mask = numpy.zeros((40, 50), numpy.bool)
+  mask[5:15, 5:20] = True
+  mask[20:35, 30:45] = True
+  mask[10:30, 25] = True
+  source = numpy.random.RandomState(42).randint(50, 200, mask.shape).astype(numpy.uint8)
+
+  # without randomness, all pixels are copied from the masked area
+  image = source.copy()
+  bob.ip.base.extrapolate_mask(mask, image, random_sigma = 0., neighbors = 0, seed = 1)
+  assert numpy.all(image[mask] == source[mask])
+  assert set(numpy.unique(image)) <= set(numpy.unique(source[mask]))
+
+  # the results are identical for any number of threads
+  reference = source.astype(numpy.float64)
+  bob.ip.base.extrapolate_mask(mask, reference, random_sigma = 0.05, neighbors = 3, seed = 42)
+  assert numpy.all(reference[mask] == source[mask])
+  assert numpy.all(reference[~mask] > 0)
+  for n_threads in (2, 5, 0):
+    image = source.astype(numpy.float64)
+    bob.ip.base.extrapolate_mask(mask, image, random_sigma = 0.05, neighbors = 3, seed = 42, n_threads = n_threads)
+    assert (image == reference).all()
+
+  # different seeds give different results
+  image = source.astype(numpy.float64)
+  bob.ip.base.extrapolate_mask(mask, image, random_sigma = 0.05, neighbors = 3, seed = 43)
+  assert not (image == reference).all()
+
+  # the seed and the rng cannot be given at the same time
+  nose.tools.assert_raises(ValueError, bob.ip.base.extrapolate_mask, mask, image, 0.05, 3, bob.core.random.mt19937(42), 42)
+  # the seed requires a random_sigma to be given
+  nose.tools.assert_raises(ValueError, bob.ip.base.extrapolate_mask, mask, image, seed = 42)
+
+
 
 ###############################################
 ########## scaling ############################
@@ -189,6 +264,32 @@ def test_scale_factor():
     assert numpy.allclose(scaled_3by8by8[i], scaled_ref_8by8, atol=1e-7)
 
 
+def test_scale_area():
+  # down-scaling by integral factors is the mean of the covered blocks
+  src = numpy.random.RandomState(42).randint(0, 256, (64, 48)).astype(numpy.uint8)
+  reference = src.reshape(16, 4, 12, 4).mean(axis=(1,3))
+  scaled = bob.ip.base.scale(src, 0.25, area=True)
+  assert scaled.shape == (16, 12)
+  assert numpy.allclose(scaled, reference)
+
+  scaled = numpy.ndarray((16, 12), numpy.uint8)
+  bob.ip.base.scale(src, scaled, area=True)
+  assert (scaled == numpy.floor(reference + 0.5)).all()
+
+  # the mean value of the image is preserved for arbitrary shapes
+  for shape in ((13, 7), (5, 29), (64, 48), (100, 3)):
+    scaled = numpy.ndarray(shape)
+    bob.ip.base.scale(src.astype(numpy.float64), scaled, area=True)
+    assert abs(scaled.mean() - src.mean()) < 1e-8
+  assert numpy.allclose(bob.ip.base.scale(numpy.ones((285,193)), 0.3187, area=True), 1.)
+
+  # color images
+  color = numpy.array((src, src, src))
+  scaled = bob.ip.base.scale(color, 0.25, area=True)
+  for i in range(3):
+    assert numpy.allclose(scaled[i], reference)
+
+
 def test_scaled_output_shape():
   shape_2by2 = bob.ip.base.scaled_output_shape(scale_src, 0.5)
   assert shape_2by2 == (2,2)
@@ -203,6 +304,29 @@ def test_scale_non_round():
   assert numpy.allclose(scaled, 1.)
 
 
+def test_scale_separable():
+  # the separable scaling needs to give the same results as the generic transformation with the same scaling factor
+  src = numpy.random.RandomState(42).randint(0, 256, (21, 31)).astype(numpy.uint8)
+  for shape in ((31, 46), (11, 16), (41, 61)):
+    scaled = numpy.ndarray(shape)
+    bob.ip.base.scale(src, scaled)
+
+    factor = (shape[0] - 1.) / (src.shape[0] - 1.)
+    geom_norm = bob.ip.base.GeomNorm(0., factor, shape, (0, 0))
+    reference = numpy.ndarray(shape)
+    geom_norm(src, reference, (0, 0))
+    assert numpy.allclose(scaled, reference)
+
+    # color images use the same interpolation tables for all planes
+    color = numpy.array((src, src[::-1,:], src[:,::-1]))
+    scaled_color = numpy.ndarray((3,) + shape)
+    bob.ip.base.scale(color, scaled_color)
+    for i in range(3):
+      plane = numpy.ndarray(shape)
+      bob.ip.base.scale(color[i], plane)
+      assert numpy.allclose(scaled_color[i], plane)
+
+
 
 ###############################################
 ########## rotating ###########################
@@ -236,6 +360,98 @@ def test_rotate():
   assert numpy.allclose(normalized_r70, reference_r70)
 
 
+def _rotate_reference(src, shape, angle):
+  # straightforward bi-linear interpolation, checking the bounds of every source pixel
+  a = angle * math.pi / 180.
+  cy, cx = (src.shape[0] - 1) / 2., (src.shape[1] - 1) / 2.
+  ny, nx = (shape[0] - 1) / 2., (shape[1] - 1) / 2.
+  dst = numpy.zeros(shape)
+  for y in range(shape[0]):
+    for x in range(shape[1]):
+      sy = cy + (y - ny) * math.cos(a) + (x - nx) * math.sin(a)
+      sx = cx + (x - nx) * math.cos(a) - (y - ny) * math.sin(a)
+      oy, ox = int(math.floor(sy)), int(math.floor(sx))
+      my, mx = sy - oy, sx - ox
+      for py, px, weight in ((oy, ox, (1-my)*(1-mx)), (oy, ox+1, (1-my)*mx), (oy+1, ox, my*(1-mx)), (oy+1, ox+1, my*mx)):
+        if 0 <= py < src.shape[0] and 0 <= px < src.shape[1]:
+          dst[y,x] += weight * src[py,px]
+  return dst
+
+
+def test_rotate_interior():
+  # the interior of the rotated image is computed without bounds checks, the border with
+  src = numpy.random.RandomState(7).randint(0, 256, (17, 23)).astype(numpy.float64)
+  for angle in (0., 13., -45., 90., 137.):
+    dst = numpy.ndarray(bob.ip.base.rotated_output_shape(src, angle))
+    bob.ip.base.rotate(src, dst, angle)
+    assert numpy.allclose(dst, _rotate_reference(src, dst.shape, angle))
+
+
+def test_rotate_right_angles():
+  # rotations by multiples of 90 degrees are exact permutations of the pixels
+  src = numpy.random.RandomState(7).randint(0, 256, (3, 83, 141)).astype(numpy.uint8)
+  mask = numpy.random.RandomState(8).rand(83, 141) > 0.2
+  for angle in (0., 90., 180., 270., -90., 450.):
+    k = int(angle // 90) % 4
+    rotated = bob.ip.base.rotate(src[0], angle)
+    assert rotated.dtype == numpy.uint8
+    assert (rotated == numpy.rot90(src[0], k)).all()
+    # same as bi-linear interpolation
+    assert numpy.allclose(rotated, _rotate_reference(src[0].astype(numpy.float64), rotated.shape, angle))
+
+    # colored images
+    rotated = bob.ip.base.rotate(src, angle)
+    assert rotated.shape == bob.ip.base.rotated_output_shape(src, angle)
+    for p in range(3):
+      assert (rotated[p] == numpy.rot90(src[p], k)).all()
+
+    # float output
+    rotated = numpy.ndarray(bob.ip.base.rotated_output_shape(src[0], angle), numpy.float32)
+    bob.ip.base.rotate(src[0], rotated, angle)
+    assert (rotated == numpy.rot90(src[0], k)).all()
+
+    # masks are rotated in the same way, pixels outside the mask are set to 0
+    rotated = numpy.ndarray(bob.ip.base.rotated_output_shape(src[0], angle))
+    rotated_mask = numpy.ndarray(rotated.shape, numpy.bool)
+    bob.ip.base.rotate(src[0], mask, rotated, rotated_mask, angle)
+    assert (rotated_mask == numpy.rot90(mask, k)).all()
+    assert (rotated == numpy.rot90(numpy.where(mask, src[0], 0), k)).all()
+
+
+def test_typed_output():
+  # the geometric transformations can write float32 and integral outputs directly
+  image = bob.io.base.load(bob.io.base.test_utils.datafile("image.hdf5", "bob.ip.base"))
+  assert image.dtype == numpy.uint8
+
+  reference = bob.ip.base.rotate(image, 10.)
+  rotated = numpy.ndarray(reference.shape, numpy.float32)
+  bob.ip.base.rotate(image, rotated, 10.)
+  assert numpy.allclose(rotated, reference, atol=1e-3)
+  # uint8 images are interpolated with 8-bit fixed-point weights
+  rotated = numpy.ndarray(reference.shape, numpy.uint8)
+  bob.ip.base.rotate(image, rotated, 10.)
+  assert numpy.all(numpy.abs(rotated.astype(numpy.int32) - numpy.round(reference)) <= 2)
+
+  reference = bob.ip.base.scale(image, 0.7)
+  scaled = numpy.ndarray(reference.shape, numpy.float32)
+  bob.ip.base.scale(image, scaled)
+  assert numpy.allclose(scaled, reference, atol=1e-3)
+  scaled = numpy.ndarray(reference.shape, numpy.uint8)
+  bob.ip.base.scale(image, scaled)
+  assert numpy.all(numpy.abs(scaled.astype(numpy.int32) - numpy.round(reference)) <= 2)
+
+  geom_norm = bob.ip.base.GeomNorm(-10., 0.65, (40, 40), (0, 0))
+  reference = numpy.ndarray((40, 40))
+  geom_norm(image, reference, (54, 27))
+  for dtype in (numpy.float32, numpy.uint8):
+    processed = numpy.ndarray((40, 40), dtype)
+    geom_norm(image, processed, (54, 27))
+    assert numpy.all(numpy.abs(processed.astype(numpy.float64) - reference) <= 2)
+
+  # other output types are not supported
+  nose.tools.assert_raises(TypeError, bob.ip.base.rotate, image, numpy.ndarray(reference.shape, numpy.uint16), 10.)
+
+
 def test_rotate_mask():
   # TODO: implement
   raise SkipTest("This functionality is (yet) untested")
@@ -330,6 +546,69 @@ def test_geom_norm_position():
   assert numpy.allclose(rotated, (40 - 5. * math.sqrt(2.) * 2, 80. ))
 
 
+def test_geom_norm_batch():
+  # tests that processing several crops at once is identical to processing them one by one
+  test_image = bob.io.base.load(bob.io.base.test_utils.datafile("image_r10.hdf5", "bob.ip.base", "data/affine"))
+  geom_norm = bob.ip.base.GeomNorm(-10., 0.65, (40, 40), (20, 20))
+
+  centers = numpy.array([(54., 27.), (60.5, 40.25), (0., 0.), (-100., 300.), (30., 70.)])
+  angles = numpy.array([-10., 0., 45., 90., 13.])
+  scales = numpy.array([0.65, 1., 1.5, 0.5, 2.])
+
+  for n_threads in (1, 3, 0):
+    # with the parameters of the GeomNorm object
+    batch = geom_norm.process_batch(test_image, centers, n_threads=n_threads)
+    assert batch.shape == (5, 40, 40)
+    assert batch.dtype == numpy.float64
+    for k in range(len(centers)):
+      processed = numpy.ndarray((40, 40))
+      geom_norm(test_image, processed, tuple(centers[k]))
+      assert (batch[k] == processed).all()
+
+    # with per-crop angles and scales
+    batch = numpy.ndarray((5, 40, 40), numpy.uint8)
+    geom_norm.process_batch(test_image, centers, angles, scales, batch, n_threads)
+    for k in range(len(centers)):
+      processed = numpy.ndarray((40, 40), numpy.uint8)
+      bob.ip.base.GeomNorm(angles[k], scales[k], (40, 40), (20, 20))(test_image, processed, tuple(centers[k]))
+      assert (batch[k] == processed).all()
+
+  # wrong number of angles
+  nose.tools.assert_raises(TypeError, geom_norm.process_batch, test_image, centers, angles[:3])
+
+
+def test_remap():
+  # tests that the pre-computed transformation is (almost) identical to GeomNorm
+  test_image = bob.io.base.load(bob.io.base.test_utils.datafile("image_r10.hdf5", "bob.ip.base", "data/affine")).astype(numpy.float64)
+  geom_norm = bob.ip.base.GeomNorm(-10., 0.65, (40, 40), (20, 20))
+
+  for center in ((54., 27.), (0., 0.), (test_image.shape[0] - 1., 31.5)):
+    remap = bob.ip.base.Remap(geom_norm, center, test_image.shape)
+    assert remap.src_shape == test_image.shape
+    assert remap.dst_shape == (40, 40)
+    assert remap.matrix.shape == (2, 3)
+
+    reference = numpy.ndarray((40, 40))
+    geom_norm(test_image, reference, center)
+    remapped = remap(test_image)
+    assert remapped.dtype == numpy.float64
+    assert numpy.allclose(remapped, reference, atol=0.02)
+
+    # 3D images are processed plane by plane
+    stack = numpy.array([test_image, 255. - test_image])
+    remapped = numpy.ndarray((2, 40, 40), numpy.float32)
+    remap.process(stack, remapped)
+    assert numpy.allclose(remapped[0], reference, atol=0.02)
+
+  # general matrix: flipping the image horizontally
+  matrix = numpy.array([[1., 0., 0.], [0., -1., test_image.shape[1] - 1.]])
+  remap = bob.ip.base.Remap(matrix, test_image.shape, test_image.shape)
+  assert numpy.allclose(remap(test_image), test_image[:, ::-1])
+
+  # wrong input shape
+  nose.tools.assert_raises(RuntimeError, remap, test_image[:10])
+
+
 ###############################################
 ########## FaceEyesNorm #######################
 ###############################################
@@ -384,3 +663,30 @@ def test_face_eyes_norm():
   assert numpy.allclose(normalized, reference_image)
 
 
+
+
+def test_face_eyes_norm_batch():
+  # tests that extracting several faces at once is identical to extracting them one by one
+  test_image = bob.io.base.load(bob.io.base.test_utils.datafile("image_r10.hdf5", "bob.ip.base", "data/affine"))
+  fen = bob.ip.base.FaceEyesNorm((40, 40), 20, (5/19.*40, 20))
+
+  eyes = numpy.array([(67., 47., 62., 71.), (60., 40., 60., 60.), (70., 80., 30., 50.5)])
+  test_mask = test_image > 10
+  for n_threads in (1, 2, 0):
+    output, parameters = fen.extract_batch(test_image, eyes, n_threads=n_threads)
+    assert output.shape == (3, 40, 40)
+    assert parameters.shape == (3, 4)
+
+    output_mask = numpy.ndarray((3, 40, 40), numpy.bool)
+    masked, _ = fen.extract_batch(test_image, eyes, numpy.ndarray((3, 40, 40), numpy.uint8), test_mask, output_mask, n_threads)
+
+    for k, e in enumerate(eyes):
+      processed = fen(test_image, tuple(e[:2]), tuple(e[2:]))
+      assert (output[k] == processed).all()
+      assert numpy.allclose(parameters[k], (fen.last_angle, fen.last_scale) + tuple(fen.last_offset))
+
+      processed = numpy.ndarray((40, 40), numpy.uint8)
+      processed_mask = numpy.ndarray((40, 40), numpy.bool)
+      fen(test_image, test_mask, processed, processed_mask, tuple(e[:2]), tuple(e[2:]))
+      assert (masked[k] == processed).all()
+      assert (output_mask[k] == processed_mask).all()
@@ -422,6 +422,70 @@ def test_shape():
   sh = lbp.lbp_shape(image)
   nose.tools.eq_(sh, (3,3))
 
+def test_row_wise():
+  # rectangular LBP images are computed row-wise; check that the codes are identical to the ones extracted at single positions
+  random = numpy.random.RandomState(42)
+  images = [
+    random.randint(0, 4, (13, 17)).astype(numpy.uint8),
+    random.randint(0, 1000, (13, 17)).astype(numpy.uint16),
+    random.randint(0, 4, (13, 17)).astype(numpy.float64),
+    random.rand(13, 17)
+  ]
+  for neighbors in (4, 8):
+    for radii in ((1., 1.), (2., 2.), (2., 1.), (1., 3.)):
+      for uniform, rotation_invariant in ((False, False), (True, False), (False, True), (True, True)):
+        lbp = bob.ip.base.LBP(neighbors, radii[0], radii[1], uniform=uniform, rotation_invariant=rotation_invariant)
+        for image in images:
+          codes = lbp(image)
+          nose.tools.eq_(codes.shape, lbp.lbp_shape(image))
+          for y in range(codes.shape[0]):
+            for x in range(codes.shape[1]):
+              nose.tools.eq_(codes[y,x], lbp(image, (y + lbp.offset[0], x + lbp.offset[1])))
+
+def test_specialized_kernels():
+  # the kernels specialized for the number of neighbors and the LBP type need to give the same codes as the generic extraction at single positions
+  random = numpy.random.RandomState(42)
+  images = [
+    random.randint(0, 4, (11, 13)).astype(numpy.uint8),
+    random.randint(0, 1000, (11, 13)).astype(numpy.uint16),
+    random.randint(0, 4, (11, 13)).astype(numpy.float32),
+    random.rand(11, 13)
+  ]
+  configurations = [(4, False), (8, False), (4, True), (8, True), (16, True)]
+  for neighbors, circular in configurations:
+    for elbp_type in ("regular", "transitional", "direction-coded"):
+      lbp = bob.ip.base.LBP(neighbors, 2., 1., circular=circular, elbp_type=elbp_type, uniform=neighbors != 16 and elbp_type == "regular")
+      for image in images:
+        codes = lbp(image)
+        nose.tools.eq_(codes.shape, lbp.lbp_shape(image))
+        for y in range(codes.shape[0]):
+          for x in range(codes.shape[1]):
+            nose.tools.eq_(codes[y,x], lbp(image, (y + lbp.offset[0], x + lbp.offset[1])))
+
+def test_threads():
+  # the rows of the LBP image can be computed in several threads
+  image = numpy.random.RandomState(42).randint(0, 256, (57, 43)).astype(numpy.uint8)
+  for lbp in (bob.ip.base.LBP(8), bob.ip.base.LBP(8, 2., circular=True, uniform=True), bob.ip.base.LBP(4, (3,2)), bob.ip.base.LBP(8, to_average=True, border_handling='wrap')):
+    reference = lbp(image)
+    for n_threads in (2, 7, 0, 1000):
+      assert (lbp(image, n_threads=n_threads) == reference).all()
+      output = numpy.ndarray(reference.shape, numpy.uint16)
+      lbp.extract(image, output, False, n_threads=n_threads)
+      assert (output == reference).all()
+
+def test_circular_taps():
+  # circular and elliptical LBP's interpolate with pre-computed taps; shrinking and wrapping borders give the same codes inside the image
+  image = numpy.random.RandomState(42).randint(0, 256, (37, 41)).astype(numpy.uint8)
+  for P, radii in ((4, (1.,1.)), (8, (2.,2.)), (8, (1.5,3.)), (16, (2.,1.))):
+    shrink = bob.ip.base.LBP(P, radii[0], radii[1], circular=True)
+    wrap = bob.ip.base.LBP(P, radii[0], radii[1], circular=True, border_handling='wrap')
+    codes = shrink(image)
+    offset = shrink.offset
+    assert (codes == wrap(image)[offset[0]:offset[0]+codes.shape[0], offset[1]:offset[1]+codes.shape[1]]).all()
+    for y,x in ((0,0), (codes.shape[0]-1, codes.shape[1]-1), (3,5)):
+      nose.tools.eq_(codes[y,x], shrink(image, (y + offset[0], x + offset[1])))
+    assert (shrink(image.astype(numpy.float64)) == codes).all()
+
 def test_u2_16p1r():
   op = bob.ip.base.LBP(16, 1, True, False, False, True, False)
   values = [207, 24, 40, 36, 167, 230, 71, 247, 107, 9, 32, 139, 244, 233, 216, 232, 244, 123, 202, 238, 161, 246, 204, 244, 173]
@@ -666,6 +730,120 @@ def test_omb_lbp():
   nose.tools.eq_(op(ii, True)[0,0], 0x0a)
 
 
+def test_mb_lbp_integer():
+  # Tests that multi-block LBP's compare the block sums of integer images exactly
+  image = numpy.full((60, 60), 60000, dtype=numpy.uint16)
+  image[5,5] = 59999
+  op = bob.ip.base.LBP(8, (20,20))
+  nose.tools.eq_(op(image)[0,0], 0x7f)
+  nose.tools.eq_(op(image, (op.offset[0], op.offset[1])), 0x7f)
+  nose.tools.eq_(op(bob.ip.base.PreparedImage(image))[0,0], 0x7f)
+  # block sums of floating point images are compared with a relative precision
+  nose.tools.eq_(op(image.astype(numpy.float64))[0,0], 0xff)
+
+  # the results of whole-image extraction and extraction at single positions are identical
+  image = numpy.random.RandomState(42).randint(0, 256, (23, 19)).astype(numpy.uint8)
+  for op in (bob.ip.base.LBP(8, (2,3)), bob.ip.base.LBP(4, (3,3), (1,1), elbp_type="transitional"), bob.ip.base.LBP(8, (1,2), elbp_type="direction-coded"), bob.ip.base.LBP(8, (2,2), to_average=True, add_average_bit=True)):
+    codes = op(image)
+    assert (codes == op(image.astype(numpy.float64))).all()
+    for y in range(codes.shape[0]):
+      for x in range(codes.shape[1]):
+        nose.tools.eq_(codes[y,x], op(image, (y + op.offset[0], x + op.offset[1])))
+
+
+def test_multi_scale_lbp():
+  # Tests that the multi-scale extractor gives the codes of the single multi-block LBP's
+  image = numpy.random.RandomState(42).randint(0, 256, (47, 39)).astype(numpy.uint8)
+  block_sizes = [(s,s) for s in range(1,10)]
+  extractor = bob.ip.base.MultiScaleLBP(8, block_sizes, uniform=True)
+  nose.tools.eq_(len(extractor.lbps), 9)
+  nose.tools.eq_(extractor.lbps[3].block_size, (4,4))
+  # the offset is defined by the largest block
+  nose.tools.eq_(extractor.offset, extractor.lbps[-1].offset)
+  nose.tools.eq_(extractor.lbp_shape(image), (9,) + extractor.lbps[-1].lbp_shape(image))
+
+  stack = extractor(image)
+  nose.tools.eq_(stack.shape, extractor.lbp_shape(image))
+  offset = extractor.offset
+  for s, lbp in enumerate(extractor.lbps):
+    codes = lbp(image)
+    shift = (offset[0] - lbp.offset[0], offset[1] - lbp.offset[1])
+    assert (stack[s] == codes[shift[0]:shift[0]+stack.shape[1], shift[1]:shift[1]+stack.shape[2]]).all()
+
+  # other ways to call the extraction give the same codes
+  assert (extractor(image, n_threads=4) == stack).all()
+  assert (extractor(image.astype(numpy.float64)) == stack).all()
+  assert (extractor(image.astype(numpy.float32)) == stack).all()
+  assert (extractor(bob.ip.base.PreparedImage(image), n_threads=0) == stack).all()
+  ii = numpy.ndarray((48, 40), numpy.uint32)
+  bob.ip.base.integral(image, ii, add_zero_border=True)
+  nose.tools.eq_(extractor.lbp_shape(ii, True), stack.shape)
+  output = numpy.ndarray(stack.shape, numpy.uint16)
+  extractor.extract(ii, output, True)
+  assert (output == stack).all()
+
+  # overlapping blocks and LBP objects
+  lbps = [bob.ip.base.LBP(4, (3,3), (1,1)), bob.ip.base.LBP(4, (2,5))]
+  extractor = bob.ip.base.MultiScaleLBP(lbps)
+  stack = extractor(image)
+  offset = extractor.offset
+  for s, lbp in enumerate(lbps):
+    codes = lbp(image)
+    shift = (offset[0] - lbp.offset[0], offset[1] - lbp.offset[1])
+    assert (stack[s] == codes[shift[0]:shift[0]+stack.shape[1], shift[1]:shift[1]+stack.shape[2]]).all()
+  nose.tools.assert_raises(RuntimeError, bob.ip.base.MultiScaleLBP, [bob.ip.base.LBP(8)])
+
+  # the extractor copies the LBP's, so that modifying them afterwards has no effect
+  lbps[0].block_size = (5,5)
+  extractor.lbps[1].block_size = (5,5)
+  nose.tools.eq_(extractor.lbps[0].block_size, (3,3))
+  nose.tools.eq_(extractor.lbps[1].block_size, (2,5))
+  nose.tools.eq_(extractor.offset, offset)
+  assert (extractor(image) == stack).all()
+
+
+def test_prepared_image():
+  # Tests that prepared images give the same results as the raw images
+  image = numpy.random.RandomState(42).randint(0, 256, (31, 27)).astype(numpy.uint8)
+  prepared = bob.ip.base.PreparedImage(image)
+  nose.tools.eq_(prepared.shape, image.shape)
+  assert prepared.is_integer_image
+  assert (prepared.source == image).all()
+
+  for lbp in (bob.ip.base.LBP(8, (2,1)), bob.ip.base.LBP(8, (3,3), (2,1), uniform=True), bob.ip.base.LBP(8), bob.ip.base.LBP(8, 2., circular=True)):
+    reference = lbp(image)
+    nose.tools.eq_(lbp.lbp_shape(prepared.shape), reference.shape)
+    assert (lbp(prepared) == reference).all()
+    assert (lbp(prepared, n_threads=3) == reference).all()
+    output = numpy.ndarray(reference.shape, numpy.uint16)
+    lbp.extract(prepared, output)
+    assert (output == reference).all()
+    for y,x in ((0,0), (reference.shape[0]-1, reference.shape[1]-1), (5,7)):
+      nose.tools.eq_(lbp(prepared, (y + lbp.offset[0], x + lbp.offset[1])), reference[y,x])
+    # prepared images are not integral images
+    nose.tools.assert_raises(TypeError, lbp.extract, prepared, True)
+
+  # the integral images are shared
+  ii = numpy.ndarray((32, 28), numpy.float64)
+  bob.ip.base.integral(image, ii, add_zero_border=True)
+  assert (prepared.integral() == ii).all()
+  assert (prepared.integer_integral() == ii).all()
+  bob.ip.base.integral(image.astype(numpy.float64)**2, ii, add_zero_border=True)
+  assert numpy.allclose(prepared.squared_integral(), ii)
+
+  # box statistics
+  box = image[3:14, 5:9]
+  nose.tools.eq_(prepared.box_sum((3,5), (11,4)), box.sum())
+  assert abs(prepared.box_mean((3,5), (11,4)) - box.mean()) < 1e-8
+  assert abs(prepared.box_variance((3,5), (11,4)) - box.var()) < 1e-6
+  nose.tools.assert_raises(RuntimeError, prepared.box_sum, (30,5), (2,2))
+
+  # floating point images have no integer integral image
+  prepared = bob.ip.base.PreparedImage(image.astype(numpy.float64))
+  assert not prepared.is_integer_image
+  nose.tools.assert_raises(RuntimeError, prepared.integer_integral)
+
+
 def test_io():
 
   raise SkipTest("TODO: Not fully implemented yet")
@@ -804,3 +982,229 @@ def test_lbphs():
   result = bob.ip.base.lbphs(src, lbp, block_size = (5,5), block_overlap=(0,0))
 
   assert numpy.allclose(result, lbphs)
+
+def test_lbp_feature_set():
+  # Tests that the feature set evaluates the same codes as the single LBP extractors
+  image = numpy.random.RandomState(42).randint(0, 256, (40, 50)).astype(numpy.uint8)
+  lbps = [bob.ip.base.LBP(8), bob.ip.base.LBP(8, 2., circular=True, uniform=True), bob.ip.base.LBP(4, (3,3)), bob.ip.base.LBP(8, (2,4), (1,1))]
+  features = [(lbps[0], (1,1)), (lbps[1], (5,3)), (lbps[2], (10,12)), (lbps[0], (18,18)), (lbps[3], (4,9)), (lbps[2], (15,4))]
+  feature_set = bob.ip.base.LBPFeatureSet([l for l,_ in features], [p for _,p in features])
+  nose.tools.eq_(len(feature_set), 6)
+  nose.tools.eq_(feature_set.positions[2], (10,12))
+  nose.tools.eq_(feature_set.lbps[4].block_size, (2,4))
+
+  windows = numpy.array([(y,x) for y in range(0, 21, 3) for x in range(0, 31, 5)])
+  codes = feature_set(image, windows)
+  nose.tools.eq_(codes.shape, (len(windows), 6))
+  nose.tools.eq_(codes.dtype, numpy.uint16)
+  for w, (oy, ox) in enumerate(windows):
+    for f, (lbp, (y, x)) in enumerate(features):
+      nose.tools.eq_(codes[w,f], lbp.extract(image, (oy+y, ox+x)))
+
+  # other ways to call the evaluation give the same codes
+  assert (feature_set(image, windows.astype(numpy.int32), n_threads=4) == codes).all()
+  assert (feature_set(image.astype(numpy.float64), windows) == codes).all()
+  assert (feature_set(image.astype(numpy.float32), windows) == codes).all()
+  assert (feature_set(bob.ip.base.PreparedImage(image), windows, n_threads=0) == codes).all()
+  output = numpy.ndarray(codes.shape, numpy.uint16)
+  feature_set.extract(image, windows, output)
+  assert (output == codes).all()
+
+  # windows, for which a feature lies outside the image, are rejected
+  nose.tools.assert_raises(RuntimeError, feature_set, image, numpy.array([(0,0), (22,0)]))
+  nose.tools.assert_raises(RuntimeError, feature_set, image, numpy.array([(0,-1)]))
+  nose.tools.assert_raises(ValueError, feature_set, image, numpy.array([(0, 2**32)], numpy.int64))
+  nose.tools.assert_raises(RuntimeError, feature_set, image, numpy.array([(2**31-1, 0), (0, 2**31-1)], numpy.int32))
+  nose.tools.assert_raises(RuntimeError, bob.ip.base.LBPFeatureSet, lbps, [(0,0)])
+
+def test_lbphs_blocks():
+  # Tests that the histograms of (overlapping) blocks are identical to the histograms of the blocks of the LBP image
+  image = numpy.random.RandomState(42).randint(0, 256, (43, 37)).astype(numpy.uint8)
+  for lbp in (bob.ip.base.LBP(8), bob.ip.base.LBP(8, 2., circular=True, uniform=True), bob.ip.base.LBP(4, (3,2)), bob.ip.base.LBP(8, to_average=True, border_handling='wrap')):
+    codes = lbp(image)
+    for block_size, block_overlap in (((5,5), (0,0)), ((8,6), (3,2)), ((7,7), (6,6)), (codes.shape, (0,0))):
+      result = bob.ip.base.lbphs(image, lbp, block_size, block_overlap)
+      nose.tools.eq_(result.shape, bob.ip.base.lbphs_output_shape(image, lbp, block_size, block_overlap))
+      blocks = bob.ip.base.block(codes, block_size, block_overlap, flat=True)
+      nose.tools.eq_(result.shape[0], blocks.shape[0])
+      for b in range(blocks.shape[0]):
+        assert (result[b] == numpy.bincount(blocks[b].flatten(), minlength=lbp.max_label)).all()
+      assert (bob.ip.base.lbphs(image.astype(numpy.float64), lbp, block_size, block_overlap) == result).all()
+      # sliding the histograms along the rows of blocks gives the same result
+      output = numpy.ones(result.shape, numpy.uint64)
+      bob.ip.base.lbphs(image, lbp, block_size, block_overlap, output, sliding_window=True)
+      assert (output == result).all()
+
+def test_lbp_top_planes():
+  # Tests that the LBP-TOP planes are identical to the LBP codes of the XY frames, XT slices and YT slices
+  video = numpy.random.RandomState(42).randint(0, 256, (9, 15, 13)).astype(numpy.uint8)
+  for lbp_xy, lbp_xt, lbp_yt in (
+      (bob.ip.base.LBP(8, 2., 1.), bob.ip.base.LBP(8, 2., 1.), bob.ip.base.LBP(8, 2., 2.)),
+      (bob.ip.base.LBP(8, 1., circular=True), bob.ip.base.LBP(4, 1.), bob.ip.base.LBP(8, 1., to_average=True)),
+      (bob.ip.base.LBP(4, 1., border_handling='wrap'), bob.ip.base.LBP(8, 1., uniform=True), bob.ip.base.LBP(8, 1., border_handling='wrap'))
+  ):
+    op = bob.ip.base.LBPTop(lbp_xy, lbp_xt, lbp_yt)
+    m = int(max(max(lbp_xy.radii), lbp_yt.radii[0]))
+    shape = (video.shape[0]-2*m, video.shape[1]-2*m, video.shape[2]-2*m)
+    xy, xt, yt = (numpy.ndarray(shape, numpy.uint16) for i in range(3))
+    op(video, xy, xt, yt)
+    for t in range(m, video.shape[0]-m):
+      for y in range(m, video.shape[1]-m):
+        for x in range(m, video.shape[2]-m):
+          nose.tools.eq_(xy[t-m, y-m, x-m], lbp_xy.extract(video[t], (y, x)))
+          nose.tools.eq_(xt[t-m, y-m, x-m], lbp_xt.extract(video[:,y,:], (t, x)))
+          nose.tools.eq_(yt[t-m, y-m, x-m], lbp_yt.extract(video[:,:,x], (t, y)))
+
+    # the planes can be processed in parallel
+    xy2, xt2, yt2 = (numpy.ndarray(shape, numpy.uint16) for i in range(3))
+    op.process(video.astype(numpy.float64), xy2, xt2, yt2, n_threads=4)
+    assert (xy2 == xy).all() and (xt2 == xt).all() and (yt2 == yt).all()
+
+def test_lbp_top_stream():
+  # Tests that the streamed LBP-TOP codes are identical to the codes of the whole video
+  video = numpy.random.RandomState(42).randint(0, 256, (10, 15, 13)).astype(numpy.uint8)
+  op = bob.ip.base.LBPTop(bob.ip.base.LBP(8, 2., 1.), bob.ip.base.LBP(8, 2., 1.), bob.ip.base.LBP(8, 2., 2.))
+  m = 2
+  shape = (video.shape[0]-2*m, video.shape[1]-2*m, video.shape[2]-2*m)
+  xy, xt, yt = (numpy.ndarray(shape, numpy.uint16) for i in range(3))
+  op(video, xy, xt, yt)
+
+  stream = bob.ip.base.LBPTopStream(op, video.shape[1:])
+  nose.tools.eq_(stream.temporal_radius, 2)
+  nose.tools.eq_(stream.frame_shape, (15, 13))
+  nose.tools.eq_(stream.output_shape, shape[1:])
+  block_size, block_overlap = (5,4), (2,1)
+  nose.tools.eq_(stream.histogram_shape(block_size, block_overlap), (bob.ip.base.block_output_shape(xy[0], block_size, block_overlap, flat=True)[0], 3*256))
+  for t in range(video.shape[0]):
+    codes = stream.push(video[t], n_threads=2)
+    nose.tools.eq_(stream.number_of_frames, t+1)
+    if t < 4:
+      assert codes is None
+      assert not stream.is_ready
+      continue
+    # the codes belong to the frame that was pushed two frames ago; the first and last frames are not extracted by process
+    if m <= t-2 < video.shape[0]-m:
+      assert (codes[0] == xy[t-2-m]).all()
+      assert (codes[1] == xt[t-2-m]).all()
+      assert (codes[2] == yt[t-2-m]).all()
+
+  # histograms of the blocks of the central frame
+  stream.reset()
+  nose.tools.eq_(stream.number_of_frames, 0)
+  for t in range(5):
+    histograms = stream.push_histograms(video[t].astype(numpy.float64), block_size, block_overlap)
+  blocks = [bob.ip.base.block(codes, block_size, block_overlap, flat=True) for codes in (xy[0], xt[0], yt[0])]
+  nose.tools.eq_(histograms.shape, stream.histogram_shape(block_size, block_overlap))
+  for b in range(histograms.shape[0]):
+    reference = numpy.concatenate([numpy.bincount(blocks[p][b].flatten(), minlength=256) for p in range(3)])
+    assert (histograms[b] == reference).all()
+
+  nose.tools.assert_raises(RuntimeError, stream.push, video[0,:10])
+
+def test_lbp_top_histograms():
+  # Tests that the LBP-TOP block histograms are identical to the histograms of the blocks of the code volumes
+  video = numpy.random.RandomState(42).randint(0, 256, (11, 14, 13)).astype(numpy.uint8)
+  op = bob.ip.base.LBPTop(bob.ip.base.LBP(8, 1.), bob.ip.base.LBP(4, 1.), bob.ip.base.LBP(8, 1., uniform=True))
+  shape = (9, 12, 11)
+  volumes = [numpy.ndarray(shape, numpy.uint16) for i in range(3)]
+  op(video, *volumes)
+  offsets = numpy.cumsum([0, 256, 16])
+  for block_size, block_overlap in (((3,4,5), (0,0,0)), ((4,5,3), (2,1,2)), (shape, (0,0,0))):
+    histograms = op.process_histograms(video, block_size, block_overlap)
+    nose.tools.eq_(histograms.shape, op.histogram_shape(video, block_size, block_overlap))
+    nose.tools.eq_(histograms.shape, op.histogram_shape(video.shape, block_size, block_overlap))
+    b = 0
+    steps = [s-o for s, o in zip(block_size, block_overlap)]
+    for t in range(0, shape[0] - block_size[0] + 1, steps[0]):
+      for y in range(0, shape[1] - block_size[1] + 1, steps[1]):
+        for x in range(0, shape[2] - block_size[2] + 1, steps[2]):
+          reference = numpy.zeros(histograms.shape[1], numpy.uint64)
+          for p, codes in enumerate(volumes):
+            block = codes[t:t+block_size[0], y:y+block_size[1], x:x+block_size[2]]
+            numpy.add.at(reference, offsets[p] + block.flatten().astype(numpy.int64), 1)
+          assert (histograms[b] == reference).all()
+          b += 1
+    nose.tools.eq_(b, histograms.shape[0])
+    assert (op.process_histograms(video.astype(numpy.float64), block_size, block_overlap, n_threads=3) == histograms).all()
+
+  nose.tools.assert_raises(RuntimeError, op.process_histograms, video, (10,4,4))
+
+def test_histogram_scorer():
+  # Tests that the histogram scores of all templates are identical to the scores computed in numpy
+  random = numpy.random.RandomState(42)
+  lbp = bob.ip.base.LBP(8, uniform=True)
+  images = random.randint(0, 256, (20, 24, 21)).astype(numpy.uint8)
+  templates = numpy.array([bob.ip.base.lbphs(image, lbp, (8,7), (4,3)) for image in images])
+  probe = bob.ip.base.lbphs(random.randint(0, 256, (24, 21)).astype(numpy.uint8), lbp, (8,7), (4,3))
+  weights = random.rand(templates.shape[1])
+
+  def chi_square(p, t):
+    p, t = p.astype(numpy.float64), t.astype(numpy.float64)
+    s = p + t
+    return numpy.sum(numpy.where(s > 0, (p - t)**2 / numpy.where(s > 0, s, 1), 0), axis=1)
+  def intersection(p, t):
+    return numpy.sum(numpy.minimum(p, t).astype(numpy.float64), axis=1)
+
+  for compact in (True, False):
+    scorer = bob.ip.base.HistogramScorer(probe.shape, compact=compact)
+    nose.tools.eq_(scorer.histogram_shape, probe.shape)
+    nose.tools.eq_(scorer.measure, 'chi_square')
+    nose.tools.eq_(scorer.compact, compact)
+    assert scorer.weights is None
+    scorer.enroll(templates[:5])
+    for template in templates[5:]:
+      scorer.enroll(template)
+    nose.tools.eq_(len(scorer), len(templates))
+
+    for measure, function in (('chi_square', chi_square), ('intersection', intersection)):
+      scorer.measure = measure
+      reference = numpy.array([numpy.sum(function(probe, t)) for t in templates])
+      scores = scorer.score(probe)
+      assert numpy.allclose(scores, reference, rtol=1e-5)
+      assert numpy.allclose(scorer(probe.astype(numpy.float64), n_threads=4), reference, rtol=1e-5)
+
+      # weighted block scores
+      scorer.weights = weights
+      weighted = numpy.array([numpy.sum(weights * function(probe, t)) for t in templates])
+      output = numpy.ndarray((len(templates),), numpy.float64)
+      scorer.score(probe, output, n_threads=3)
+      assert numpy.allclose(output, weighted, rtol=1e-5)
+
+      # the best templates are sorted from best to worst
+      indices, best = scorer.best(probe, 5, n_threads=2)
+      order = numpy.argsort(weighted if measure == 'chi_square' else -weighted, kind='mergesort')
+      assert (indices == order[:5]).all()
+      assert numpy.allclose(best, weighted[order[:5]], rtol=1e-5)
+      scorer.weights = None
+
+  # normalized histograms cannot be stored as counts, but as floats
+  normalized = templates / templates.sum(axis=2, keepdims=True).astype(numpy.float64)
+  normalized_probe = probe / probe.sum(axis=1, keepdims=True).astype(numpy.float64)
+  scorer = bob.ip.base.HistogramScorer(probe.shape)
+  nose.tools.assert_raises(RuntimeError, scorer.enroll, normalized_probe)
+  nose.tools.assert_raises(RuntimeError, scorer.enroll, normalized)
+  nose.tools.assert_raises(RuntimeError, scorer.enroll, -templates[0].astype(numpy.float64))
+  nose.tools.assert_raises(RuntimeError, scorer.enroll, probe[1:])
+  nose.tools.eq_(len(scorer), 0)
+  scorer = bob.ip.base.HistogramScorer(probe.shape, compact=False)
+  scorer.enroll(normalized)
+  for measure, function in (('chi_square', chi_square), ('intersection', intersection)):
+    scorer.measure = measure
+    reference = numpy.array([numpy.sum(function(normalized_probe, t)) for t in normalized])
+    assert numpy.allclose(scorer(normalized_probe), reference, rtol=1e-5)
+
+  # non-finite values are rejected
+  invalid = normalized_probe.copy()
+  invalid[0,0] = numpy.nan
+  nose.tools.assert_raises(RuntimeError, scorer.enroll, invalid)
+  nose.tools.assert_raises(RuntimeError, scorer.score, invalid)
+  nose.tools.assert_raises(RuntimeError, scorer.best, invalid, 1)
+  invalid[0,0] = numpy.inf
+  nose.tools.assert_raises(RuntimeError, scorer.enroll, invalid)
+  nose.tools.eq_(len(scorer), len(templates))
+
+  scorer = bob.ip.base.HistogramScorer(probe.shape)
+  nose.tools.assert_raises(RuntimeError, scorer.best, probe, 1)
+  scorer.enroll(templates)
+  scorer.clear()
+  nose.tools.eq_(len(scorer), 0)
@@ -18,7 +18,7 @@ version = open("version.txt").read().rstrip()
 
 import os
 packages = ['boost']
-boost_modules = ['system']
+boost_modules = ['system', 'thread']
 
 class vl:
 
@@ -116,9 +116,15 @@ setup(
         [
           "bob/ip/base/cpp/GeomNorm.cpp",
           "bob/ip/base/cpp/FaceEyesNorm.cpp",
+          "bob/ip/base/cpp/Remap.cpp",
+          "bob/ip/base/cpp/PreparedImage.cpp",
           "bob/ip/base/cpp/Affine.cpp",
           "bob/ip/base/cpp/LBP.cpp",
+          "bob/ip/base/cpp/MultiScaleLBP.cpp",
+          "bob/ip/base/cpp/LBPFeatureSet.cpp",
           "bob/ip/base/cpp/LBPTop.cpp",
+          "bob/ip/base/cpp/LBPTopStream.cpp",
+          "bob/ip/base/cpp/HistogramScorer.cpp",
           "bob/ip/base/cpp/DCTFeatures.cpp",
           "bob/ip/base/cpp/TanTriggs.cpp",
           "bob/ip/base/cpp/Gaussian.cpp",
@@ -146,9 +152,15 @@ setup(
           "bob/ip/base/auxiliary.cpp",
           "bob/ip/base/geom_norm.cpp",
           "bob/ip/base/face_eyes_norm.cpp",
+          "bob/ip/base/remap.cpp",
+          "bob/ip/base/prepared_image.cpp",
           "bob/ip/base/affine.cpp",
           "bob/ip/base/lbp.cpp",
+          "bob/ip/base/multi_scale_lbp.cpp",
+          "bob/ip/base/lbp_feature_set.cpp",
           "bob/ip/base/lbp_top.cpp",
+          "bob/ip/base/lbp_top_stream.cpp",
+          "bob/ip/base/histogram_scorer.cpp",
           "bob/ip/base/dct_features.cpp",
           "bob/ip/base/tan_triggs.cpp",
           "bob/ip/base/gaussian.cpp",